@@ -1,11 +1,18 @@
 #include "assembler.h"
-#include "eeprom.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThreadPool>
+#include <cstring>
 
 using namespace Assembly;
 
 Assembler* Assembler::m_singleton = nullptr;
 
-Assembler* Assembler::getInstance(Console *consoleOutput)
+Assembler* Assembler::getInstance(LogOutput *consoleOutput)
 {
     if (m_singleton == nullptr)
         m_singleton = new Assembler(consoleOutput);
@@ -13,10 +20,18 @@ Assembler* Assembler::getInstance(Console *consoleOutput)
     return m_singleton;
 }
 
-Assembler::Assembler(Console *consoleOutput)
+Assembler::Assembler(LogOutput *consoleOutput)
 {
     m_consoleOutput = consoleOutput;
     m_binaryReady = false;
+    m_threadsNb = 0;
+    m_placementPolicy = PlacementPolicy::FIRST_FIT;
+
+    m_error.originFilePath = "";
+    m_error.originLineNb = 0;
+    m_error.originColumnNb = 0;
+    m_error.type = Token::ErrorType::NONE;
+    m_error.additionalInfo = "";
 }
 
 bool Assembler::isBinaryReady()
@@ -36,7 +51,7 @@ BinaryWithSymbols Assembler::getBinaryDataWithSymbols()
 
 ByteDebugSymbol Assembler::getSymbolFromAddress(Word address)
 {
-    return m_finalBinary.origin[address];
+    return m_finalBinary.lines.findSymbol(address);
 }
 
 bool Assembler::isAssembledForEeprom()
@@ -48,34 +63,54 @@ std::vector<Word> Assembler::getBreakpointsAddresses(std::vector<std::pair<QStri
 {
     std::vector<Word> breakpoints;
 
-    QString fileWithBreakpointsPath;
-    int comparedLine;
+    uint32_t address;
+
     for (unsigned int i(0); i < filesBreakpoints.size(); i++)
     {
-        fileWithBreakpointsPath = filesBreakpoints[i].first;
-
         for (unsigned int j(0); j < filesBreakpoints[i].second.size(); j++)
         {
-            comparedLine = filesBreakpoints[i].second[j];
-
-            for (unsigned int t(Cpu::PROGRAM_START_ADDRESS); t < m_finalBinary.origin.size(); t += 4) // Only the first byte has an associated origin
-            {
-                if (m_finalBinary.origin[t].filePath == fileWithBreakpointsPath && m_finalBinary.origin[t].lineNb == comparedLine)
-                {
-                    breakpoints.push_back(t);
-                    break;
-                }
-            }
+            if (m_finalBinary.lines.findAddress(filesBreakpoints[i].first, filesBreakpoints[i].second[j], address))
+                breakpoints.push_back(address);
         }
     }
 
     return breakpoints;
 }
 
-bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
+ObjectFile Assembler::getObject()
+{
+    return m_object;
+}
+
+Error Assembler::getLastError()
+{
+    return m_error;
+}
+
+void Assembler::setThreadsNb(unsigned int threadsNb)
+{
+    m_threadsNb = threadsNb;
+}
+
+void Assembler::setPlacementPolicy(PlacementPolicy policy)
+{
+    m_placementPolicy = policy;
+}
+
+bool Assembler::assembleProject(const Sources &sources, bool targetEeprom, bool incremental)
+{
+    if (!assembleObject(sources, targetEeprom, incremental))
+        return false;
+
+    return linkObjects({ &m_object }, targetEeprom);
+}
+
+bool Assembler::assembleObject(const Sources &sources, bool targetEeprom, bool incremental)
 {
-    m_consoleOutput->clear();
-    m_consoleOutput->log("Assembling project \"" + p->getName() + "\"...");
+    m_binaryReady = false;
+
+    m_consoleOutput->clearLog();
+    m_consoleOutput->log("Assembling project \"" + sources.name.toStdString() + "\"...");
     m_consoleOutput->returnLine();
 
 
@@ -89,33 +124,58 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
 
     m_includedFiles.clear();
     m_defToProcess.clear();
+    m_macros.clear();
     m_definedVars.clear();
     m_undefinedVars.clear();
-    m_freeMemorySpaces.clear();
     m_routineBlocks.clear();
+    m_symbols.clear();
 
     m_error.originFilePath = "";
     m_error.originLineNb = 0;
+    m_error.originColumnNb = 0;
     m_error.type = Token::ErrorType::NONE;
     m_error.additionalInfo = "";
 
     m_finalFile.m_lines.clear();
     m_tokenFiles.clear();
-
-    initBinary(targetEeprom);
+    m_object.clear();
 
 
 // === INIT ===
     // List all files in the project
-    m_filesPaths = p->getFilesPaths();
+    m_filesPaths = sources.filesPaths;
+
+    if (incremental)
+        loadCache(QFileInfo(sources.path).path());
+
+    // Files are assembled independently until the includes, each one on a thread of the pool
+    std::vector<FileAssembly> files(m_filesPaths.count());
+    std::vector<qint64> filesWeights;
+    unsigned int reusedFilesNb(0);
+    bool cacheChanged(false);
 
-    // Retrieve their content
     for (int i(0); i < m_filesPaths.count(); i++)
     {
-        m_tokenFiles.push_back(retrieveContent(m_filesPaths[i]));
+        files[i].filePath = m_filesPaths[i];
+        filesWeights.push_back(QFileInfo(m_filesPaths[i]).size());
+    }
+
+    m_tokenFiles.resize(files.size());
 
-        if (m_error.type == Token::ErrorType::FILE_NOT_READ)
+    // Retrieve their content, then converts it as tokens and extracts the ".define" and ".macro" macros
+    runOnFiles([&](unsigned int i) { prepareFile(files[i], m_tokenFiles[i], incremental); }, filesWeights);
+
+    // Errors are reported in the order of a serial assembly: reading, then tokens, then defines
+    for (unsigned int i(0); i < files.size(); i++)
+    {
+        if (files[i].failedStage == FileAssembly::Stage::READ)
         {
+            m_error.originFilePath = "";
+            m_error.originLineNb = 0;
+            m_error.type = Token::ErrorType::FILE_NOT_READ;
+            m_error.additionalInfo = "";
+            logError();
+
             m_consoleOutput->log("Assembly failed");
             m_consoleOutput->returnLine();
             return false;
@@ -128,41 +188,58 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
 
     m_totalTokenCount = 0;
 
-    for (unsigned int i(0); i < m_tokenFiles.size(); i++)
+    for (unsigned int i(0); i < files.size(); i++)
     {
-// -> Minor pass 1: Replace tabs by 4 spaces
-        replaceTabsBySpaces(m_tokenFiles[i]);
-
-// -> Minor pass 2: Removes comments
-        removeComments(m_tokenFiles[i]);
-
-// -> Minor pass 3: Removes empty lines
-        removeEmptyLines(m_tokenFiles[i]);
-
-// -> Minor pass 4: Removes uneccesary tabs and spaces
-        fixIndentation(m_tokenFiles[i]);
-
-// -> Minor pass 5: Converts the result as general tokens
-        if (!convertToTokens(m_tokenFiles[i]))
+// -> Minor pass 1: Removes comments, empty lines and uneccesary tabs and spaces, then converts the result as general tokens
+        if (files[i].failedStage == FileAssembly::Stage::TOKENS)
         {
+            m_error = files[i].error;
+            logError();
+
             m_consoleOutput->log("Assembly failed");
             m_consoleOutput->returnLine();
             return false;
         }
+
+        m_totalTokenCount += files[i].tokensNb;
+
+        if (files[i].cachedFile != nullptr)
+            reusedFilesNb++;
     }
 
     m_consoleOutput->log(std::to_string(m_totalTokenCount) + " tokens identified");
+
+    if (incremental)
+        m_consoleOutput->log(std::to_string(reusedFilesNb) + " / " + std::to_string(m_tokenFiles.size()) + " file" + ((m_tokenFiles.size() > 1) ? "s" : "") + " unchanged since the last assembly");
+
     m_consoleOutput->returnLine();
 
 
 // === MAJOR PASS 2: Process all preprocessor directives (.include and .define) ===
     m_consoleOutput->log("Processing define macros...");
 
-// -> Minor pass 1: List all ".define" macros
+// -> Minor pass 1: List all ".define" and ".macro" macros
     m_defToProcess.clear();
-    for (unsigned int i(0); i < m_tokenFiles.size(); i++)
+    m_macros.clear();
+    for (unsigned int i(0); i < files.size(); i++)
     {
-        if (!listDefines(m_tokenFiles[i]))
+        if (files[i].failedStage == FileAssembly::Stage::DEFINES_LIST)
+        {
+            m_error = files[i].error;
+            logError();
+
+            m_consoleOutput->log("Assembly failed");
+            m_consoleOutput->returnLine();
+            return false;
+        }
+
+        if (incremental && files[i].cachedFile == nullptr)
+        {
+            storeCachedFile(files[i].filePath, files[i].contentHash, files[i].tokensNb, m_tokenFiles[i], files[i].defines);
+            cacheChanged = true;
+        }
+
+        if (!registerDefines(files[i].defines) || !registerMacros(files[i].macros))
         {
             m_consoleOutput->log("Assembly failed");
             m_consoleOutput->returnLine();
@@ -170,15 +247,37 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
         }
     }
 
-// -> Minor pass 2: Process all ".define" macros
-    if (!processDefines())
+    m_definesCount = (unsigned int)m_defToProcess.size();
+    m_preprocessorKey = getPreprocessorKey();
+
+    if (cacheChanged)
+        saveCache();
+
+// -> Minor pass 2: Expand the macros and process all ".define" macros, then check the validity of the lines
+    filesWeights.clear();
+
+    for (unsigned int i(0); i < files.size(); i++)
+    {
+        filesWeights.push_back(files[i].tokensNb);
+    }
+
+    runOnFiles([&](unsigned int i) { processFile(files[i], m_tokenFiles[i], targetEeprom, incremental); }, filesWeights);
+
+    for (unsigned int i(0); i < files.size(); i++)
     {
-        m_consoleOutput->log("Assembly failed");
-        m_consoleOutput->returnLine();
-        return false;
+        if (files[i].failedStage == FileAssembly::Stage::DEFINES_PROCESS)
+        {
+            m_error = files[i].error;
+            logError();
+
+            m_consoleOutput->log("Assembly failed");
+            m_consoleOutput->returnLine();
+            return false;
+        }
     }
 
     m_consoleOutput->log(std::to_string(m_definesCount) + " define macro" + ((m_definesCount > 1) ? "s" : "") + " found and executed");
+    m_consoleOutput->log(std::to_string(m_macros.size()) + " macro" + ((m_macros.size() > 1) ? "s" : "") + " with parameters found");
     m_consoleOutput->returnLine();
 
 // -> Minor pass 3: Process all ".include" macros, starting in file "main.has"
@@ -194,8 +293,8 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
     m_consoleOutput->log(std::to_string(m_includedFiles.size()) + " file" + ((m_includedFiles.size() > 1) ? "s" : "") + " included");
     m_consoleOutput->returnLine();
 
-    m_finalFile.m_fileName = p->getName();
-    m_finalFile.m_filePath = p->getPath();
+    m_finalFile.m_fileName = sources.name;
+    m_finalFile.m_filePath = sources.path;
 
 
 // /!\ Working with one giant token file from now on /!\
@@ -204,7 +303,7 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
 // === MAJOR PASS 3: Argument validity ===
     m_consoleOutput->log("Checking tokens validity...");
 
-    if (!checkArgumentsValidity(targetEeprom))
+    if (!checkArgumentsValidity())
     {
         m_consoleOutput->log("Assembly failed");
         m_consoleOutput->returnLine();
@@ -250,469 +349,509 @@ bool Assembler::assembleProject(std::shared_ptr<Project> p, bool targetEeprom)
         return false;
     }
 
-// -> Minor pass 2: Calculate routines addresses (in a row)
-    if (!calculateRoutineBlocksAddresses())
-    {
-        m_consoleOutput->log("Assembly failed");
-        m_consoleOutput->returnLine();
-        return false;
-    }
-
     m_consoleOutput->log(std::to_string(m_routineBlocksCount) + " routine block" + ((m_routineBlocksCount > 1) ? "s" : "") + " detected.");
     m_consoleOutput->returnLine();
 
 
-// === MAJOR PASS 6: Data process ===
-    m_consoleOutput->log("Check variable name uses validity...");
+// === MAJOR PASS 6: Object generation ===
+    m_consoleOutput->log("Generating relocatable object...");
 
-// -> Minor pass 1: List free memory spaces between routines and defined .data
-    if (!findFreeMemorySpaces(targetEeprom))
+    if (!generateObject(sources, targetEeprom))
     {
         m_consoleOutput->log("Assembly failed");
         m_consoleOutput->returnLine();
         return false;
     }
 
-// -> Minor pass 2: Calculate undefined data addresses (find first big enough free memory space)
-    if (!calculateVariablesAddresses())
-    {
-        m_consoleOutput->log("Assembly failed");
-        m_consoleOutput->returnLine();
-        return false;
-    }
+    m_consoleOutput->log(std::to_string(m_object.sections.size()) + " section" + ((m_object.sections.size() > 1) ? "s" : "") + ", "
+                         + std::to_string(m_object.imports.size()) + " symbol" + ((m_object.imports.size() > 1) ? "s" : "") + " imported from other objects");
+    m_consoleOutput->returnLine();
 
-// -> Minor pass 2: Replace all vars in tokens with associated addresses
-    if (!replaceVariablesByAddresses())
-    {
-        m_consoleOutput->log("Assembly failed");
-        m_consoleOutput->returnLine();
-        return false;
-    }
+    return true;
+}
 
-    m_consoleOutput->log("All uses of variable names are valid");
-    m_consoleOutput->returnLine();
+bool Assembler::linkObjects(const std::vector<const ObjectFile*> &objects, bool targetEeprom)
+{
+    m_binaryReady = false;
+
+    m_error.originFilePath = "";
+    m_error.originLineNb = 0;
+    m_error.originColumnNb = 0;
+    m_error.type = Token::ErrorType::NONE;
+    m_error.additionalInfo = "";
 
 
-// === MAJOR PASS 7: Conversion of tokens to binary ===
-    m_consoleOutput->log("Writing binary file...");
+// === MAJOR PASS 7: Placement of routine blocks and variables, then conversion to binary ===
+    m_consoleOutput->log("Linking " + std::to_string(objects.size()) + " object" + ((objects.size() > 1) ? "s" : "") + "...");
 
-// -> Minor pass 1: Routine blocks conversion
-    if (!convertTokensToBinary())
+    if (!m_linker.link(objects, targetEeprom, m_placementPolicy, m_finalBinary, m_error))
     {
-        m_consoleOutput->log("Assembly failed");
-        m_consoleOutput->returnLine();
-        return false;
-    }
+        logError();
 
-// -> Minor pass 2: Data integration
-    if (!convertDataToBinary())
-    {
         m_consoleOutput->log("Assembly failed");
         m_consoleOutput->returnLine();
         return false;
     }
 
+    Fragmentation fragmentation(m_linker.getFragmentation());
+    uint32_t memoryUse(m_linker.getMemoryUse());
+
+    m_consoleOutput->log("Free memory: " + std::to_string(fragmentation.freeBytes) + " bytes in " + std::to_string(fragmentation.freeSpacesNb)
+                         + " space" + ((fragmentation.freeSpacesNb > 1) ? "s" : "") + ", largest " + std::to_string(fragmentation.largestFreeSpace)
+                         + " bytes (fragmentation " + std::to_string(fragmentation.percent) + " %)");
+
     m_consoleOutput->log("Assembly terminated successfuly");
-    m_consoleOutput->log("Memory usage: " + std::to_string(m_totalMemoryUse) + " / " + std::to_string(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE) + " bytes (" + std::to_string(m_totalMemoryUse * 100 / (targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE)) + " %)");
+    m_consoleOutput->log("Memory usage: " + std::to_string(memoryUse) + " / " + std::to_string(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE) + " bytes (" + std::to_string((uint64_t)memoryUse * 100 / (targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE)) + " %)");
     m_consoleOutput->returnLine();
 
     m_binaryReady = true;
-    p->setAssembled(true);
 
     return true;
 }
 
-Token::TokenFile Assembler::retrieveContent(QString filePath)
+bool Assembler::readContent(QString filePath, QByteArray &content)
 {
-    Token::TokenFile tFile;
     QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    content = file.readAll();
+
+    return true;
+}
+
+Token::TokenFile Assembler::retrieveContent(QString filePath, const QByteArray &content)
+{
+    Token::TokenFile tFile;
     unsigned int lineNb(1);
     Token::TokenLine tLine;
+    QTextStream in(content); // Reading file line by line
+
+    // File info
+    tFile.m_fileName = QFileInfo(filePath).fileName();
+    tFile.m_filePath = filePath;
 
-    if (file.open(QIODevice::ReadOnly)) // Reading file line by line
+    // File content
+    while (!in.atEnd())
     {
-        QTextStream in(&file);
+        tLine.m_originFilePath = filePath;
+        tLine.m_originLineNb = lineNb;
+        tLine.m_originStr = in.readLine().toStdString();
 
-        // File info
-        tFile.m_fileName = QFileInfo(filePath).fileName();
-        tFile.m_filePath = filePath;
+        tFile.m_lines.push_back(tLine);
 
-        // File content
-        while (!in.atEnd())
-        {
-            tLine.m_originFilePath = filePath;
-            tLine.m_originLineNb = lineNb;
-            tLine.m_originStr = in.readLine().toStdString();
+        lineNb++;
+    }
 
-            tFile.m_lines.push_back(tLine);
+    return tFile;
+}
 
-            lineNb++;
-        }
+void Assembler::prepareFile(FileAssembly &file, Token::TokenFile &tFile, bool incremental)
+{
+    QByteArray content;
+
+    if (!readContent(file.filePath, content))
+    {
+        file.failedStage = FileAssembly::Stage::READ;
+        return;
     }
-    else
+
+    file.contentHash = hash(content.constData(), content.size());
+    file.cachedFile = incremental ? findCachedFile(file.filePath, file.contentHash) : nullptr;
+
+    if (file.cachedFile != nullptr) // Lines copied from the cache once the defines are known
     {
-        m_error.originFilePath = "";
-        m_error.originLineNb = 0;
-        m_error.type = Token::ErrorType::FILE_NOT_READ;
-        m_error.additionalInfo = "";
+        file.tokensNb = file.cachedFile->tokensNb;
+        file.defines = file.cachedFile->defines;
+
+        // The macro definitions are kept in the cached lines
+        if (!Preprocessor::listMacros(file.cachedFile->tokenFile, file.macros, file.preprocessorSites, file.error))
+            file.failedStage = FileAssembly::Stage::DEFINES_LIST;
+
+        return;
     }
 
-    return tFile;
+    tFile = retrieveContent(file.filePath, content);
+
+    if (!tokenizeFile(tFile, file.tokensNb, file.error))
+        file.failedStage = FileAssembly::Stage::TOKENS;
+    else if (!listDefines(tFile, file.defines, file.error) || !Preprocessor::listMacros(tFile, file.macros, file.preprocessorSites, file.error))
+        file.failedStage = FileAssembly::Stage::DEFINES_LIST;
 }
 
-void Assembler::logError()
+void Assembler::processFile(FileAssembly &file, Token::TokenFile &tFile, bool targetEeprom, bool incremental)
 {
-    if (!m_error.originFilePath.isEmpty())
-        m_consoleOutput->log("Error line " + std::to_string(m_error.originLineNb) + " of file "
-                             + QFileInfo(m_error.originFilePath).fileName().toStdString());
+    CachedFile *cachedFile(incremental ? findCachedFile(file.filePath, file.contentHash) : nullptr);
+    quint64 definesKey(0);
 
-    m_consoleOutput->log(Token::errStr[(int)m_error.type] + m_error.additionalInfo);
-    m_consoleOutput->returnLine();
-}
+    if (cachedFile != nullptr)
+    {
+        definesKey = getDefinesKey(*cachedFile);
 
-void Assembler::initBinary(bool targetEeprom)
-{
-    int memorySize(0);
+        // Expansions and conditions can use any define or macro
+        if (!file.preprocessorSites.empty())
+            definesKey = hash(reinterpret_cast<const char*>(&m_preprocessorKey), sizeof(m_preprocessorKey), definesKey);
+
+        // Neither the file nor the defines it uses changed
+        if (cachedFile->processed && cachedFile->definesKey == definesKey && cachedFile->targetEeprom == targetEeprom)
+        {
+            tFile = cachedFile->processedFile;
+            return;
+        }
+
+        if (file.cachedFile != nullptr)
+            tFile = cachedFile->tokenFile;
+    }
+
+    if (!file.preprocessorSites.empty())
+    {
+        // Local labels of the macros are renamed with a tag of the file, which does not depend on the files order
+        QByteArray filePath(file.filePath.toUtf8());
+        std::string tag(QString::number((quint32)hash(filePath.constData(), filePath.size()), 16).toStdString());
+        Preprocessor preprocessor(m_symbols, m_defToProcess, m_macros, tag);
 
-    m_finalBinary.binaryData.clear();
-    m_finalBinary.origin.clear();
+        if (!preprocessor.processFile(tFile, file.preprocessorSites, file.error))
+        {
+            file.failedStage = FileAssembly::Stage::DEFINES_PROCESS;
+            return;
+        }
+    }
 
-    memorySize = (targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE);
+    if (!processDefines(tFile, file.error))
+    {
+        file.failedStage = FileAssembly::Stage::DEFINES_PROCESS;
+        return;
+    }
 
-    quint8 nullChar(0);
-    for (unsigned int i(0); i < memorySize; i++)
+    // Errors are only reported by checkArgumentsValidity(), if the file is included
+    for (unsigned int l(0); l < tFile.m_lines.size(); l++)
     {
-        ByteDebugSymbol newSymbol;
+        if (tFile.m_lines[l].m_tokens[0].getType() != Token::TokenType::INCLUDE)
+            tFile.m_lines[l].checkValidity(targetEeprom);
+    }
 
-        m_finalBinary.binaryData.push_back(nullChar);
-        m_finalBinary.origin.push_back(newSymbol);
+    if (cachedFile != nullptr) // Only this thread uses the entry of the file
+    {
+        cachedFile->processed = true;
+        cachedFile->definesKey = definesKey;
+        cachedFile->targetEeprom = targetEeprom;
+        cachedFile->processedFile = tFile;
     }
 }
 
-// -- Major pass 1 --
-void Assembler::replaceTabsBySpaces(Token::TokenFile &f)
+void Assembler::runOnFiles(const std::function<void(unsigned int)> &job, const std::vector<qint64> &filesWeights)
 {
-    size_t tabPos;
-
-    for (unsigned int i(0); i < f.m_lines.size(); i++)
+    if (filesWeights.size() < 2 || m_threadsNb == 1)
     {
-        tabPos = f.m_lines[i].m_originStr.find('\t');
+        for (unsigned int i(0); i < filesWeights.size(); i++)
+            job(i);
 
-        while (tabPos != std::string::npos)
-        {
-            f.m_lines[i].m_originStr = f.m_lines[i].m_originStr.replace(tabPos, 1, "    ");
+        return;
+    }
 
-            tabPos = f.m_lines[i].m_originStr.find('\t');
-        }
+    // The heaviest files start first, so the pool does not end waiting for one of them
+    std::vector<unsigned int> order(filesWeights.size());
+
+    for (unsigned int i(0); i < order.size(); i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&filesWeights](unsigned int a, unsigned int b) { return filesWeights[a] > filesWeights[b]; });
+
+    QThreadPool pool;
+
+    if (m_threadsNb != 0)
+        pool.setMaxThreadCount(m_threadsNb);
+
+    for (unsigned int i(0); i < order.size(); i++)
+    {
+        unsigned int fileIndex(order[i]);
+        pool.start([&job, fileIndex]() { job(fileIndex); });
     }
+
+    pool.waitForDone();
 }
 
-void Assembler::removeComments(Token::TokenFile &f)
+void Assembler::logError()
 {
-    std::string *line; // Using a pointer to directly modify the token line string
-    size_t commaPos;
-
-    for (unsigned int i(0); i < f.m_lines.size(); i++)
+    if (!m_error.originFilePath.isEmpty())
     {
-        line = &(f.m_lines[i].m_originStr);
-        commaPos = line->find(';');
+        std::string location = "Error line " + std::to_string(m_error.originLineNb);
+
+        if (m_error.originColumnNb != 0)
+            location += ", column " + std::to_string(m_error.originColumnNb);
 
-        if (commaPos != std::string::npos) // Comment found
-            *line = line->substr(0, commaPos);
+        m_consoleOutput->log(location + " of file " + QFileInfo(m_error.originFilePath).fileName().toStdString());
     }
+
+    m_consoleOutput->log(Token::errStr[(int)m_error.type] + m_error.additionalInfo);
+    m_consoleOutput->returnLine();
 }
 
-void Assembler::removeEmptyLines(Token::TokenFile &f)
+// -- Major pass 1 --
+bool Assembler::tokenizeFile(Token::TokenFile &f, unsigned int &tokensNb, Error &error)
 {
-    bool empty;
-    std::string *line; // Using a pointer to directly modify the token line string
+    std::vector<Token::TokenLine> lines;
+    std::vector<unsigned int> columns;
+    std::string normalized;
+    bool inbetweenQuotation(false);
+    bool firstLabelFound(false), labelFound;
+    bool inMacro(false);
+
+    lines.reserve(f.m_lines.size());
 
     for (unsigned int i(0); i < f.m_lines.size(); i++)
     {
-        empty = true;
-        line = &(f.m_lines[i].m_originStr);
+        normalizeLine(f.m_lines[i].m_originStr, normalized, columns, inbetweenQuotation);
 
-        // Check if the line is empty or just full of spaces (which is considered empty too)
-        if (!line->empty())
-        {
-            for (unsigned int j(0); j < line->size(); j++)
-            {
-                if (line->at(j) != ' ')
-                {
-                    empty = false;
-                    break;
-                }
-            }
-        }
+        if (normalized.empty()) // Empty lines, or lines full of spaces or with a comment only
+            continue;
+
+        f.m_lines[i].m_originStr = normalized;
+
+        // Instructions of a macro are checked where it is used
+        labelFound = firstLabelFound || inMacro;
+
+        if (!tokenizeLine(f.m_lines[i], columns, labelFound, tokensNb, error))
+            return false;
+
+        if (!inMacro)
+            firstLabelFound = labelFound;
 
-        // Actually erase the line
-        if (empty)
+        if (f.m_lines[i].m_tokens[0].getType() == Token::TokenType::DIRECTIVE)
         {
-            f.m_lines.erase(f.m_lines.begin() + i);
-            i--;
+            if (f.m_lines[i].m_tokens[0].getDirective() == Token::Directive::MACRO)
+                inMacro = true;
+            else if (f.m_lines[i].m_tokens[0].getDirective() == Token::Directive::END_MACRO)
+                inMacro = false;
         }
+
+        lines.push_back(std::move(f.m_lines[i]));
     }
+
+    f.m_lines = std::move(lines);
+
+    return true;
 }
 
-void Assembler::fixIndentation(Token::TokenFile &f)
+void Assembler::normalizeLine(const std::string &source, std::string &normalized, std::vector<unsigned int> &columns, bool &inbetweenQuotation)
 {
-    std::string *line; // Using a pointer to directly modify the token line string
-    bool inbetweenQuotation(false);
+    size_t end = source.find(';'); // Comments start at the first ';', even in between " characters
+    bool afterComma(false);        // Spaces after a comma are dropped, unless in between " characters
+    size_t spacePos(std::string::npos);
+    char c;
 
-    for (unsigned int i(0); i < f.m_lines.size(); i++)
-    {
-        line = &(f.m_lines[i].m_originStr);
+    if (end == std::string::npos)
+        end = source.size();
 
-        // Remove spaces at line's start
-        while (line->at(0) == ' ')
-            *line = line->substr(1);
+    normalized.clear();
+    columns.clear();
 
-        // Remove spaces and tabs at line's end
-        while (line->back() == ' ')
-            *line = line->substr(0, line->size() - 1);
+    for (size_t i(0); i < end; i++)
+    {
+        c = source[i];
 
-        // Remove spaces and tabs before and after commas, unless in between " characters
-        for (size_t t(0); t < line->size(); t++)
+        if (c == ' ' || c == '\t')
         {
-            if (line->at(t) == '\"')
-                inbetweenQuotation = !inbetweenQuotation;
-            else if (line->at(t) == ',' && !inbetweenQuotation)
-            {
-                while (t - 1 > 0) // Erase spaces before comma
-                {
-                    if (line->at(t - 1) != ' ')
-                        break;
+            if (spacePos == std::string::npos)
+                spacePos = i;
 
-                    line->erase(t - 1, 1);
-                    t--;
-                }
+            continue;
+        }
 
-                while (t + 1 < line->size()) // Erase spaces after comma
-                {
-                    if (line->at(t + 1) != ' ')
-                        break;
+        // A sequence of spaces becomes one, unless at line's start or around a comma
+        if (spacePos != std::string::npos && !normalized.empty() && !afterComma && (c != ',' || inbetweenQuotation))
+        {
+            normalized.push_back(' ');
+            columns.push_back(spacePos + 1);
+        }
 
-                    line->erase(t + 1, 1);
-                }
-            }
-            else if (line->at(t) == ' ') // Remove multiple spaces in a row
-            {
-                while (t + 1 < line->size())
-                {
-                    if (line->at(t + 1) != ' ')
-                        break;
+        spacePos = std::string::npos;
+        afterComma = (c == ',' && !inbetweenQuotation);
 
-                    line->erase(t + 1, 1);
-                }
-            }
-        }
+        if (c == '\"')
+            inbetweenQuotation = !inbetweenQuotation;
+
+        normalized.push_back(c);
+        columns.push_back(i + 1);
     }
 }
 
-bool Assembler::convertToTokens(Token::TokenFile &f)
+bool Assembler::tokenizeLine(Token::TokenLine &tLine, const std::vector<unsigned int> &columns, bool &firstLabelFound, unsigned int &tokensNb, Error &error)
 {
-    Token::TokenLine *tLine;
+    const std::string &line = tLine.m_originStr;
     Token::TokenItem newToken("");
-    std::string line;
-    std::string tokenStr;
-    bool firstLabelFound(false);
+    size_t tokenStart, tokenEnd; // Token is [tokenStart, tokenEnd[ in line
+    size_t nextBound, nextQuote, closingParenthesis;
+    unsigned int parenthesesNb;
 
-    size_t nextComma, nextSpace, nextQuote;
+    // A trailing comma is an error as soon as no other comma comes before it
+    size_t commaBeforeEnd(std::string::npos);
 
-    for (unsigned int i(0); i < f.m_lines.size(); i++)
+    if (line.back() == ',' && line.size() > 1)
+        commaBeforeEnd = line.rfind(',', line.size() - 2);
+
+    for (size_t t(0); t < line.size(); t++)
     {
-        tLine = &(f.m_lines[i]);
-        line = tLine->m_originStr;
+        if (line.back() == ',' && (commaBeforeEnd == std::string::npos || commaBeforeEnd < t))
+            return tokenError(tLine, Token::ErrorType::EXPECT_EXPR, columns[line.size() - 1], error);
+
+        tokenStart = t;
+        nextBound = line.find_first_of(",\" ", t);
 
-        for (size_t t(0); t < line.size(); t++)
+        if (line[t] == '(') // Constant expression, spaces included, up to the matching ')'
         {
-            nextComma = line.find(',',  t);
-            nextSpace = line.find(' ',  t);
-            nextQuote = line.find('\"', t);
+            parenthesesNb = 0;
 
-            if (nextComma == (line.size() - 1))
+            for (closingParenthesis = t; closingParenthesis < line.size(); closingParenthesis++)
             {
-                m_error.originFilePath = tLine->m_originFilePath;
-                m_error.originLineNb = tLine->m_originLineNb;
-                m_error.type = Token::ErrorType::EXPECT_EXPR;
-                m_error.additionalInfo = "";
-
-                logError();
-                return false;
+                if (line[closingParenthesis] == '(')
+                    parenthesesNb++;
+                else if (line[closingParenthesis] == ')' && --parenthesesNb == 0)
+                    break;
             }
 
-            if (nextComma == std::string::npos && nextSpace == std::string::npos && nextQuote == std::string::npos) // No more bounding char until EOL
-            {
-                tokenStr = line.substr(t);
+            if (closingParenthesis == line.size())
+                return tokenError(tLine, Token::ErrorType::CONST_EXPR_INVAL, columns[t], error);
 
-                if (tokenStr.empty())
-                {
-                    m_error.originFilePath = tLine->m_originFilePath;
-                    m_error.originLineNb = tLine->m_originLineNb;
-                    m_error.type = Token::ErrorType::EXPECT_EXPR;
-                    m_error.additionalInfo = "";
+            if (closingParenthesis + 1 < line.size() && line[closingParenthesis + 1] != ',' && line[closingParenthesis + 1] != ' ')
+                return tokenError(tLine, Token::ErrorType::INVAL_EXPR, columns[closingParenthesis + 1], error);
 
-                    logError();
-                    return false;
-                }
+            tokenEnd = closingParenthesis + 1;
+            t = closingParenthesis + 1;
+        }
+        else if (nextBound == std::string::npos) // No more bounding char until EOL
+        {
+            tokenEnd = line.size();
+            t = line.size();
+        }
+        else if (line[nextBound] != '\"') // Closest bounding char is ',' or ' '
+        {
+            if (nextBound == t)
+                return tokenError(tLine, Token::ErrorType::EXPECT_EXPR, columns[t], error);
 
-                newToken = Token::TokenItem(tokenStr);
+            tokenEnd = nextBound;
+            t = nextBound;
+        }
+        else // Closest bounding char is '"'
+        {
+            if (nextBound != t)
+                return tokenError(tLine, Token::ErrorType::INVAL_EXPR, columns[t], error);
 
-                t = line.size(); //break;
-            }
-            else if ((nextComma < nextSpace) && (nextComma < nextQuote)) // Closest bounding char is ','
-            {
-                tokenStr = line.substr(t, nextComma - t);
+            nextQuote = line.find('\"', t + 1); // Looking for the ending quote
+            if (nextQuote == std::string::npos)
+                return tokenError(tLine, Token::ErrorType::MISSING_TERM_CHAR, columns[t], error);
 
-                if (tokenStr.empty())
-                {
-                    m_error.originFilePath = tLine->m_originFilePath;
-                    m_error.originLineNb = tLine->m_originLineNb;
-                    m_error.type = Token::ErrorType::EXPECT_EXPR;
-                    m_error.additionalInfo = "";
+            tokenEnd = nextQuote + 1;
+            t = nextQuote + 1; // The char following a string is never part of the next token
+        }
 
-                    logError();
-                    return false;
-                }
-
-                newToken = Token::TokenItem(tokenStr);
-
-                t = nextComma;
-            }
-            else if ((nextSpace < nextComma) && (nextSpace < nextQuote)) // Closest bounding char is ' '
-            {
-                tokenStr = line.substr(t, nextSpace - t);
-
-                if (tokenStr.empty())
-                {
-                    m_error.originFilePath = tLine->m_originFilePath;
-                    m_error.originLineNb = tLine->m_originLineNb;
-                    m_error.type = Token::ErrorType::EXPECT_EXPR;
-                    m_error.additionalInfo = "";
-
-                    logError();
-                    return false;
-                }
-
-                newToken = Token::TokenItem(tokenStr);
-
-                t = nextSpace;
-            }
-            else/* if ((nextQuote < nextComma) && (nextQuote < nextSpace))*/ // Closest bounding char is '"'
-            {
-                if (nextQuote != t)
-                {
-                    m_error.originFilePath = tLine->m_originFilePath;
-                    m_error.originLineNb = tLine->m_originLineNb;
-                    m_error.type = Token::ErrorType::INVAL_EXPR;
-                    m_error.additionalInfo = "";
-
-                    logError();
-                    return false;
-                }
-
-                nextQuote = line.find('\"', t + 1); // Looking for the ending quote
-                if (nextQuote == std::string::npos)
-                {
-                    m_error.originFilePath = tLine->m_originFilePath;
-                    m_error.originLineNb = tLine->m_originLineNb;
-                    m_error.type = Token::ErrorType::MISSING_TERM_CHAR;
-                    m_error.additionalInfo = "";
-
-                    logError();
-                    return false;
-                }
-
-                tokenStr = line.substr(t, nextQuote - t + 1);
-                newToken = Token::TokenItem(tokenStr);
-
-                t = nextQuote + 1;
-            }
-
-            if (newToken.getErr() != Token::ErrorType::NONE)
-            {
-                m_error.originFilePath = tLine->m_originFilePath;
-                m_error.originLineNb = tLine->m_originLineNb;
-                m_error.type = newToken.getErr();
-                m_error.additionalInfo = "";
-
-                logError();
-                return false;
-            }
+        newToken = Token::TokenItem(line.substr(tokenStart, tokenEnd - tokenStart));
+        newToken.setOrigin(columns[tokenStart], columns[tokenEnd - 1] - columns[tokenStart] + 1);
 
-            // Checking if the first instruction of the token file isn't alone
-            if (newToken.getType() == Token::TokenType::LABEL)
-            {
-                firstLabelFound = true;
-            }
-            else if (newToken.getType() == Token::TokenType::INSTR && !firstLabelFound)
-            {
-                m_error.originFilePath = tLine->m_originFilePath;
-                m_error.originLineNb = tLine->m_originLineNb;
-                m_error.type = Token::ErrorType::INSTR_ALONE;
-                m_error.additionalInfo = "";
+        if (newToken.getErr() != Token::ErrorType::NONE)
+            return tokenError(tLine, newToken.getErr(), columns[tokenStart], error);
 
-                logError();
-                return false;
-            }
+        // Checking if the first instruction of the token file isn't alone
+        if (newToken.getType() == Token::TokenType::LABEL)
+            firstLabelFound = true;
+        else if (newToken.getType() == Token::TokenType::INSTR && !firstLabelFound)
+            return tokenError(tLine, Token::ErrorType::INSTR_ALONE, columns[tokenStart], error);
 
-            tLine->m_tokens.push_back(newToken);
-            m_totalTokenCount++;
-        }
+        tLine.m_tokens.push_back(newToken);
+        tokensNb++;
     }
 
     return true;
 }
 
+bool Assembler::tokenError(const Token::TokenLine &tLine, Token::ErrorType type, unsigned int columnNb, Error &error)
+{
+    error.originFilePath = tLine.m_originFilePath;
+    error.originLineNb = tLine.m_originLineNb;
+    error.originColumnNb = columnNb;
+    error.type = type;
+    error.additionalInfo = "";
+
+    return false;
+}
+
 // -- Major pass 2 --
-bool Assembler::listDefines(Token::TokenFile &f)
+bool Assembler::listDefines(Token::TokenFile &f, std::vector<Define> &fileDefines, Error &error)
 {
     bool toProcess;
     Define def;
+    unsigned int keptLinesNb(0); // Lines without define are moved to the front of the file
+    unsigned int blocksNb(0); // Macros and conditional blocks the line is in, defines are global
 
     // Validity pass
     for (unsigned int i(0); i < f.m_lines.size(); i++)
     {
         toProcess = f.m_lines[i].m_tokens[0].getType() == Token::TokenType::DEFINE;
 
+        if (f.m_lines[i].m_tokens[0].getType() == Token::TokenType::DIRECTIVE)
+        {
+            switch (f.m_lines[i].m_tokens[0].getDirective())
+            {
+                case Token::Directive::MACRO:
+                case Token::Directive::IF:
+                case Token::Directive::IFDEF:
+                case Token::Directive::IFNDEF:
+                    blocksNb++;
+                    break;
+
+                case Token::Directive::END_MACRO:
+                case Token::Directive::END_IF:
+                    if (blocksNb > 0) // Balance checked by Preprocessor::listMacros()
+                        blocksNb--;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
         // Use of define elsewhere than on first token
         for (unsigned int j(1); j < f.m_lines[i].m_tokens.size(); j++)
         {
             if (f.m_lines[i].m_tokens[j].getType() == Token::TokenType::DEFINE)
             {
-                m_error.originFilePath = f.m_lines[i].m_originFilePath;
-                m_error.originLineNb = f.m_lines[i].m_originLineNb;
-                m_error.type = Token::ErrorType::INVAL_DEF;
-                m_error.additionalInfo = "";
-
-                logError();
+                error.originFilePath = f.m_lines[i].m_originFilePath;
+                error.originLineNb = f.m_lines[i].m_originLineNb;
+                error.type = Token::ErrorType::INVAL_DEF;
+                error.additionalInfo = "";
                 return false;
             }
         }
 
         if (toProcess)
         {
+            if (blocksNb > 0)
+            {
+                error.originFilePath = f.m_lines[i].m_originFilePath;
+                error.originLineNb = f.m_lines[i].m_originLineNb;
+                error.type = Token::ErrorType::DEF_IN_BLOCK;
+                error.additionalInfo = "";
+                return false;
+            }
+
             // Invalid number of arguments
             if (f.m_lines[i].m_tokens.size() != 3)
             {
-                m_error.originFilePath = f.m_lines[i].m_originFilePath;
-                m_error.originLineNb = f.m_lines[i].m_originLineNb;
-                m_error.type = Token::ErrorType::DEF_ARG_NB;
-                m_error.additionalInfo = "";
-
-                logError();
+                error.originFilePath = f.m_lines[i].m_originFilePath;
+                error.originLineNb = f.m_lines[i].m_originLineNb;
+                error.type = Token::ErrorType::DEF_ARG_NB;
+                error.additionalInfo = "";
                 return false;
             }
 
             // Variable to replace not set
             if (f.m_lines[i].m_tokens[1].getType() != Token::TokenType::VAR)
             {
-                m_error.originFilePath = f.m_lines[i].m_originFilePath;
-                m_error.originLineNb = f.m_lines[i].m_originLineNb;
-                m_error.type = Token::ErrorType::DEF_VAR_MISS;
-                m_error.additionalInfo = "";
-
-                logError();
+                error.originFilePath = f.m_lines[i].m_originFilePath;
+                error.originLineNb = f.m_lines[i].m_originLineNb;
+                error.type = Token::ErrorType::DEF_VAR_MISS;
+                error.additionalInfo = "";
                 return false;
             }
 
@@ -724,64 +863,115 @@ bool Assembler::listDefines(Token::TokenFile &f)
             def.fileWhereDefined = f.m_lines[i].m_originFilePath;
             def.lineNbWhereDefined = f.m_lines[i].m_originLineNb;
 
-            // Check if already defined elsewhere
-            for (unsigned int j(0); j < m_defToProcess.size(); j++)
-            {
-                if (m_defToProcess[j].originalStr == def.originalStr)
-                {
-                    m_error.originFilePath = f.m_lines[i].m_originFilePath;
-                    m_error.originLineNb = f.m_lines[i].m_originLineNb;
-                    m_error.type = Token::ErrorType::DEF_ALREADY_EXIST;
-                    m_error.additionalInfo = "\"" + QFileInfo(m_defToProcess[j].fileWhereDefined).fileName().toStdString()
-                                             + "\"" + " at line " + std::to_string(m_defToProcess[j].lineNbWhereDefined);
+            fileDefines.push_back(def);
+        }
+        else
+        {
+            if (keptLinesNb != i)
+                f.m_lines[keptLinesNb] = std::move(f.m_lines[i]);
 
-                    logError();
-                    return false;
-                }
-            }
+            keptLinesNb++;
+        }
+    }
+
+    f.m_lines.resize(keptLinesNb);
+
+    return true;
+}
+
+bool Assembler::registerDefines(const std::vector<Define> &fileDefines)
+{
+    SymbolId symbol;
+    int alreadyDefined;
 
-            m_defToProcess.push_back(def);
-            f.m_lines.erase(f.m_lines.begin() + i);
-            i--;
+    for (unsigned int i(0); i < fileDefines.size(); i++)
+    {
+        // Check if already defined elsewhere
+        symbol = m_symbols.intern(fileDefines[i].originalStr);
+        alreadyDefined = m_symbols.getBinding(symbol, SymbolKind::DEFINE);
+
+        if (alreadyDefined != NO_BINDING)
+        {
+            m_error.originFilePath = fileDefines[i].fileWhereDefined;
+            m_error.originLineNb = fileDefines[i].lineNbWhereDefined;
+            m_error.type = Token::ErrorType::DEF_ALREADY_EXIST;
+            m_error.additionalInfo = "\"" + QFileInfo(m_defToProcess[alreadyDefined].fileWhereDefined).fileName().toStdString()
+                                     + "\"" + " at line " + std::to_string(m_defToProcess[alreadyDefined].lineNbWhereDefined);
+
+            logError();
+            return false;
         }
+
+        m_symbols.bind(symbol, SymbolKind::DEFINE, (int)m_defToProcess.size());
+        m_defToProcess.push_back(fileDefines[i]);
     }
 
-    m_definesCount = (unsigned int)m_defToProcess.size();
+    return true;
+}
+
+bool Assembler::registerMacros(const std::vector<Macro> &fileMacros)
+{
+    SymbolId symbol;
+    int alreadyDefined;
+
+    for (unsigned int i(0); i < fileMacros.size(); i++)
+    {
+        symbol = m_symbols.intern(fileMacros[i].name);
+        alreadyDefined = m_symbols.getBinding(symbol, SymbolKind::MACRO);
+
+        if (alreadyDefined != NO_BINDING)
+        {
+            m_error.originFilePath = fileMacros[i].fileWhereDefined;
+            m_error.originLineNb = fileMacros[i].lineNbWhereDefined;
+            m_error.type = Token::ErrorType::MACRO_ALREADY_EXIST;
+            m_error.additionalInfo = "\"" + QFileInfo(m_macros[alreadyDefined].fileWhereDefined).fileName().toStdString()
+                                     + "\"" + " at line " + std::to_string(m_macros[alreadyDefined].lineNbWhereDefined);
+
+            logError();
+            return false;
+        }
+
+        m_symbols.bind(symbol, SymbolKind::MACRO, (int)m_macros.size());
+        m_macros.push_back(fileMacros[i]);
+    }
 
     return true;
 }
 
-bool Assembler::processDefines()
+bool Assembler::processDefines(Token::TokenFile &f, Error &error)
 {
     Token::TokenItem *toCheckTk;
+    int defineIndex, nextDefineIndex;
 
-    for (unsigned int f(0); f < m_tokenFiles.size(); f++)
+    for (unsigned int l(0); l < f.m_lines.size(); l++)
     {
-        for (unsigned int l(0); l < m_tokenFiles[f].m_lines.size(); l++)
+        for (unsigned int t(0); t < f.m_lines[l].m_tokens.size(); t++)
         {
-            for (unsigned int t(0); t < m_tokenFiles[f].m_lines[l].m_tokens.size(); t++)
+            toCheckTk = &(f.m_lines[l].m_tokens[t]);
+
+            // Define names are variable names, the other tokens are not looked up
+            if (toCheckTk->getType() != Token::TokenType::VAR)
+                continue;
+
+            defineIndex = m_symbols.getBinding(m_symbols.find(toCheckTk->getStr()), SymbolKind::DEFINE);
+
+            while (defineIndex != NO_BINDING)
             {
-                toCheckTk = &(m_tokenFiles[f].m_lines[l].m_tokens[t]);
+                toCheckTk->setStr(m_defToProcess[defineIndex].replacementStr);
 
-                for (unsigned int i(0); i < m_defToProcess.size(); i++)
+                if (toCheckTk->getErr() != Token::ErrorType::NONE)
                 {
-                    if (toCheckTk->getStr() == m_defToProcess[i].originalStr)
-                    {
-                        toCheckTk->setStr(m_defToProcess[i].replacementStr);
-
-                        if (toCheckTk->getErr() != Token::ErrorType::NONE)
-                        {
-                            m_error.originFilePath = m_tokenFiles[f].m_lines[l].m_originFilePath;
-                            m_error.originLineNb = m_tokenFiles[f].m_lines[l].m_originLineNb;
-                            m_error.type = Token::ErrorType::DEF_REPLAC_ERR;
-                            m_error.additionalInfo = "\"" + QFileInfo(m_defToProcess[i].fileWhereDefined).fileName().toStdString()
-                                                     + "\"" + " at line " + std::to_string(m_defToProcess[i].lineNbWhereDefined);
-
-                            logError();
-                            return false;
-                        }
-                    }
+                    error.originFilePath = f.m_lines[l].m_originFilePath;
+                    error.originLineNb = f.m_lines[l].m_originLineNb;
+                    error.type = Token::ErrorType::DEF_REPLAC_ERR;
+                    error.additionalInfo = "\"" + QFileInfo(m_defToProcess[defineIndex].fileWhereDefined).fileName().toStdString()
+                                             + "\"" + " at line " + std::to_string(m_defToProcess[defineIndex].lineNbWhereDefined);
+                    return false;
                 }
+
+                // The replacement is replaced again only by a define declared after this one
+                nextDefineIndex = m_symbols.getBinding(m_symbols.find(toCheckTk->getStr()), SymbolKind::DEFINE);
+                defineIndex = (nextDefineIndex > defineIndex) ? nextDefineIndex : NO_BINDING;
             }
         }
     }
@@ -913,11 +1103,11 @@ bool Assembler::processIncludesInFile(Token::TokenFile &f)
 }
 
 // -- Major pass 3 --
-bool Assembler::checkArgumentsValidity(bool targetEeprom)
+bool Assembler::checkArgumentsValidity()
 {
     for (unsigned int i(0); i < m_finalFile.m_lines.size(); i++)
     {
-        if (!m_finalFile.m_lines[i].checkValidity(targetEeprom))
+        if (m_finalFile.m_lines[i].m_err != Token::ErrorType::NONE)
         {
             m_error.originFilePath = m_finalFile.m_lines[i].m_originFilePath;
             m_error.originLineNb = m_finalFile.m_lines[i].m_originLineNb;
@@ -937,6 +1127,7 @@ bool Assembler::listVariables(bool targetEeprom)
 {
     Token::TokenLine *line;
     Variable var;
+    unsigned int keptLinesNb(0); // Lines without data are moved to the front of the final file
 
     for (unsigned int i(0); i < m_finalFile.m_lines.size(); i++)
     {
@@ -1009,22 +1200,7 @@ bool Assembler::listVariables(bool targetEeprom)
                 var.range.begin = line->m_tokens[2].getAddress();
                 var.range.end = var.range.begin + var.size - 1;
 
-                // Check if that new data definition do not overlap any other one
-                for (unsigned int j(0); j < m_definedVars.size(); j++)
-                {
-                    if (doRangeOverlap(m_definedVars[j].range, var.range))
-                    {
-                        m_error.originFilePath = var.originFile;
-                        m_error.originLineNb = var.originLineNb;
-                        m_error.type = Token::ErrorType::DATA_OVERLAP;
-                        m_error.additionalInfo = m_definedVars[j].name + "\"";
-
-                        logError();
-                        return false;
-                    }
-                }
-
-                m_definedVars.push_back(var);
+                m_definedVars.push_back(var); // Overlaps are checked by the Linker
             }
             else
             {
@@ -1044,12 +1220,18 @@ bool Assembler::listVariables(bool targetEeprom)
             }
 
             m_variablesCount++;
+        }
+        else
+        {
+            if (keptLinesNb != i)
+                m_finalFile.m_lines[keptLinesNb] = std::move(m_finalFile.m_lines[i]);
 
-            m_finalFile.m_lines.erase(m_finalFile.m_lines.begin() + i);
-            i--;
+            keptLinesNb++;
         }
     }
 
+    m_finalFile.m_lines.resize(keptLinesNb);
+
     // Insuring defined data definitions last address do not exceed memory size
     for (unsigned int i(0); i < m_definedVars.size(); i++)
     {
@@ -1122,6 +1304,7 @@ bool Assembler::constructRoutineBlocks(bool targetEeprom)
     RoutineBlock block;
     Token::TokenLine *line(nullptr);
     std::string newLabel("");
+    SymbolId newLabelSymbol;
     bool firstRun(true);
 
     for (unsigned int i(0); i < m_finalFile.m_lines.size(); i++)
@@ -1173,20 +1356,21 @@ bool Assembler::constructRoutineBlocks(bool targetEeprom)
             newLabel = line->m_tokens[0].getLabelName();
 
             // Check for same name in defined routine blocks
-            for (unsigned int j(0); j < m_routineBlocks.size(); j++)
+            newLabelSymbol = m_symbols.intern(newLabel);
+
+            if (m_symbols.getBinding(newLabelSymbol, SymbolKind::ROUTINE) != NO_BINDING)
             {
-                if (m_routineBlocks[j].labelName == newLabel)
-                {
-                    m_error.originFilePath = line->m_originFilePath;
-                    m_error.originLineNb = line->m_originLineNb;
-                    m_error.type = Token::ErrorType::LABEL_ALREADY_USED;
-                    m_error.additionalInfo = "";
+                m_error.originFilePath = line->m_originFilePath;
+                m_error.originLineNb = line->m_originLineNb;
+                m_error.type = Token::ErrorType::LABEL_ALREADY_USED;
+                m_error.additionalInfo = "";
 
-                    logError();
-                    return false;
-                }
+                logError();
+                return false;
             }
 
+            m_symbols.bind(newLabelSymbol, SymbolKind::ROUTINE, (int)m_routineBlocks.size()); // Index of the block once stored
+
             // Reinit a new block
             block.labelName = newLabel;
             block.range.begin = (line->m_tokens.size() == 1) ? ADDRESS_NOT_SET : line->m_tokens[1].getAddress();
@@ -1225,615 +1409,415 @@ bool Assembler::constructRoutineBlocks(bool targetEeprom)
 
     m_routineBlocksCount = (unsigned int)m_routineBlocks.size();
 
-    // Find "_start" label
-    bool startRoutineFound(false);
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
-    {
-        if (m_routineBlocks[i].labelName == "_start")
-        {
-            startRoutineFound = true;
-            break;
-        }
-    }
-
-    if (!startRoutineFound)
-    {
-        m_error.originFilePath = "";
-        m_error.originLineNb = 0;
-        m_error.type = Token::ErrorType::START_ROUTINE_MISSING;
-        m_error.additionalInfo = "";
-
-        logError();
-        return false;
-    }
-
-    return true;
+    return true; // "_start" is looked for by the Linker, a library has none
 }
 
-bool Assembler::calculateRoutineBlocksAddresses()
+// -- Major pass 6 --
+bool Assembler::generateObject(const Sources &sources, bool targetEeprom)
 {
-    uint32_t nextAvailableAddress(ADDRESS_NOT_SET);
+    m_object.name = sources.name;
+    m_object.targetEeprom = targetEeprom;
 
     for (unsigned int i(0); i < m_routineBlocks.size(); i++)
     {
-        if (m_routineBlocks[i].range.begin == ADDRESS_NOT_SET) // Undefined routine
+        RoutineBlock &block(m_routineBlocks[i]);
+        Section section;
+        uint32_t instructionBinary;
+
+        section.type = SectionType::ROUTINE;
+        section.name = m_object.addName(block.labelName);
+        section.fixedAddress = (block.range.begin != ADDRESS_NOT_SET);
+        section.address = block.range.begin;
+        section.originFileId = m_object.addFile(block.originFile);
+        section.originLineNb = block.originLineNb;
+        section.content.reserve(block.size());
+
+        for (unsigned int j(0); j < block.instructionLines.size(); j++)
         {
-            m_routineBlocks[i].range.begin = nextAvailableAddress;
-            m_routineBlocks[i].range.end = nextAvailableAddress + m_routineBlocks[i].size() - 1;
+            Token::TokenLine *line = &(block.instructionLines[j]);
+            uint32_t offset(j * Cpu::INSTRUCTION_SIZE);
 
-            if (m_routineBlocks[i].range.end >= Eeprom::MEMORY_SIZE)
-            {
-                m_error.originFilePath = "";
-                m_error.originLineNb = 0;
-                m_error.type = Token::ErrorType::MEM_USE;
-                m_error.additionalInfo = "";
+            instructionBinary = getBinaryFromTokenLine(line, offset, section);
 
-                logError();
-                return false;
-            }
+            section.content.push_back((char)((instructionBinary & 0xFF000000) >> 24));
+            section.content.push_back((char)((instructionBinary & 0x00FF0000) >> 16));
+            section.content.push_back((char)((instructionBinary & 0x0000FF00) >> 8));
+            section.content.push_back((char)((instructionBinary & 0x000000FF)));
+
+            section.lines.push_back({ offset, m_object.addFile(line->m_originFilePath), line->m_originLineNb });
         }
 
-        nextAvailableAddress = m_routineBlocks[i].range.begin + m_routineBlocks[i].size();
+        m_object.sections.push_back(std::move(section));
     }
 
-    // Check if any routine block overlaps another one
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
+    // Defined variables first: the Linker reserves them before placing the others
+    for (std::vector<Variable> *variables : { &m_definedVars, &m_undefinedVars })
     {
-        for (unsigned int j(0); j < m_routineBlocks.size(); j++)
+        for (Variable &var : *variables)
         {
-            if (i != j)
+            Section section;
+
+            section.type = SectionType::DATA;
+            section.name = m_object.addName(var.name);
+            section.fixedAddress = (variables == &m_definedVars);
+            section.address = section.fixedAddress ? var.range.begin : ADDRESS_NOT_SET;
+            section.originFileId = m_object.addFile(var.originFile);
+            section.originLineNb = var.originLineNb;
+
+            if (var.type == Token::DataType::SINGLE_VALUE_DEFINED || var.type == Token::DataType::SINGLE_VALUE_UNDEFINED)
+            {
+                section.content.push_back((char)var.values[0].getValue());
+            }
+            else if (var.type == Token::DataType::STRING_DEFINED || var.type == Token::DataType::STRING_UNDEFINED)
             {
-                if (doRangeOverlap(m_routineBlocks[i].range, m_routineBlocks[j].range))
+                section.content = QByteArray::fromStdString(var.values[0].getStr());
+            }
+            else // Multiple values
+            {
+                for (unsigned int j(0); j < var.values.size(); j++)
                 {
-                    m_error.originFilePath = m_routineBlocks[i].originFile;
-                    m_error.originLineNb = m_routineBlocks[i].originLineNb;
-                    m_error.type = Token::ErrorType::ROUTINE_OVERLAP;
-                    m_error.additionalInfo = m_routineBlocks[j].labelName + "\"";
-
-                    logError();
-                    return false;
+                    section.content.push_back((char)var.values[j].getValue());
                 }
             }
+
+            m_object.sections.push_back(std::move(section));
         }
     }
 
-    // Check if any data definition overlaps a routine
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
+    m_object.listImports();
+
+    return true;
+}
+
+// -- Utils --
+Token::TokenFile* Assembler::findTokenFile(QString fileName)
+{
+    for (unsigned int i(0); i < m_tokenFiles.size(); i++)
     {
-        for (unsigned int j(0); j < m_definedVars.size(); j++)
+        if (m_tokenFiles[i].m_fileName == fileName)
         {
-            if (doRangeOverlap(m_routineBlocks[i].range, m_definedVars[j].range))
-            {
-                m_error.originFilePath = m_definedVars[j].originFile;
-                m_error.originLineNb = m_definedVars[j].originLineNb;
-                m_error.type = Token::ErrorType::DATA_OVERWRITES_INSTR;
-                m_error.additionalInfo = m_routineBlocks[i].labelName + "\", try automatic data address calculation";
-
-                logError();
-                return false;
-            }
+            return &(m_tokenFiles[i]);
         }
     }
 
-    return true;
+    return nullptr;
 }
 
-// -- Major pass 6 --
-bool Assembler::findFreeMemorySpaces(bool targetEeprom)
+uint32_t Assembler::getBinaryFromTokenLine(Token::TokenLine* line, uint32_t offset, Section &section)
 {
-    std::sort(m_definedVars.begin(), m_definedVars.end(), variableAddressInferiorComparator);
-    std::sort(m_routineBlocks.begin(), m_routineBlocks.end(), routineAddressInferiorComparator);
+    const Cpu::Formats::Format *format = Cpu::Formats::find(line->m_instr.m_opcode, line->m_instr.m_addrMode); // Checked by TokenLine::checkValidity()
+    Cpu::Formats::Fields fields;
 
-    MemorySpace newFreeSpace;
-    newFreeSpace.range.begin = Cpu::PROGRAM_START_ADDRESS;
+    fields.opcode = line->m_instr.m_opcode;
+    fields.addrMode = line->m_instr.m_addrMode;
 
-    m_freeMemorySpaces.clear();
-
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
+    // Every argument in the field of its operand
+    for (unsigned int i(0); i < format->getOperandsNb(); i++)
     {
-        if (m_routineBlocks[i].range.begin > newFreeSpace.range.begin)
+        Token::TokenItem &token = line->m_tokens[i + 1];
+
+        switch (format->operands[i].field)
         {
-            newFreeSpace.range.end = m_routineBlocks[i].range.begin - 1;
-            m_freeMemorySpaces.push_back(newFreeSpace);
-        }
+        case Cpu::Formats::Field::R1:
+            fields.r1 = (uint8_t)token.getRegister();
+            break;
 
-        newFreeSpace.range.begin = m_routineBlocks[i].range.end + 1;
-    }
+        case Cpu::Formats::Field::R2:
+            fields.r2 = (uint8_t)token.getRegister();
+            break;
 
-    if (m_routineBlocks.back().range.end < (targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE))
-    {
-        newFreeSpace.range.end = (targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE) - 1;
-        m_freeMemorySpaces.push_back(newFreeSpace);
-    }
+        case Cpu::Formats::Field::R3:
+            fields.r3 = (uint8_t)token.getRegister();
+            break;
 
-    // Update free memory spaces with defined data
-    for (unsigned int i(0); i < m_definedVars.size(); i++)
-    {
-        // Update impacted free memory space
-        for (unsigned int j(0); j < m_freeMemorySpaces.size(); j++)
-        {
-            if (doRangeOverlap(m_definedVars[i].range, m_freeMemorySpaces[j].range))
-            {
-                if (!splitFreeMemorySpace(j, i))
-                {
-                    m_error.originFilePath = "";
-                    m_error.originLineNb = 0;
-                    m_error.type = Token::ErrorType::SPLIT_MEM;
-                    m_error.additionalInfo = "";
+        case Cpu::Formats::Field::R1_R2: // [rr]
+            fields.r1 = (uint8_t)token.getConcatRegs().msReg;
+            fields.r2 = (uint8_t)token.getConcatRegs().lsReg;
+            break;
 
-                    logError();
-                    return false;
-                }
+        case Cpu::Formats::Field::V1:
+            if (token.getType() == Token::TokenType::ADDR_MSB)
+                section.relocations.push_back({ offset, RelocationType::ADDRESS_MSB, m_object.addName(token.getLabelName()) });
+            else if (token.getType() == Token::TokenType::ADDR_LSB)
+                section.relocations.push_back({ offset, RelocationType::ADDRESS_LSB, m_object.addName(token.getLabelName()) });
+            else
+                fields.v1 = token.getValue();
+            break;
 
-                break;
-            }
+        case Cpu::Formats::Field::VX:
+            if (token.getType() == Token::TokenType::VAR)
+                section.relocations.push_back({ offset, RelocationType::ADDRESS, m_object.addName(token.getVariableName()) });
+            else
+                fields.vX = token.getAddress();
+            break;
+
+        default:
+            break;
         }
     }
 
-    return true;
+    return Cpu::Formats::encode(fields);
 }
 
-bool Assembler::calculateVariablesAddresses()
+// -- Incremental assembly --
+void Assembler::loadCache(QString projectDirPath)
 {
-    while (m_undefinedVars.size() > 0)
-    {
-        bool spaceFound(false);
+    if (projectDirPath == m_cacheDirPath)
+        return;
 
-        for (unsigned int j(0); j < m_freeMemorySpaces.size(); j++)
-        {
-            if (m_freeMemorySpaces[j].size() >= m_undefinedVars[0].size) // Large enough free memory space found
-            {
-                spaceFound = true;
-                m_undefinedVars[0].range.begin = m_freeMemorySpaces[j].range.begin;
-                m_undefinedVars[0].range.end = m_undefinedVars[0].range.begin + m_undefinedVars[0].size - 1;
+    m_cachedFiles.clear();
+    m_cacheDirPath = projectDirPath;
 
-                // Update free memory spaces
-                if (m_undefinedVars[0].size == m_freeMemorySpaces[j].size())
-                {
-                    m_freeMemorySpaces.erase(m_freeMemorySpaces.begin() + j);
-                }
-                else
-                {
-                    m_freeMemorySpaces[j].range.begin += m_undefinedVars[0].size;
-                }
+    QFile cacheFile(QDir(projectDirPath).filePath(QString(CACHE_DIRECTORY_NAME) + "/" + CACHE_FILE_NAME));
 
-                break;
-            }
-        }
-
-        if (!spaceFound)
-        {
-            m_error.originFilePath = "";
-            m_error.originLineNb = 0;
-            m_error.type = Token::ErrorType::MEM_USE;
-            m_error.additionalInfo = "";
-
-            logError();
-            return false;
-        }
+    if (!cacheFile.open(QIODevice::ReadOnly)) // No cache yet
+        return;
 
-        m_definedVars.push_back(m_undefinedVars[0]);
-        m_undefinedVars.erase(m_undefinedVars.begin());
-    }
+    QDataStream stream(&cacheFile);
+    char magic[4];
+    quint32 version, filesNb;
 
-    std::sort(m_definedVars.begin(), m_definedVars.end(), variableAddressInferiorComparator);
+    if (stream.readRawData(magic, 4) != 4 || memcmp(magic, "HBCC", 4) != 0)
+        return;
 
-    return true;
-}
+    stream >> version >> filesNb;
 
-bool Assembler::replaceVariablesByAddresses()
-{
-    bool found(false);
+    if (version != CACHE_FORMAT_VERSION)
+        return;
 
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
+    for (quint32 f(0); f < filesNb && stream.status() == QDataStream::Ok; f++)
     {
-        for (unsigned int j(0); j < m_routineBlocks[i].instructionLines.size(); j++)
-        {
-            Token::TokenLine *line = &(m_routineBlocks[i].instructionLines[j]);
+        QString filePath;
+        quint64 contentHash;
+        quint32 tokensNb, linesNb, definesNb;
+        Token::TokenFile tokenFile;
+        std::vector<Define> fileDefines;
 
-            for (unsigned int t(0); t < line->m_tokens.size(); t++)
-            {
-                if (line->m_tokens[t].getType() == Token::TokenType::VAR)
-                {
-                    // Search for equivalent variable
-                    found = false;
-                    for (unsigned int x(0); x < m_definedVars.size(); x++)
-                    {
-                        if (m_definedVars[x].name == line->m_tokens[t].getVariableName())
-                        {
-                            line->m_tokens[t].setAsAddress(m_definedVars[x].range.begin);
-
-                            found = true;
-                            break;
-                        }
-                    }
+        stream >> filePath >> contentHash >> tokensNb >> linesNb;
 
-                    // Search for equivalent routine block
-                    if (!found)
-                    {
-                        for (unsigned int x(0); x < m_routineBlocks.size(); x++)
-                        {
-                            if (m_routineBlocks[x].labelName == line->m_tokens[t].getVariableName())
-                            {
-                                line->m_tokens[t].setAsAddress(m_routineBlocks[x].range.begin);
-
-                                found = true;
-                                break;
-                            }
-                        }
-                    }
+        tokenFile.m_fileName = QFileInfo(filePath).fileName();
+        tokenFile.m_filePath = filePath;
 
-                    if (!found)
-                    {
-                        m_error.originFilePath = line->m_originFilePath;
-                        m_error.originLineNb = line->m_originLineNb;
-                        m_error.type = Token::ErrorType::UNKNOWN_VARIABLE;
-                        m_error.additionalInfo = "";
+        for (quint32 l(0); l < linesNb && stream.status() == QDataStream::Ok; l++)
+        {
+            Token::TokenLine tLine;
+            quint32 lineNb, lineTokensNb;
+            QByteArray originStr;
 
-                        logError();
-                        return false;
-                    }
-                }
-                else if (line->m_tokens[t].getType() == Token::TokenType::ADDR_MSB)
-                {
-                    // Search for equivalent variable
-                    found = false;
-                    for (unsigned int x(0); x < m_definedVars.size(); x++)
-                    {
-                        if (m_definedVars[x].name == line->m_tokens[t].getLabelName())
-                        {
-                            line->m_tokens[t].setAsValue((uint8_t)(m_definedVars[x].range.begin >> 8));
+            stream >> lineNb >> originStr >> lineTokensNb;
 
-                            found = true;
-                            break;
-                        }
-                    }
+            tLine.m_originFilePath = filePath;
+            tLine.m_originLineNb = lineNb;
+            tLine.m_originStr = originStr.toStdString();
 
-                    // Search for equivalent routine block
-                    if (!found)
-                    {
-                        for (unsigned int x(0); x < m_routineBlocks.size(); x++)
-                        {
-                            if (m_routineBlocks[x].labelName == line->m_tokens[t].getLabelName())
-                            {
-                                line->m_tokens[t].setAsValue((uint8_t)(m_routineBlocks[x].range.begin >> 8));
-
-                                found = true;
-                                break;
-                            }
-                        }
-                    }
+            for (quint32 t(0); t < lineTokensNb && stream.status() == QDataStream::Ok; t++)
+            {
+                QByteArray str;
+                quint32 columnNb, length;
 
-                    if (!found)
-                    {
-                        m_error.originFilePath = line->m_originFilePath;
-                        m_error.originLineNb = line->m_originLineNb;
-                        m_error.type = Token::ErrorType::UNKNOWN_VARIABLE;
-                        m_error.additionalInfo = "";
+                stream >> str >> columnNb >> length;
 
-                        logError();
-                        return false;
-                    }
-                }
-                else if (line->m_tokens[t].getType() == Token::TokenType::ADDR_LSB)
-                {
-                    std::string variableName(line->m_tokens[t].getStr().substr(0, line->m_tokens[t].getStr().size() - 4));
+                Token::TokenItem token(str.toStdString()); // Type determined again from the string
+                token.setOrigin(columnNb, length);
+                tLine.m_tokens.push_back(token);
+            }
 
-                    // Search for equivalent variable
-                    found = false;
-                    for (unsigned int x(0); x < m_definedVars.size(); x++)
-                    {
-                        if (m_definedVars[x].name == line->m_tokens[t].getLabelName())
-                        {
-                            line->m_tokens[t].setAsValue((uint8_t)m_definedVars[x].range.begin);
+            tokenFile.m_lines.push_back(tLine);
+        }
 
-                            found = true;
-                            break;
-                        }
-                    }
+        stream >> definesNb;
 
-                    // Search for equivalent routine block
-                    if (!found)
-                    {
-                        for (unsigned int x(0); x < m_routineBlocks.size(); x++)
-                        {
-                            if (m_routineBlocks[x].labelName == line->m_tokens[t].getLabelName())
-                            {
-                                line->m_tokens[t].setAsValue((uint8_t)m_routineBlocks[x].range.begin);
-
-                                found = true;
-                                break;
-                            }
-                        }
-                    }
+        for (quint32 d(0); d < definesNb && stream.status() == QDataStream::Ok; d++)
+        {
+            Define def;
+            QByteArray originalStr, replacementStr;
+            quint32 lineNb;
 
-                    if (!found)
-                    {
-                        m_error.originFilePath = line->m_originFilePath;
-                        m_error.originLineNb = line->m_originLineNb;
-                        m_error.type = Token::ErrorType::UNKNOWN_VARIABLE;
-                        m_error.additionalInfo = "";
+            stream >> originalStr >> replacementStr >> lineNb;
 
-                        logError();
-                        return false;
-                    }
-                }
-            }
+            def.originalStr = originalStr.toStdString();
+            def.replacementStr = replacementStr.toStdString();
+            def.fileWhereDefined = filePath;
+            def.lineNbWhereDefined = lineNb;
+            fileDefines.push_back(def);
         }
+
+        if (stream.status() == QDataStream::Ok)
+            storeCachedFile(filePath, contentHash, tokensNb, tokenFile, fileDefines);
     }
 
-    return true;
+    if (stream.status() != QDataStream::Ok) // Truncated file, every file will be tokenized again
+        m_cachedFiles.clear();
 }
 
-// -- Major pass 7 --
-bool Assembler::convertTokensToBinary()
+void Assembler::saveCache()
 {
-    Token::TokenLine *line(nullptr);
-    uint32_t instructionAddress; // 32-bit because it could hold an EEPROM 20-bit address
-    uint32_t instructionBinary;
-    for (unsigned int i(0); i < m_routineBlocks.size(); i++)
+    // Deleted or renamed files are forgotten
+    for (auto it = m_cachedFiles.begin(); it != m_cachedFiles.end();)
     {
-        instructionAddress = m_routineBlocks[i].range.begin;
-
-        for (unsigned int j(0); j < m_routineBlocks[i].instructionLines.size(); j++)
-        {
-            line = &(m_routineBlocks[i].instructionLines[j]);
+        if (m_filesPaths.contains(it->first))
+            it++;
+        else
+            it = m_cachedFiles.erase(it);
+    }
 
-            instructionBinary = getBinaryFromTokenLine(line);
+    QDir cacheDirectory(m_cacheDirPath);
 
-            m_finalBinary.binaryData[instructionAddress]     = ((instructionBinary & 0xFF000000) >> 24);
-            m_finalBinary.binaryData[instructionAddress + 1] = ((instructionBinary & 0x00FF0000) >> 16);
-            m_finalBinary.binaryData[instructionAddress + 2] = ((instructionBinary & 0x0000FF00) >> 8);
-            m_finalBinary.binaryData[instructionAddress + 3] = ((instructionBinary & 0x000000FF));
+    if (!cacheDirectory.mkpath(CACHE_DIRECTORY_NAME))
+    {
+        m_consoleOutput->log("Cannot create the assembly cache directory: " + cacheDirectory.filePath(CACHE_DIRECTORY_NAME).toStdString());
+        return;
+    }
 
-            m_finalBinary.origin[instructionAddress].filePath = m_routineBlocks[i].instructionLines[j].m_originFilePath;
-            m_finalBinary.origin[instructionAddress].lineNb = m_routineBlocks[i].instructionLines[j].m_originLineNb;
+    QSaveFile cacheFile(cacheDirectory.filePath(QString(CACHE_DIRECTORY_NAME) + "/" + CACHE_FILE_NAME));
 
-            instructionAddress += Cpu::INSTRUCTION_SIZE;
-        }
+    if (!cacheFile.open(QIODevice::WriteOnly))
+    {
+        m_consoleOutput->log("Cannot write the assembly cache file: " + cacheFile.fileName().toStdString());
+        return;
     }
 
-    return true;
-}
+    QDataStream stream(&cacheFile);
 
-bool Assembler::convertDataToBinary()
-{
-    for (unsigned int i(0); i < m_definedVars.size(); i++)
+    stream.writeRawData("HBCC", 4);
+    stream << CACHE_FORMAT_VERSION << (quint32)m_cachedFiles.size();
+
+    for (auto it = m_cachedFiles.begin(); it != m_cachedFiles.end(); it++)
     {
-        if (m_definedVars[i].type == Token::DataType::SINGLE_VALUE_DEFINED || m_definedVars[i].type == Token::DataType::SINGLE_VALUE_UNDEFINED)
-        {
-            m_finalBinary.binaryData[m_definedVars[i].range.begin] = m_definedVars[i].values[0].getValue();
-        }
-        else if (m_definedVars[i].type == Token::DataType::STRING_DEFINED || m_definedVars[i].type == Token::DataType::STRING_UNDEFINED)
-        {
-            std::string str = m_definedVars[i].values[0].getStr();
+        CachedFile &cachedFile = it->second;
 
-            for (unsigned int j(0); j < str.size(); j++)
-            {
-                m_finalBinary.binaryData[m_definedVars[i].range.begin + j] = str.at(j);
-            }
-        }
-        else // Multiple values
+        stream << it->first << cachedFile.contentHash << (quint32)cachedFile.tokensNb << (quint32)cachedFile.tokenFile.m_lines.size();
+
+        for (unsigned int l(0); l < cachedFile.tokenFile.m_lines.size(); l++)
         {
-            for (unsigned int j(0); j < m_definedVars[i].values.size(); j++)
+            Token::TokenLine &tLine = cachedFile.tokenFile.m_lines[l];
+
+            stream << (quint32)tLine.m_originLineNb << QByteArray::fromStdString(tLine.m_originStr) << (quint32)tLine.m_tokens.size();
+
+            for (unsigned int t(0); t < tLine.m_tokens.size(); t++)
             {
-                m_finalBinary.binaryData[m_definedVars[i].range.begin + j] = m_definedVars[i].values[j].getValue();
+                stream << QByteArray::fromStdString(tLine.m_tokens[t].getSourceStr())
+                       << (quint32)tLine.m_tokens[t].getOriginColumnNb() << (quint32)tLine.m_tokens[t].getOriginLength();
             }
         }
-    }
 
-    return true;
-}
+        stream << (quint32)cachedFile.defines.size();
 
-// -- Utils --
-Token::TokenFile* Assembler::findTokenFile(QString fileName)
-{
-    for (unsigned int i(0); i < m_tokenFiles.size(); i++)
-    {
-        if (m_tokenFiles[i].m_fileName == fileName)
+        for (unsigned int d(0); d < cachedFile.defines.size(); d++)
         {
-            return &(m_tokenFiles[i]);
+            stream << QByteArray::fromStdString(cachedFile.defines[d].originalStr) << QByteArray::fromStdString(cachedFile.defines[d].replacementStr)
+                   << (quint32)cachedFile.defines[d].lineNbWhereDefined;
         }
     }
 
-    return nullptr;
+    if (!cacheFile.commit())
+        m_consoleOutput->log("Cannot write the assembly cache file: " + cacheFile.fileName().toStdString());
 }
 
-bool Assembler::variableAddressInferiorComparator(Variable a, Variable b)
+CachedFile* Assembler::findCachedFile(QString filePath, quint64 contentHash)
 {
-    return a.range.begin < b.range.begin;
-}
+    auto it = m_cachedFiles.find(filePath);
 
-bool Assembler::routineAddressInferiorComparator(RoutineBlock a, RoutineBlock b)
-{
-    return a.range.begin < b.range.begin;
-}
+    if (it == m_cachedFiles.end() || it->second.contentHash != contentHash)
+        return nullptr;
 
-bool Assembler::freeMemSpaceAddressInferiorComparator(MemorySpace a, MemorySpace b)
-{
-    return a.range.begin < b.range.begin;
+    return &(it->second);
 }
 
-bool Assembler::splitFreeMemorySpace(unsigned int freeMemorySpaceIndex, unsigned int definedVariableIndex)
+CachedFile* Assembler::storeCachedFile(QString filePath, quint64 contentHash, unsigned int tokensNb, const Token::TokenFile &tokenFile, const std::vector<Define> &fileDefines)
 {
-    if (freeMemorySpaceIndex >= m_freeMemorySpaces.size())
-        return false;
-
-    if (definedVariableIndex >= m_definedVars.size())
-        return false;
-
-    if (m_definedVars[definedVariableIndex].range.begin == m_freeMemorySpaces[freeMemorySpaceIndex].range.begin)
+    CachedFile &cachedFile = m_cachedFiles[filePath];
+
+    cachedFile.contentHash = contentHash;
+    cachedFile.tokensNb = tokensNb;
+    cachedFile.tokenFile = tokenFile;
+    cachedFile.defines = fileDefines;
+    cachedFile.variableNames.clear();
+    cachedFile.processed = false;
+    cachedFile.processedFile.m_lines.clear();
+
+    // A define can only replace tokens having the form of its name
+    for (unsigned int l(0); l < cachedFile.tokenFile.m_lines.size(); l++)
     {
-        if (m_definedVars[definedVariableIndex].range.end == m_freeMemorySpaces[freeMemorySpaceIndex].range.end)
-        {
-            // The data definition occupies all of the free memory space
-            m_freeMemorySpaces.erase(m_freeMemorySpaces.begin() + freeMemorySpaceIndex);
-        }
-        else
+        for (unsigned int t(0); t < cachedFile.tokenFile.m_lines[l].m_tokens.size(); t++)
         {
-            // It starts at the same address as a the free memory space, but leaves space after
-            m_freeMemorySpaces[freeMemorySpaceIndex].range.begin = m_definedVars[definedVariableIndex].range.end + 1;
-            //m_freeMemorySpaces[freeMemorySpaceIndex].size -= m_definedVars[definedVariableIndex].size;
-        }
-    }
-    else if (m_definedVars[definedVariableIndex].range.end == m_freeMemorySpaces[freeMemorySpaceIndex].range.end)
-    {
-        // It ends where the free memory space ends, but leaves space before
-        m_freeMemorySpaces[freeMemorySpaceIndex].range.end -= m_definedVars[definedVariableIndex].size;
-    }
-    else
-    {
-        // Is inside the free memory space without touching the borders (SPLIT)
-        MemorySpace newSpace;
-
-        newSpace.range.begin = m_definedVars[definedVariableIndex].range.end + 1;
-        newSpace.range.end = m_freeMemorySpaces[freeMemorySpaceIndex].range.end;
+            Token::TokenItem *token = &(cachedFile.tokenFile.m_lines[l].m_tokens[t]);
 
-        m_freeMemorySpaces.push_back(newSpace);
-
-        m_freeMemorySpaces[freeMemorySpaceIndex].range.end = m_definedVars[definedVariableIndex].range.begin - 1;
+            if (token->getType() == Token::TokenType::VAR)
+                cachedFile.variableNames.insert(token->getVariableName());
+        }
     }
 
-    // SORT FREE MEMORY SPACE BY ADDRESS IN ASCENDING ORDER
-    std::sort(m_freeMemorySpaces.begin(), m_freeMemorySpaces.end(), freeMemSpaceAddressInferiorComparator);
-
-    return true;
+    return &cachedFile;
 }
 
-bool Assembler::doRangeOverlap(MemoryRange a, MemoryRange b)
+quint64 Assembler::getDefinesKey(const CachedFile &cachedFile)
 {
-    if ((a.begin >= b.begin && a.begin <= b.end)
-     || (a.end   >= b.begin && a.end   <= b.end))
-    {
-        return true;
-    }
+    quint64 key(FNV_OFFSET_BASIS);
+    std::unordered_set<std::string> replacements; // A replacement is replaced again by the defines declared after it
 
-    if ((b.begin >= a.begin && b.begin <= a.end)
-     || (b.end   >= a.begin && b.end   <= a.end))
+    for (unsigned int i(0); i < m_defToProcess.size(); i++)
     {
-        return true;
+        const Define &def = m_defToProcess[i];
+
+        if (cachedFile.variableNames.count(def.originalStr) || replacements.count(def.originalStr))
+        {
+            // Hashing the terminating '\0' separates the strings
+            key = hash(def.originalStr.c_str(), def.originalStr.size() + 1, key);
+            key = hash(def.replacementStr.c_str(), def.replacementStr.size() + 1, key);
+
+            replacements.insert(def.replacementStr);
+        }
     }
 
-    return false;
+    return key;
 }
 
-uint32_t Assembler::getBinaryFromTokenLine(Token::TokenLine* line)
+quint64 Assembler::getPreprocessorKey()
 {
-    uint32_t finalBinary(0x00000000);
-    uint8_t byte1(0x00), byte2(0x00), byte3(0x00), byte4(0x00);
-    uint8_t opcode(0x00), addrMode(0x00);
-    uint8_t r1(0x00), r2(0x00), r3(0x00);
-    uint8_t v1(0x00), v2(0x00);
-    uint16_t vx(0x0000);
-    bool useR3(false), useVx(false);
-
-    // Populate arguments with addressing mode
-    switch (line->m_instr.m_addrMode)
-    {
-    case Cpu::AddressingMode::NONE: // INS
-        // No argument to populate
-        break;
-
-    case Cpu::AddressingMode::REG: // INS r | INS r, r
-        if (line->m_instr.m_opcode == Cpu::InstructionOpcode::DEC || line->m_instr.m_opcode == Cpu::InstructionOpcode::INC
-         || line->m_instr.m_opcode == Cpu::InstructionOpcode::NOT || line->m_instr.m_opcode == Cpu::InstructionOpcode::POP
-         || line->m_instr.m_opcode == Cpu::InstructionOpcode::PSH || line->m_instr.m_opcode == Cpu::InstructionOpcode::SHL
-         || line->m_instr.m_opcode == Cpu::InstructionOpcode::ASR || line->m_instr.m_opcode == Cpu::InstructionOpcode::SHR)
-        {
-            r1 = (uint8_t)line->m_tokens[1].getRegister();
-        }
-        else
-        {
-            r1 = (uint8_t)line->m_tokens[1].getRegister();
-            r2 = (uint8_t)line->m_tokens[2].getRegister();
-        }
-        break;
+    quint64 key(FNV_OFFSET_BASIS);
 
-    case Cpu::AddressingMode::REG_IMM8: // INS r, 0xXX
-        r1 = (uint8_t)line->m_tokens[1].getRegister();
-        v1 = line->m_tokens[2].getValue();
-        break;
+    // Hashing the terminating '\0' separates the strings
+    for (unsigned int i(0); i < m_defToProcess.size(); i++)
+    {
+        key = hash(m_defToProcess[i].originalStr.c_str(), m_defToProcess[i].originalStr.size() + 1, key);
+        key = hash(m_defToProcess[i].replacementStr.c_str(), m_defToProcess[i].replacementStr.size() + 1, key);
+    }
 
-    case Cpu::AddressingMode::REG_RAM: // INS r, $0xXXXX
-        if (line->m_instr.m_opcode == Cpu::InstructionOpcode::STR) // str $0xXXXX, r | $0xXXXX <- r
-        {
-            r1 = (uint8_t)line->m_tokens[2].getRegister();
-            vx = line->m_tokens[1].getAddress();
-        }
-        else
-        {
-            r1 = (uint8_t)line->m_tokens[1].getRegister();
-            vx = line->m_tokens[2].getAddress();
-        }
+    for (unsigned int i(0); i < m_macros.size(); i++)
+    {
+        Macro &macro = m_macros[i];
 
-        useVx = true;
-        break;
+        key = hash(macro.name.c_str(), macro.name.size() + 1, key);
 
-    case Cpu::AddressingMode::RAMREG_IMMREG: // INS r, [rr]
-        if (line->m_instr.m_opcode == Cpu::InstructionOpcode::STR) // str [rr], r | [rr] <- r
-        {
-            r1 = (uint8_t)line->m_tokens[1].getConcatRegs().msReg;
-            r2 = (uint8_t)line->m_tokens[1].getConcatRegs().lsReg;
+        for (unsigned int p(0); p < macro.parameters.size(); p++)
+            key = hash(macro.parameters[p].c_str(), macro.parameters[p].size() + 1, key);
 
-            r3 = (uint8_t)line->m_tokens[2].getRegister();
-        }
-        else
+        for (unsigned int l(0); l < macro.body.size(); l++)
         {
-            r1 = (uint8_t)line->m_tokens[2].getConcatRegs().msReg;
-            r2 = (uint8_t)line->m_tokens[2].getConcatRegs().lsReg;
+            key = hash("\n", 1, key);
 
-            r3 = (uint8_t)line->m_tokens[1].getRegister();
+            for (unsigned int t(0); t < macro.body[l].m_tokens.size(); t++)
+            {
+                std::string str(macro.body[l].m_tokens[t].getSourceStr());
+                key = hash(str.c_str(), str.size() + 1, key);
+            }
         }
-
-        useR3 = true;
-        break;
-
-    case Cpu::AddressingMode::REG16: // INS r, 0xXX
-        r1 = (uint8_t)line->m_tokens[1].getConcatRegs().msReg;
-        r2 = (uint8_t)line->m_tokens[1].getConcatRegs().lsReg;
-        break;
-
-    case Cpu::AddressingMode::IMM16: // INS 0xXXXX
-        vx = line->m_tokens[1].getAddress();
-
-        useVx = true;
-        break;
-
-    case Cpu::AddressingMode::IMM8: // INS 0xXX
-        v1 = line->m_tokens[1].getValue();
-        break;
     }
 
-    // Integrate binary data
-    opcode = (uint8_t)line->m_instr.m_opcode;
-    addrMode = (uint8_t)line->m_instr.m_addrMode;
-
-    byte1 = opcode << 2;
-    byte1 += (addrMode & 0xC) >> 2;
+    return key;
+}
 
-    byte2 = (addrMode & 0x3) << 6;
-    byte2 += (r1 & 0x7) << 3;
-    byte2 += (r2 & 0x7);
+quint64 Assembler::hash(const char *data, std::size_t size, quint64 previousHash)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+    quint64 result(previousHash);
 
-    if (useVx)
+    for (std::size_t i(0); i < size; i++)
     {
-        byte3 = (vx & 0xFF00) >> 8;
-        byte4 = (vx & 0x00FF);
+        result ^= bytes[i];
+        result *= 0x100000001B3;
     }
-    else
-    {
-        if (useR3)
-            byte3 = (r3 & 0x7);
-        else
-            byte3 = v1;
-
-        byte4 = v2;
-    }
-
-    finalBinary = ((uint32_t)byte1 << 24);
-    finalBinary += ((uint32_t)byte2 << 16);
-    finalBinary += ((uint32_t)byte3 << 8);
-    finalBinary += byte4;
 
-    return finalBinary;
+    return result;
 }
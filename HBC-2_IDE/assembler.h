@@ -9,9 +9,20 @@
  * \date 21/09/2023
  */
 #include <algorithm>
-#include "console.h"
-#include "projectManager.h"
+#include <functional>
+#include <map>
+#include <unordered_set>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "lineTable.h"
+#include "linker.h"
+#include "logOutput.h"
 #include "token.h"
+#include "memoryMap.h"
+#include "objectFile.h"
+#include "preprocessor.h"
+#include "symbolTable.h"
 
 /*!
  * \namespace Assembly
@@ -29,10 +40,22 @@ namespace Assembly
     {
         QString originFilePath;
         unsigned int originLineNb;
+        unsigned int originColumnNb; //!< 0 if the error is not located in the line
         Token::ErrorType type;
         std::string additionalInfo; //!< Used to display more information after an error in the console output
     };
 
+    /*!
+     * \struct Sources
+     * \brief Files of a project, as listed by Project or by <b>hbc2-as</b>
+     */
+    struct Sources
+    {
+        QString name;
+        QString path; //!< Project file, its directory holds the assembly cache
+        QList<QString> filesPaths; //!< One of them must be named "main.has"
+    };
+
     /*!
      * \struct Define
      * \brief Stores informations describing a define.
@@ -46,13 +69,45 @@ namespace Assembly
     };
 
     /*!
-     * \struct MemoryRange
-     * \brief First and last address (inclusive).
+     * \struct CachedFile
+     * \brief Results of the assembly of a file that do not depend on the other files
+     *
+     * Tokens and defines are saved in the project directory, the define-processed lines only live until the IDE is closed.
+     */
+    struct CachedFile
+    {
+        quint64 contentHash; //!< FNV-1a 64 bits hash of the file bytes
+        unsigned int tokensNb; //!< Tokens identified in the file, defines included
+        Token::TokenFile tokenFile; //!< Tokens without the define lines
+        std::vector<Define> defines; //!< Defines declared in the file
+        std::unordered_set<std::string> variableNames; //!< Names a define can replace in the file
+
+        bool processed = false; //!< <b>true</b> if processedFile is set
+        quint64 definesKey; //!< Hash of the defines used to produce processedFile
+        bool targetEeprom; //!< Memory target processedFile lines were checked for
+        Token::TokenFile processedFile; //!< Macros expanded, defines replaced, validity of every line checked (see TokenLine::m_err)
+    };
+
+    /*!
+     * \struct FileAssembly
+     * \brief State of a file during the passes run on all files at the same time
+     *
+     * Workers only write in the FileAssembly and TokenFile of their file, the Assembler reports their errors afterwards in the files order.
      */
-    struct MemoryRange
+    struct FileAssembly
     {
-        uint32_t begin; //!< Inclusive
-        uint32_t end; //!< Inclusive
+        enum class Stage { NONE, READ, TOKENS, DEFINES_LIST, DEFINES_PROCESS };
+
+        QString filePath;
+        quint64 contentHash = 0;
+        CachedFile *cachedFile = nullptr; //!< Entry of the file if unchanged since the last assembly
+        unsigned int tokensNb = 0;
+        std::vector<Define> defines; //!< Defines declared in the file
+        std::vector<Macro> macros; //!< Macros declared in the file
+        std::vector<unsigned int> preprocessorSites; //!< Lines the Preprocessor looks at, none for most files
+
+        Stage failedStage = Stage::NONE;
+        Error error = {}; //!< Set if failedStage is not NONE <i>(except READ)</i>
     };
 
     /*!
@@ -64,23 +119,13 @@ namespace Assembly
         std::string name;
         MemoryRange range;
         std::vector<Token::TokenItem> values; //!< Determined and checked before creation of the variable
-        uint32_t size; //!< Unlike MemorySpace and others, size may be undefined (for automatic address calculation), so it's not a function
+        uint32_t size; //!< Unlike RoutineBlock, size is stored because the range may be calculated later (automatic address calculation)
         Token::DataType type;
 
         QString originFile;
         unsigned originLineNb;
     };
 
-    /*!
-     * \struct MemorySpace
-     * \brief Range and size.
-     */
-    struct MemorySpace
-    {
-        MemoryRange range;
-        uint32_t size() { return range.end - range.begin + 1; } // 32-bit because it could hold an EEPROM 20-bit address
-    };
-
     /*!
      * \struct RoutineBlock
      * \brief Stores informations describing a routine (name, instructions, size and range).
@@ -97,24 +142,13 @@ namespace Assembly
         unsigned originLineNb;
     };
 
-    /*!
-     * \brief Debug symbol storing the original code file and line number
-     *
-     * Associated to the first byte of an instruction <b>only</b>
-     */
-    struct ByteDebugSymbol
-    {
-        QString filePath = "";
-        unsigned int lineNb = 0;
-    };
-
     /*!
      * \brief Final binary data with debug symbols
      */
     struct BinaryWithSymbols
     {
         QByteArray binaryData;
-        std::vector<ByteDebugSymbol> origin;
+        LineTable lines; //!< Source line of each instruction
     };
 
     /*!
@@ -133,9 +167,9 @@ namespace Assembly
             /*!
              * <i><b>SINGLETON:</b></i> Call this to instanciate the object (the constructor is private).
              *
-             * \param consoleOutput Pointer to Console
+             * \param consoleOutput Console of the IDE, or terminal of <b>hbc2-as</b>
              */
-            static Assembler* getInstance(Console *consoleOutput);
+            static Assembler* getInstance(LogOutput *consoleOutput);
 
             /*!
              * \return <b>true</b> if the assembly succeeded and binary data is available
@@ -172,39 +206,109 @@ namespace Assembly
              */
             std::vector<Word> getBreakpointsAddresses(std::vector<std::pair<QString, std::vector<int>>> filesBreakpoints);
 
+            /*!
+             * \return the error that stopped the last assembly <i>(type NONE if it succeeded)</i>
+             */
+            Error getLastError();
+
+            /*!
+             * \brief Sets the number of threads the files are assembled on
+             * \param threadsNb 0 selects one thread per core
+             */
+            void setThreadsNb(unsigned int threadsNb);
+
+            /*!
+             * \brief Sets how the variables without address are placed, FIRST_FIT by default
+             */
+            void setPlacementPolicy(PlacementPolicy policy);
+
             /*!
              * \brief Assembles the project and returns true it succeeded.
              *
-             * Prompts in the console output statistics and error (if any).
+             * Prompts in the console output statistics and error (if any).<br>
+             * The project is assembled to an object, then linked alone: see assembleObject() and linkObjects().
              *
-             * \param p Pointer to the project to assemble
+             * \param sources Files of the project to assemble
              * \param targetEeprom Boolean selecting if the binary will be 64 KiB (RAM) or 1 MiB (EEPROM)
+             * \param incremental Reuses the tokens of the files unchanged since the last assembly, and the checks
+             * of the lines whose defines did not change either <i>(see CachedFile)</i>
+             */
+            bool assembleProject(const Sources &sources, bool targetEeprom, bool incremental = false);
+
+            /*!
+             * \brief Assembles the project to a relocatable object, without placing its routines and variables
+             *
+             * A project without "_start" routine can be assembled this way, to be linked into other projects.
+             *
+             * \param sources Files of the project to assemble
+             * \param targetEeprom Memory the fixed addresses are checked for
+             * \param incremental See assembleProject()
+             */
+            bool assembleObject(const Sources &sources, bool targetEeprom, bool incremental = false);
+
+            /*!
+             * \return the object of the last assembly, valid if assembleObject() succeeded
+             */
+            ObjectFile getObject();
+
+            /*!
+             * \brief Links objects into the binary, available as after assembleProject() if it succeeded
+             *
+             * \param objects Placed in that order <i>(see Linker)</i>, one of them must have the "_start" routine
+             * \param targetEeprom Every object must have been assembled for that memory
              */
-            bool assembleProject(std::shared_ptr<Project> p, bool targetEeprom);
+            bool linkObjects(const std::vector<const ObjectFile*> &objects, bool targetEeprom);
 
         private:
-            Assembler(Console *consoleOutput);
+            Assembler(LogOutput *consoleOutput);
 
             // Methods
-            Token::TokenFile retrieveContent(QString filePath);
+            bool readContent(QString filePath, QByteArray &content);
+            Token::TokenFile retrieveContent(QString filePath, const QByteArray &content);
             void logError();
-            void initBinary(bool targetEeprom);
+
+            // Passes run for each file on a thread pool
+            void prepareFile(FileAssembly &file, Token::TokenFile &tFile, bool incremental); //!< Reads the file, converts it to tokens and extracts its defines and macros
+            void processFile(FileAssembly &file, Token::TokenFile &tFile, bool targetEeprom, bool incremental); //!< Expands the macros, replaces the defines and checks the validity of the lines
+            void runOnFiles(const std::function<void(unsigned int)> &job, const std::vector<qint64> &filesWeights); //!< Calls <i>job</i> for each file index and waits
 
             // Major pass 1 = TOKENS GENERATION
-            void replaceTabsBySpaces(Token::TokenFile &f);
-            void removeComments(Token::TokenFile &f);
-            void removeEmptyLines(Token::TokenFile &f);
-            void fixIndentation(Token::TokenFile &f);
-            bool convertToTokens(Token::TokenFile &f);
+            /*!
+             * \brief Converts the lines of a file to tokens, and removes the lines without any
+             *
+             * Each line is read once: comments, tabs and unnecessary spaces are removed while it is copied,
+             * then the copy is split in tokens located in the source line.
+             */
+            bool tokenizeFile(Token::TokenFile &f, unsigned int &tokensNb, Error &error);
+
+            /*!
+             * \brief Copies a line without its comment, its leading and trailing spaces and the spaces around commas
+             *
+             * Tabs are handled like spaces, and any sequence of spaces (even in a string) becomes a single one.
+             *
+             * \param inbetweenQuotation Kept from one line to the next, like the commas between quotes it protects
+             * \param columns Receives the column in the source line of each character of <i>normalized</i>
+             */
+            void normalizeLine(const std::string &source, std::string &normalized, std::vector<unsigned int> &columns, bool &inbetweenQuotation);
+
+            /*!
+             * \brief Splits a normalized line in tokens, at spaces, commas and strings
+             * \param firstLabelFound Kept from one line to the next, an instruction cannot come before the first label of a file
+             */
+            bool tokenizeLine(Token::TokenLine &tLine, const std::vector<unsigned int> &columns, bool &firstLabelFound, unsigned int &tokensNb, Error &error);
+
+            static bool tokenError(const Token::TokenLine &tLine, Token::ErrorType type, unsigned int columnNb, Error &error); //!< Fills <i>error</i>, always returns <b>false</b>
 
             // Major pass 2 = MACROS
-            bool listDefines(Token::TokenFile &f);
-            bool processDefines();
+            bool listDefines(Token::TokenFile &f, std::vector<Define> &fileDefines, Error &error); //!< Removes the define lines of the file and moves them to <i>fileDefines</i>
+            bool registerDefines(const std::vector<Define> &fileDefines);
+            bool registerMacros(const std::vector<Macro> &fileMacros);
+            bool processDefines(Token::TokenFile &f, Error &error);
             bool processIncludes();
             bool processIncludesInFile(Token::TokenFile &f);
 
             // Major pass 3 = ARGUMENT VALIDITY
-            bool checkArgumentsValidity(bool targetEeprom);
+            bool checkArgumentsValidity(); //!< Reports the first error found by TokenLine::checkValidity() in prepareFile(), in the order of the final file
 
             // Major pass 4 = DATA ANALYSIS
             bool listVariables(bool targetEeprom);
@@ -212,25 +316,32 @@ namespace Assembly
 
             // Major pass 5 = LABEL ANALYSIS
             bool constructRoutineBlocks(bool targetEeprom);
-            bool calculateRoutineBlocksAddresses();
 
-            // Major pass 6 = DATA PROCESS
-            bool findFreeMemorySpaces(bool targetEeprom);
-            bool calculateVariablesAddresses();
-            bool replaceVariablesByAddresses();
-
-            // Major pass 7 = BINARY CONVERSION
-            bool convertTokensToBinary();
-            bool convertDataToBinary();
+            // Major pass 6 = OBJECT GENERATION
+            /*!
+             * \brief Converts the routine blocks and the variables to the sections of m_object
+             *
+             * Addresses of variables and labels are left to the Linker as relocations, their field is encoded as 0.
+             */
+            bool generateObject(const Sources &sources, bool targetEeprom);
 
             // Utils
             Token::TokenFile* findTokenFile(QString fileName);
-            static bool variableAddressInferiorComparator(Variable a, Variable b);
-            static bool routineAddressInferiorComparator(RoutineBlock a, RoutineBlock b);
-            static bool freeMemSpaceAddressInferiorComparator(MemorySpace a, MemorySpace b);
-            bool splitFreeMemorySpace(unsigned int freeMemorySpaceIndex, unsigned int definedVariableIndex);
-            bool doRangeOverlap(MemoryRange a, MemoryRange b);
-            uint32_t getBinaryFromTokenLine(Token::TokenLine* line);
+            uint32_t getBinaryFromTokenLine(Token::TokenLine* line, uint32_t offset, Section &section); //!< Adds the relocations of the line to <i>section</i>
+
+            // Incremental assembly
+            void loadCache(QString projectDirPath);
+            void saveCache();
+            CachedFile* findCachedFile(QString filePath, quint64 contentHash); //!< Returns nullptr if the file changed or is not cached
+            CachedFile* storeCachedFile(QString filePath, quint64 contentHash, unsigned int tokensNb, const Token::TokenFile &tokenFile, const std::vector<Define> &fileDefines);
+            quint64 getDefinesKey(const CachedFile &cachedFile); //!< Hashes the defines that can modify the tokens of the file, in declaration order
+            quint64 getPreprocessorKey(); //!< Hashes all defines and macros, any of them can modify a file using the Preprocessor
+            static quint64 hash(const char *data, std::size_t size, quint64 previousHash = FNV_OFFSET_BASIS); //!< FNV-1a 64 bits
+
+            static constexpr quint64 FNV_OFFSET_BASIS = 0xCBF29CE484222325;
+            static constexpr quint32 CACHE_FORMAT_VERSION = 2; //!< Increment when the saved tokens or the tokenization rules change
+            static constexpr char CACHE_DIRECTORY_NAME[] = "cache"; //!< Subdirectory of the project
+            static constexpr char CACHE_FILE_NAME[] = "tokens.hbcc";
 
             // Attributes
             QList<QString> m_filesPaths;
@@ -239,10 +350,18 @@ namespace Assembly
 
             std::vector<QString> m_includedFiles;
             std::vector<Define> m_defToProcess;
+            std::vector<Macro> m_macros;
+            quint64 m_preprocessorKey;
             std::vector<Variable> m_undefinedVars;
             std::vector<Variable> m_definedVars;
-            std::vector<MemorySpace> m_freeMemorySpaces;
             std::vector<RoutineBlock> m_routineBlocks;
+            SymbolTable m_symbols; //!< Names of the defines, macros, variables and routine blocks
+
+            std::map<QString, CachedFile> m_cachedFiles; //!< By file path
+            QString m_cacheDirPath; //!< Project directory m_cachedFiles belongs to
+
+            ObjectFile m_object;
+            Linker m_linker;
 
             BinaryWithSymbols m_finalBinary;
             bool m_binaryReady;
@@ -251,12 +370,14 @@ namespace Assembly
             unsigned int m_totalTokenCount;
             unsigned int m_variablesCount;
             unsigned int m_dataMemoryUse;
-            unsigned int m_totalMemoryUse;
+            unsigned int m_totalMemoryUse; //!< Of the project, the Linker counts the linked objects
             unsigned int m_routineBlocksCount;
 
             Error m_error;
+            unsigned int m_threadsNb;
+            PlacementPolicy m_placementPolicy;
 
-            Console *m_consoleOutput;
+            LogOutput *m_consoleOutput;
     };
 }
 
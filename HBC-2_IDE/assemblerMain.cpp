@@ -0,0 +1,21 @@
+/*!
+ * \file assemblerMain.cpp
+ * \brief Entry point of <b>hbc2-as</b>, the assembler without the IDE
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <QCoreApplication>
+
+#include "commandLineAssembler.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("hbc2-as");
+    QCoreApplication::setApplicationVersion("0.1");
+
+    CommandLineAssembler commandLineAssembler;
+
+    return commandLineAssembler.run(QCoreApplication::arguments());
+}
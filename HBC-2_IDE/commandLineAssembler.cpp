@@ -0,0 +1,534 @@
+#include "commandLineAssembler.h"
+
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <cstdio>
+
+// === TERMINAL OUTPUT CLASS ===
+
+// PUBLIC
+TerminalOutput::TerminalOutput(bool verbose)
+{
+    m_verbose = verbose;
+}
+
+void TerminalOutput::log(std::string line)
+{
+    if (m_verbose)
+        std::fprintf(stdout, "%s\n", line.c_str());
+}
+
+void TerminalOutput::returnLine()
+{
+    if (m_verbose)
+        std::fprintf(stdout, "\n");
+}
+
+void TerminalOutput::clearLog()
+{ }
+
+
+// === COMMAND LINE ASSEMBLER CLASS ===
+
+// PUBLIC
+int CommandLineAssembler::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Assembles HBC-2 projects or source files to RAM or EEPROM images");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("inputs", "One or more projects (.hbprj), or the source files (.has) of a single program, one of them named main.has, "
+                                           "and the objects (.hbo) linked into every image", "<project.hbprj...|file.has...> [object.hbo...]");
+
+    QCommandLineOption outputOption({ "o", "output" }, "Image file, by default next to the project (\"rom/<name>.bin\" for the EEPROM)", "file");
+    QCommandLineOption symbolsOption({ "s", "symbols" }, "Debug symbols file, by default the image file with the \".sym\" extension", "file");
+    QCommandLineOption symbolsFormatOption("symbols-format", "Debug symbols file format: \"binary\" (line table, see LineTable) or \"text\"", "format", "binary");
+    QCommandLineOption eepromOption({ "e", "eeprom" }, "Assemble for the EEPROM instead of the RAM");
+    QCommandLineOption objectOption({ "c", "object" }, "Assemble to a relocatable object (.hbo) instead of an image, a \"_start\" routine is not needed");
+    QCommandLineOption jobsOption({ "j", "jobs" }, "Threads assembling the files of a project, 0 for one per core", "n", "0");
+    QCommandLineOption placementOption("placement", "Placement of the variables without address: \"first-fit\" (as the IDE) or \"best-fit\" (tighter)", "policy", "first-fit");
+    QCommandLineOption incrementalOption("incremental", "Reuse the tokens of the files unchanged since the last assembly");
+    QCommandLineOption diagnosticsOption("diagnostics", "Errors and warnings format on the standard error output: \"text\" or \"json\"", "format", "text");
+    QCommandLineOption verboseOption({ "v", "verbose" }, "Print the progress of the assembler");
+
+    parser.addOptions({ outputOption, symbolsOption, symbolsFormatOption, eepromOption, objectOption, jobsOption, placementOption, incrementalOption, diagnosticsOption, verboseOption });
+
+    if (!parser.parse(arguments))
+    {
+        reportError(parser.errorText());
+        return INVALID_USAGE;
+    }
+
+    if (parser.isSet("help"))
+    {
+        std::fprintf(stdout, "%s", parser.helpText().toStdString().c_str());
+        return SUCCESS;
+    }
+
+    if (parser.isSet("version"))
+        parser.showVersion(); // Exits the process
+
+    QString diagnostics(parser.value(diagnosticsOption));
+
+    if (diagnostics != "text" && diagnostics != "json")
+    {
+        reportError("Unknown diagnostics format \"" + diagnostics + "\"");
+        return INVALID_USAGE;
+    }
+
+    m_jsonDiagnostics = (diagnostics == "json");
+
+    bool jobsValid(false);
+    unsigned int threadsNb(parser.value(jobsOption).toUInt(&jobsValid));
+
+    if (!jobsValid)
+    {
+        reportError("Invalid number of jobs \"" + parser.value(jobsOption) + "\"");
+        return INVALID_USAGE;
+    }
+
+    QString symbolsFormat(parser.value(symbolsFormatOption));
+
+    if (symbolsFormat != "binary" && symbolsFormat != "text")
+    {
+        reportError("Unknown debug symbols format \"" + symbolsFormat + "\"");
+        return INVALID_USAGE;
+    }
+
+    QString placement(parser.value(placementOption));
+
+    if (placement != "first-fit" && placement != "best-fit")
+    {
+        reportError("Unknown placement policy \"" + placement + "\"");
+        return INVALID_USAGE;
+    }
+
+    // Inputs are either projects, or the files of a single program, and the objects linked with them
+    QStringList inputs, objectsPaths;
+    std::vector<Assembly::Sources> programs;
+    unsigned int projectsNb(0);
+
+    for (const QString &input : parser.positionalArguments())
+    {
+        if (input.endsWith(".hbo"))
+            objectsPaths.push_back(input);
+        else
+            inputs.push_back(input);
+    }
+
+    if (inputs.isEmpty() && objectsPaths.isEmpty())
+    {
+        reportError("No input, see --help");
+        return INVALID_USAGE;
+    }
+
+    for (const QString &input : inputs)
+    {
+        if (input.endsWith(".hbprj"))
+            projectsNb++;
+    }
+
+    if (projectsNb != 0 && projectsNb != (unsigned int)inputs.count())
+    {
+        reportError("Projects and source files cannot be mixed");
+        return INVALID_USAGE;
+    }
+
+    if (projectsNb > 1 && (parser.isSet(outputOption) || parser.isSet(symbolsOption)))
+    {
+        reportError("--output and --symbols need a single project");
+        return INVALID_USAGE;
+    }
+
+    bool objectOutput(parser.isSet(objectOption));
+
+    if (objectOutput && (inputs.isEmpty() || !objectsPaths.isEmpty()))
+    {
+        reportError("--object needs projects or source files, and no object");
+        return INVALID_USAGE;
+    }
+
+    if (objectOutput && parser.isSet(symbolsOption))
+    {
+        reportError("--symbols cannot be used with --object, the line table is stored in the object");
+        return INVALID_USAGE;
+    }
+
+    bool targetEeprom(parser.isSet(eepromOption));
+
+    // Objects are read once, then linked into every image
+    std::vector<Assembly::ObjectFile> libraries(objectsPaths.count());
+
+    for (int i(0); i < objectsPaths.count(); i++)
+    {
+        if (!readObject(objectsPaths[i], libraries[i]))
+            return IO_ERROR;
+    }
+
+    if (projectsNb != 0)
+    {
+        for (const QString &input : inputs)
+        {
+            Assembly::Sources sources;
+
+            if (!readProjectFile(input, sources))
+                return IO_ERROR;
+
+            programs.push_back(sources);
+        }
+    }
+    else if (!inputs.isEmpty())
+    {
+        Assembly::Sources sources;
+        sources.name = "main";
+
+        for (const QString &input : inputs)
+        {
+            if (!QFileInfo::exists(input))
+            {
+                reportError("Cannot find source file \"" + input + "\"");
+                return IO_ERROR;
+            }
+
+            QString filePath(QFileInfo(input).absoluteFilePath());
+
+            if (QFileInfo(filePath).fileName() == "main.has")
+                sources.path = filePath; // Its directory holds the cache
+
+            sources.filesPaths.push_back(filePath);
+        }
+
+        if (sources.path.isEmpty())
+            sources.path = sources.filesPaths.front();
+
+        programs.push_back(sources);
+    }
+
+    // Assembly
+    TerminalOutput output(parser.isSet(verboseOption));
+    Assembly::Assembler *assembler(Assembly::Assembler::getInstance(&output));
+    int result(SUCCESS);
+
+    assembler->setThreadsNb(threadsNb);
+    assembler->setPlacementPolicy((placement == "best-fit") ? Assembly::PlacementPolicy::BEST_FIT : Assembly::PlacementPolicy::FIRST_FIT);
+
+    std::vector<const Assembly::ObjectFile*> objects;
+
+    for (const Assembly::ObjectFile &library : libraries)
+        objects.push_back(&library);
+
+    if (programs.empty()) // Only objects: a single image
+    {
+        QString imagePath(parser.isSet(outputOption) ? parser.value(outputOption) : libraries.front().name + ".bin");
+        QString symbolsPath(parser.isSet(symbolsOption) ? parser.value(symbolsOption)
+                                                        : QFileInfo(imagePath).path() + "/" + QFileInfo(imagePath).completeBaseName() + ".sym");
+
+        if (!assembler->linkObjects(objects, targetEeprom))
+        {
+            reportError(assembler->getLastError());
+            return ASSEMBLY_FAILED;
+        }
+
+        Assembly::BinaryWithSymbols binary(assembler->getBinaryDataWithSymbols());
+
+        if (!writeImage(binary.binaryData, imagePath) || !writeSymbols(binary, symbolsPath, targetEeprom, symbolsFormat == "text"))
+            return IO_ERROR;
+
+        return SUCCESS;
+    }
+
+    for (const Assembly::Sources &sources : programs)
+    {
+        QString imagePath, symbolsPath;
+
+        if (parser.isSet(outputOption))
+            imagePath = parser.value(outputOption);
+        else if (projectsNb == 0)
+            imagePath = sources.name + (objectOutput ? ".hbo" : ".bin");
+        else if (targetEeprom)
+            imagePath = QFileInfo(sources.path).path() + "/rom/" + sources.name + (objectOutput ? ".hbo" : ".bin"); // Same as the IDE
+        else
+            imagePath = QFileInfo(sources.path).path() + "/" + sources.name + (objectOutput ? ".hbo" : ".bin");
+
+        if (parser.isSet(symbolsOption))
+            symbolsPath = parser.value(symbolsOption);
+        else
+            symbolsPath = QFileInfo(imagePath).path() + "/" + QFileInfo(imagePath).completeBaseName() + ".sym";
+
+        if (!assembler->assembleObject(sources, targetEeprom, parser.isSet(incrementalOption)))
+        {
+            reportError(assembler->getLastError());
+            result = ASSEMBLY_FAILED;
+            continue; // Next projects are still assembled, all their errors are reported
+        }
+
+        Assembly::ObjectFile object(assembler->getObject());
+
+        if (objectOutput)
+        {
+            if (!writeObject(object, imagePath))
+                return IO_ERROR;
+
+            continue;
+        }
+
+        // The program first: its routines without address follow "_start", as without objects
+        objects.insert(objects.begin(), &object);
+
+        bool linked(assembler->linkObjects(objects, targetEeprom));
+
+        objects.erase(objects.begin());
+
+        if (!linked)
+        {
+            reportError(assembler->getLastError());
+            result = ASSEMBLY_FAILED;
+            continue;
+        }
+
+        Assembly::BinaryWithSymbols binary(assembler->getBinaryDataWithSymbols());
+
+        if (!writeImage(binary.binaryData, imagePath) || !writeSymbols(binary, symbolsPath, targetEeprom, symbolsFormat == "text"))
+            return IO_ERROR;
+    }
+
+    return result;
+}
+
+
+// PRIVATE
+bool CommandLineAssembler::readProjectFile(const QString &projectPath, Assembly::Sources &sources)
+{
+    QFile xmlFile(projectPath);
+    QDomDocument document;
+
+    if (!xmlFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        reportError("Cannot open project file \"" + projectPath + "\"");
+        return false;
+    }
+
+    if (!document.setContent(&xmlFile))
+    {
+        reportError("Cannot parse project file \"" + projectPath + "\"");
+        return false;
+    }
+
+    QDomNode root = document.firstChildElement(); // <project name="SOMETHING">
+
+    if (root.nodeName() != "project")
+    {
+        reportError("Invalid project file \"" + projectPath + "\"");
+        return false;
+    }
+
+    sources.name = QFileInfo(projectPath).baseName();
+    sources.path = QFileInfo(projectPath).absoluteFilePath();
+    sources.filesPaths.clear();
+
+    listProjectFiles(root, QFileInfo(sources.path).path(), sources);
+
+    return true;
+}
+
+void CommandLineAssembler::listProjectFiles(const QDomNode &node, const QString &path, Assembly::Sources &sources)
+{
+    for (int i(0); i < node.childNodes().count(); i++)
+    {
+        QDomNode child(node.childNodes().at(i));
+        QString name(child.attributes().namedItem("name").nodeValue());
+
+        if (name.isEmpty())
+            continue;
+
+        if (child.nodeName() == "folder")
+        {
+            if (QDir(path + "/" + name).exists())
+                listProjectFiles(child, path + "/" + name, sources);
+            else
+                reportWarning("Folder \"" + path + "/" + name + "\" not found, skipped");
+        }
+        else if (child.nodeName() == "file")
+        {
+            if (!name.contains(".has"))
+                name += ".has";
+
+            if (QFileInfo::exists(path + "/" + name))
+                sources.filesPaths.push_back(path + "/" + name);
+            else
+                reportWarning("File \"" + path + "/" + name + "\" not found, skipped");
+        }
+    }
+}
+
+bool CommandLineAssembler::readObject(const QString &objectPath, Assembly::ObjectFile &object)
+{
+    QFile objectFile(objectPath);
+
+    if (!objectFile.open(QIODevice::ReadOnly))
+    {
+        reportError("Cannot open object file \"" + objectPath + "\"");
+        return false;
+    }
+
+    QDataStream stream(&objectFile);
+
+    if (!object.read(stream))
+    {
+        reportError("Invalid object file \"" + objectPath + "\", or assembled by another version");
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandLineAssembler::writeObject(const Assembly::ObjectFile &object, const QString &objectPath)
+{
+    QDir().mkpath(QFileInfo(objectPath).path());
+
+    QSaveFile objectFile(objectPath);
+
+    if (!objectFile.open(QIODevice::WriteOnly))
+    {
+        reportError("Cannot write object file \"" + objectPath + "\"");
+        return false;
+    }
+
+    QDataStream stream(&objectFile);
+
+    object.write(stream);
+
+    if (!objectFile.commit())
+    {
+        reportError("Cannot write object file \"" + objectPath + "\"");
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandLineAssembler::writeImage(const QByteArray &data, const QString &imagePath)
+{
+    QDir().mkpath(QFileInfo(imagePath).path());
+
+    QSaveFile imageFile(imagePath);
+
+    if (!imageFile.open(QIODevice::WriteOnly)
+     || imageFile.write(data) != data.size()
+     || !imageFile.commit())
+    {
+        reportError("Cannot write image file \"" + imagePath + "\"");
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandLineAssembler::writeSymbols(const Assembly::BinaryWithSymbols &binary, const QString &symbolsPath, bool targetEeprom, bool text)
+{
+    QSaveFile symbolsFile(symbolsPath);
+
+    if (!symbolsFile.open(text ? (QIODevice::WriteOnly | QIODevice::Text) : QIODevice::WriteOnly))
+    {
+        reportError("Cannot write debug symbols file \"" + symbolsPath + "\"");
+        return false;
+    }
+
+    if (text)
+    {
+        QTextStream stream(&symbolsFile);
+        int addressDigits(targetEeprom ? 5 : 4); // 20-bit or 16-bit addresses
+        uint32_t address;
+
+        for (std::size_t i(0); i < binary.lines.size(); i++)
+        {
+            Assembly::ByteDebugSymbol symbol(binary.lines.at(i, address));
+
+            stream << "0x" << QString::number(address, 16).toUpper().rightJustified(addressDigits, '0') << "\t"
+                   << symbol.lineNb << "\t"
+                   << symbol.filePath << "\n";
+        }
+
+        stream.flush();
+    }
+    else
+    {
+        QDataStream stream(&symbolsFile);
+
+        binary.lines.write(stream);
+    }
+
+    if (!symbolsFile.commit())
+    {
+        reportError("Cannot write debug symbols file \"" + symbolsPath + "\"");
+        return false;
+    }
+
+    return true;
+}
+
+void CommandLineAssembler::reportError(const Assembly::Error &error)
+{
+    QString message(QString::fromStdString(Token::errStr[(int)error.type] + error.additionalInfo));
+
+    if (m_jsonDiagnostics)
+    {
+        QJsonObject diagnostic;
+
+        diagnostic["severity"] = "error";
+        diagnostic["file"] = error.originFilePath;
+        diagnostic["line"] = (int)error.originLineNb;
+        diagnostic["column"] = (int)error.originColumnNb;
+        diagnostic["code"] = (int)error.type; // Token::ErrorType
+        diagnostic["message"] = message;
+
+        std::fprintf(stderr, "%s\n", QJsonDocument(diagnostic).toJson(QJsonDocument::Compact).constData());
+    }
+    else if (error.originFilePath.isEmpty())
+    {
+        std::fprintf(stderr, "hbc2-as: error: %s\n", message.toStdString().c_str());
+    }
+    else
+    {
+        QString location(error.originFilePath + ":" + QString::number(error.originLineNb));
+
+        if (error.originColumnNb != 0)
+            location += ":" + QString::number(error.originColumnNb);
+
+        std::fprintf(stderr, "%s: error: %s\n", location.toStdString().c_str(), message.toStdString().c_str());
+    }
+}
+
+void CommandLineAssembler::reportError(const QString &message)
+{
+    reportMessage("error", message);
+}
+
+void CommandLineAssembler::reportWarning(const QString &message)
+{
+    reportMessage("warning", message);
+}
+
+void CommandLineAssembler::reportMessage(const char *severity, const QString &message)
+{
+    if (m_jsonDiagnostics)
+    {
+        QJsonObject diagnostic;
+
+        diagnostic["severity"] = severity;
+        diagnostic["message"] = message;
+
+        std::fprintf(stderr, "%s\n", QJsonDocument(diagnostic).toJson(QJsonDocument::Compact).constData());
+    }
+    else
+        std::fprintf(stderr, "hbc2-as: %s: %s\n", severity, message.toStdString().c_str());
+}
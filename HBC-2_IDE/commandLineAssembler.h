@@ -0,0 +1,88 @@
+#ifndef COMMANDLINEASSEMBLER_H
+#define COMMANDLINEASSEMBLER_H
+
+/*!
+ * \file commandLineAssembler.h
+ * \brief Headless assembler <b>hbc2-as</b>, for build scripts and continuous integration
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <QDomNode>
+#include <QStringList>
+#include "assembler.h"
+
+/*!
+ * \class TerminalOutput
+ * \brief Prints the progress of the assembler on the standard output, only if <i>verbose</i> is set
+ *
+ * Errors are not printed here but as diagnostics on the standard error output, see CommandLineAssembler.
+ */
+class TerminalOutput : public LogOutput
+{
+    public:
+        TerminalOutput(bool verbose);
+
+        void log(std::string line) override;
+        void returnLine() override;
+        void clearLog() override;
+
+    private:
+        bool m_verbose;
+};
+
+/*!
+ * \class CommandLineAssembler
+ * \brief Assembles projects or source files to binary images, as the IDE does
+ *
+ * Usage: <i>hbc2-as [options] project.hbprj...</i> or <i>hbc2-as [options] main.has other.has...</i><br>
+ * The image is the raw memory content (64 KB for the RAM, 1 MB for the EEPROM), byte for byte what the IDE produces.<br>
+ * The debug symbols file is the serialized Assembly::LineTable, or with "--symbols-format text" one instruction per line:
+ * <i>address</i>, <i>line number</i> and <i>file path</i>, separated by tabs.
+ *
+ * With "--object", each program is written as a serialized Assembly::ObjectFile instead. The ".hbo" inputs are linked
+ * after the program into every image <i>(see Assembly::Linker)</i>, or alone into one image if there is no program.
+ */
+class CommandLineAssembler
+{
+    public:
+        /*!
+         * \enum ExitCode
+         * \brief Process exit status, distinct for each kind of failure
+         */
+        enum ExitCode { SUCCESS = 0, ASSEMBLY_FAILED = 1, INVALID_USAGE = 2, IO_ERROR = 3 };
+
+        /*!
+         * \brief Parses the command line, assembles every project and writes the outputs
+         * \return an ExitCode
+         */
+        int run(const QStringList &arguments);
+
+    private:
+        /*!
+         * \brief Lists the files of a ".hbprj" project, in the order of the IDE
+         *
+         * Missing files and folders are skipped with a warning, as the IDE removes them when opening the project.
+         */
+        bool readProjectFile(const QString &projectPath, Assembly::Sources &sources);
+        void listProjectFiles(const QDomNode &node, const QString &path, Assembly::Sources &sources);
+
+        bool readObject(const QString &objectPath, Assembly::ObjectFile &object);
+        bool writeObject(const Assembly::ObjectFile &object, const QString &objectPath);
+        bool writeImage(const QByteArray &data, const QString &imagePath);
+        bool writeSymbols(const Assembly::BinaryWithSymbols &binary, const QString &symbolsPath, bool targetEeprom, bool text);
+
+        /*!
+         * \brief Prints the error on the standard error output
+         *
+         * Formatted as <i>file:line:column: error: message</i>, or as a JSON object on a single line with "--diagnostics json".
+         */
+        void reportError(const Assembly::Error &error);
+        void reportError(const QString &message); //!< Error not located in a source file
+        void reportWarning(const QString &message); //!< Same format as reportError(), never stops the assembly
+        void reportMessage(const char *severity, const QString &message);
+
+        bool m_jsonDiagnostics = false;
+};
+
+#endif // COMMANDLINEASSEMBLER_H
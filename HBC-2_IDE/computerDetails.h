@@ -9,6 +9,8 @@
  * \date 27/08/2023
  */
 #include <string>
+#include <string_view>
+#include <array>
 #include <QString>
 #include <QMutex>
 
@@ -16,6 +18,20 @@ using Byte = uint8_t;
 using Word = uint16_t;
 using Dword = uint32_t;
 
+/*!
+ * \brief Copies constant names to std::string, for the code concatenating them
+ */
+template<std::size_t N>
+std::array<std::string, N> toStringArray(const std::string_view (&names)[N])
+{
+    std::array<std::string, N> strings;
+
+    for (std::size_t i(0); i < N; i++)
+        strings[i] = std::string(names[i]);
+
+    return strings;
+}
+
 /*!
  * \namespace Cpu
  *
@@ -51,7 +67,8 @@ namespace Cpu
      * \brief See Cpu::REGISTERS_NB
      */
     enum class Register { A = 0, B = 1, C = 2, D = 3, I = 4, J = 5, X = 6, Y = 7 };
-    const std::string regStrArr[] = { "a", "b", "c", "d", "i", "j", "x", "y" };
+    constexpr std::string_view regNames[] = { "a", "b", "c", "d", "i", "j", "x", "y" }; //!< Usable at compile time (see Token::Keywords)
+    const std::array<std::string, REGISTERS_NB> regStrArr = toStringArray(regNames);
 
     enum class Flags { CARRY = 0, EQUAL = 1, INTERRUPT = 2, NEGATIVE = 3, SUPERIOR = 4, ZERO = 5, INFERIOR = 6, HALT = 7 };
 
@@ -61,12 +78,13 @@ namespace Cpu
                                    STR = 27, LOD = 28, MOV = 29, NOT = 30, OR  = 31, POP = 32, PSH = 33, RET = 34, SHL = 35,
                                    ASR = 36, SHR = 37, STC = 38, STE = 39, STI = 40, STN = 41, STS = 42, STZ = 43, STF = 44,
                                    SUB = 45, SBB = 46, XOR = 47 };
-    const std::string instrStrArr[] = { "nop", "adc", "add", "and", "cal", "clc", "cle", "cli", "cln",
-                                        "cls", "clz", "clf", "cmp", "dec", "hlt", "in",  "out", "inc",
-                                        "int", "irt", "jmc", "jme", "jmn", "jmp", "jms", "jmz", "jmf",
-                                        "str", "lod", "mov", "not", "or",  "pop", "psh", "ret", "shl",
-                                        "asr", "shr", "stc", "ste", "sti", "stn", "sts", "stz", "stf",
-                                        "sub", "sbb", "xor" };
+    constexpr std::string_view instrNames[] = { "nop", "adc", "add", "and", "cal", "clc", "cle", "cli", "cln",
+                                                "cls", "clz", "clf", "cmp", "dec", "hlt", "in",  "out", "inc",
+                                                "int", "irt", "jmc", "jme", "jmn", "jmp", "jms", "jmz", "jmf",
+                                                "str", "lod", "mov", "not", "or",  "pop", "psh", "ret", "shl",
+                                                "asr", "shr", "stc", "ste", "sti", "stn", "sts", "stz", "stf",
+                                                "sub", "sbb", "xor" }; //!< Usable at compile time (see Token::Keywords)
+    const std::array<std::string, INSTRUCTIONS_NB> instrStrArr = toStringArray(instrNames);
 
     enum class AddressingMode { NONE = 0, REG = 1, REG_IMM8 = 2, REG_RAM = 3,
                                 RAMREG_IMMREG = 4, REG16 = 5, IMM16 = 6, IMM8 = 7 };
@@ -120,6 +138,16 @@ namespace Ram
     constexpr int MEMORY_SIZE = 0x10000; //!< 65,536 bytes
 }
 
+/*!
+ * \namespace Eeprom
+ *
+ * EEPROM memory size, the device itself is described in eeprom.h.
+ */
+namespace Eeprom
+{
+    constexpr int MEMORY_SIZE = 0x100000; //!< 1,048,576 bytes (1 MiB)
+}
+
 /*!
  * \namespace Iod
  *
@@ -174,6 +202,17 @@ namespace Emulator
 
     enum class FrequencyTarget { KHZ_100 = 100000, MHZ_1 = 1000000, MHZ_2 = 2000000,
                                  MHZ_5 = 5000000, MHZ_10 = 10000000, MHZ_20 = 20000000, FASTEST = 0 }; //!< Lists possible frequency targets
+
+    constexpr int CAPTURE_FORMATS_NB = 4;
+
+    enum class CaptureFormat { NONE = 0, RAW = 1, PNG = 2, STREAM = 3 }; //!< Lists the formats of the monitor capture (see MonitorCapture)
+
+    const std::string captureFormatStr[] = { "No capture", "Raw images", "PNG images", "Compressed stream" };
+
+    constexpr int DEFAULT_CAPTURE_INTERVAL = 100000; //!< In CPU ticks
+
+    constexpr int KEYBOARD_BUFFER_MAX_DEPTH = 256; //!< Capacity of the key events FIFO of HbcKeyboard
+    constexpr int DEFAULT_KEYBOARD_BUFFER_DEPTH = 32;
 }
 
 // ============ UTILITIES ============
@@ -106,6 +106,12 @@ void ConfigManager::setRamAsDefaultMemoryTarget(bool ramAsDefault)
     m_settings->ramAsDefaultMemoryTarget = ramAsDefault;
 }
 
+void ConfigManager::setIncrementalAssembly(bool enable)
+{
+    m_settings->incrementalAssembly = enable;
+    saveConfigFile();
+}
+
 // Emulator settings
 void ConfigManager::setStartEmulatorPaused(bool paused)
 {
@@ -131,12 +137,42 @@ void ConfigManager::setKeyboardPlugged(bool plugged)
     saveConfigFile();
 }
 
+void ConfigManager::setKeyboardCoalesceRepeats(bool enable)
+{
+    m_settings->keyboardCoalesceRepeats = enable;
+    saveConfigFile();
+}
+
 void ConfigManager::setEepromPlugged(bool plugged)
 {
     m_settings->eepromPlugged = plugged;
     saveConfigFile();
 }
 
+void ConfigManager::setDmaPlugged(bool plugged)
+{
+    m_settings->dmaPlugged = plugged;
+    saveConfigFile();
+}
+
+void ConfigManager::setLoadProjectPlugins(bool enable)
+{
+    m_settings->loadProjectPlugins = enable;
+    saveConfigFile();
+}
+
+void ConfigManager::setStoragePlugged(bool plugged)
+{
+    m_settings->storagePlugged = plugged;
+    saveConfigFile();
+}
+
+void ConfigManager::setSerialPlugged(bool plugged)
+{
+    m_settings->serialPlugged = plugged;
+    saveConfigFile();
+}
+
 void ConfigManager::setDismissReassemblyWarnings(bool dismiss)
 {
     m_settings->dismissReassemblyWarnings = dismiss;
@@ -153,6 +189,21 @@ void ConfigManager::setFrequencyTarget(Emulator::FrequencyTargetIndex target)
     m_settings->frequencyTarget = target;
 }
 
+void ConfigManager::setMonitorCaptureFormat(Emulator::CaptureFormat format)
+{
+    m_settings->monitorCaptureFormat = format;
+}
+
+void ConfigManager::setMonitorCaptureInterval(unsigned int interval)
+{
+    m_settings->monitorCaptureInterval = interval;
+}
+
+void ConfigManager::setKeyboardBufferDepth(unsigned int depth)
+{
+    m_settings->keyboardBufferDepth = depth;
+}
+
 // Cpu state viewer settings
 void ConfigManager::setOpenCpuStateViewerOnEmulatorPaused(bool enable)
 {
@@ -219,6 +270,11 @@ bool ConfigManager::getRamAsDefaultMemoryTarget()
     return m_settings->ramAsDefaultMemoryTarget;
 }
 
+bool ConfigManager::getIncrementalAssembly()
+{
+    return m_settings->incrementalAssembly;
+}
+
 // Emulator settings
 bool ConfigManager::getStartEmulatorPaused()
 {
@@ -240,11 +296,41 @@ bool ConfigManager::getKeyboardPlugged()
     return m_settings->keyboardPlugged;
 }
 
+unsigned int ConfigManager::getKeyboardBufferDepth()
+{
+    return m_settings->keyboardBufferDepth;
+}
+
+bool ConfigManager::getKeyboardCoalesceRepeats()
+{
+    return m_settings->keyboardCoalesceRepeats;
+}
+
 bool ConfigManager::getEepromPlugged()
 {
     return m_settings->eepromPlugged;
 }
 
+bool ConfigManager::getLoadProjectPlugins()
+{
+    return m_settings->loadProjectPlugins;
+}
+
+bool ConfigManager::getDmaPlugged()
+{
+    return m_settings->dmaPlugged;
+}
+
+bool ConfigManager::getStoragePlugged()
+{
+    return m_settings->storagePlugged;
+}
+
+bool ConfigManager::getSerialPlugged()
+{
+    return m_settings->serialPlugged;
+}
+
 bool ConfigManager::getDismissReassemblyWarnings()
 {
     return m_settings->dismissReassemblyWarnings;
@@ -260,6 +346,16 @@ Emulator::FrequencyTargetIndex ConfigManager::getFrequencyTarget()
     return m_settings->frequencyTarget;
 }
 
+Emulator::CaptureFormat ConfigManager::getMonitorCaptureFormat()
+{
+    return m_settings->monitorCaptureFormat;
+}
+
+unsigned int ConfigManager::getMonitorCaptureInterval()
+{
+    return m_settings->monitorCaptureInterval;
+}
+
 // Cpu state viewer settings
 bool ConfigManager::getOpenCpuStateViewerOnEmulatorPaused()
 {
@@ -351,6 +447,10 @@ ConfigManager::ConfigManager()
                     {
                         m_settings->ramAsDefaultMemoryTarget = (value == "TRUE");
                     }
+                    else if (key == "INCREMENTAL_ASSEMBLY")
+                    {
+                        m_settings->incrementalAssembly = (value == "TRUE");
+                    }
                     else if (key == "DEFAULT_PROJECT_PATH")
                     {
                         if (!value.isEmpty())
@@ -380,10 +480,40 @@ ConfigManager::ConfigManager()
                     {
                         m_settings->keyboardPlugged = (value == "TRUE");
                     }
+                    else if (key == "KEYBOARD_BUFFER_DEPTH")
+                    {
+                        bool ok;
+                        unsigned int depth = value.toUInt(&ok);
+
+                        if (ok && depth > 0 && depth <= Emulator::KEYBOARD_BUFFER_MAX_DEPTH)
+                        {
+                            m_settings->keyboardBufferDepth = depth;
+                        }
+                    }
+                    else if (key == "KEYBOARD_COALESCE_REPEATS")
+                    {
+                        m_settings->keyboardCoalesceRepeats = (value == "TRUE");
+                    }
                     else if (key == "EEPROM_PLUGGED")
                     {
                         m_settings->eepromPlugged = (value == "TRUE");
                     }
+                    else if (key == "LOAD_PROJECT_PLUGINS")
+                    {
+                        m_settings->loadProjectPlugins = (value == "TRUE");
+                    }
+                    else if (key == "DMA_PLUGGED")
+                    {
+                        m_settings->dmaPlugged = (value == "TRUE");
+                    }
+                    else if (key == "STORAGE_PLUGGED")
+                    {
+                        m_settings->storagePlugged = (value == "TRUE");
+                    }
+                    else if (key == "SERIAL_PLUGGED")
+                    {
+                        m_settings->serialPlugged = (value == "TRUE");
+                    }
                     else if (key == "DISMISS_REASSEMBLY_WARNINGS")
                     {
                         m_settings->dismissReassemblyWarnings = (value == "TRUE");
@@ -398,6 +528,26 @@ ConfigManager::ConfigManager()
                             m_settings->frequencyTarget = (Emulator::FrequencyTargetIndex)index;
                         }
                     }
+                    else if (key == "MONITOR_CAPTURE_FORMAT")
+                    {
+                        bool ok;
+                        int index = value.toInt(&ok);
+
+                        if (ok && index >= 0 && index < Emulator::CAPTURE_FORMATS_NB)
+                        {
+                            m_settings->monitorCaptureFormat = (Emulator::CaptureFormat)index;
+                        }
+                    }
+                    else if (key == "MONITOR_CAPTURE_INTERVAL")
+                    {
+                        bool ok;
+                        unsigned int interval = value.toUInt(&ok);
+
+                        if (ok && interval > 0)
+                        {
+                            m_settings->monitorCaptureInterval = interval;
+                        }
+                    }
                     else if (key == "OPEN_CPU_STATE_VIEWER_EMULATOR_PAUSED")
                     {
                         m_settings->openCpuStateViewerOnEmulatorPaused = (value == "TRUE");
@@ -559,15 +709,24 @@ bool ConfigManager::saveConfigFile()
         out << "DEFAULT_PROJECT_PATH=" << m_settings->defaultProjectsPath << "\n";
 
         out << "RAM_AS_DEFAULT_MEMORY_TARGET=" << (m_settings->ramAsDefaultMemoryTarget ? "TRUE" : "FALSE") << "\n";
+        out << "INCREMENTAL_ASSEMBLY=" << (m_settings->incrementalAssembly ? "TRUE" : "FALSE") << "\n";
 
         out << "START_EMULATOR_PAUSED=" << (m_settings->startEmulatorPaused ? "TRUE" : "FALSE") << "\n";
         out << "MONITOR_PLUGGED=" << (m_settings->monitorPlugged ? "TRUE" : "FALSE") << "\n";
         out << "RTC_PLUGGED=" << (m_settings->rtcPlugged ? "TRUE" : "FALSE") << "\n";
         out << "KEYBOARD_PLUGGED=" << (m_settings->keyboardPlugged ? "TRUE" : "FALSE") << "\n";
+        out << "KEYBOARD_BUFFER_DEPTH=" << QString::number(m_settings->keyboardBufferDepth) << "\n";
+        out << "KEYBOARD_COALESCE_REPEATS=" << (m_settings->keyboardCoalesceRepeats ? "TRUE" : "FALSE") << "\n";
         out << "EEPROM_PLUGGED=" << (m_settings->eepromPlugged ? "TRUE" : "FALSE") << "\n";
+        out << "DMA_PLUGGED=" << (m_settings->dmaPlugged ? "TRUE" : "FALSE") << "\n";
+        out << "LOAD_PROJECT_PLUGINS=" << (m_settings->loadProjectPlugins ? "TRUE" : "FALSE") << "\n";
+        out << "STORAGE_PLUGGED=" << (m_settings->storagePlugged ? "TRUE" : "FALSE") << "\n";
+        out << "SERIAL_PLUGGED=" << (m_settings->serialPlugged ? "TRUE" : "FALSE") << "\n";
         out << "DISMISS_REASSEMBLY_WARNINGS=" << (m_settings->dismissReassemblyWarnings ? "TRUE" : "FALSE") << "\n";
         out << "DEFAULT_FREQUENCY_TARGET=" << QString::number((int)m_settings->frequencyTarget) << "\n";
         out << "PIXEL_SCALE=" << QString::number(m_settings->pixelScale) << "\n";
+        out << "MONITOR_CAPTURE_FORMAT=" << QString::number((int)m_settings->monitorCaptureFormat) << "\n";
+        out << "MONITOR_CAPTURE_INTERVAL=" << QString::number(m_settings->monitorCaptureInterval) << "\n";
 
         out << "OPEN_CPU_STATE_VIEWER_EMULATOR_PAUSED=" << (m_settings->openCpuStateViewerOnEmulatorPaused ? "TRUE" : "FALSE") << "\n";
         out << "OPEN_CPU_STATE_VIEWER_EMULATOR_STOPPED=" << (m_settings->openCpuStateViewerOnEmulatorStopped ? "TRUE" : "FALSE") << "\n";
@@ -780,6 +939,11 @@ void SettingsDialog::ramAsDefaultMemoryTargetChanged()
     m_configManager->setRamAsDefaultMemoryTarget(m_ramAsDefaultMemoryTargetCheckBox->isChecked());
 }
 
+void SettingsDialog::incrementalAssemblyChanged()
+{
+    m_configManager->setIncrementalAssembly(m_incrementalAssemblyCheckBox->isChecked());
+}
+
 void SettingsDialog::startPausedChanged()
 {
     m_configManager->setStartEmulatorPaused(m_startPausedCheckBox->isChecked());
@@ -800,6 +964,21 @@ void SettingsDialog::plugKeyboardChanged()
     m_configManager->setKeyboardPlugged(m_plugKeyboardCheckBox->isChecked());
 }
 
+void SettingsDialog::keyboardBufferDepthChanged(int depth)
+{
+    m_configManager->setKeyboardBufferDepth(depth);
+}
+
+void SettingsDialog::keyboardCoalesceRepeatsChanged()
+{
+    m_configManager->setKeyboardCoalesceRepeats(m_keyboardCoalesceRepeatsCheckBox->isChecked());
+}
+
+void SettingsDialog::loadProjectPluginsChanged()
+{
+    m_configManager->setLoadProjectPlugins(m_loadProjectPluginsCheckBox->isChecked());
+}
+
 void SettingsDialog::plugEepromChanged()
 {
     m_configManager->setEepromPlugged(m_plugEepromCheckBox->isChecked());
@@ -810,6 +989,17 @@ void SettingsDialog::dismissReassemblyWarningsChanged()
     m_configManager->setDismissReassemblyWarnings(m_dismissReassemblyWarningsCheckBox->isChecked());
 }
 
+void SettingsDialog::monitorCaptureFormatChanged(int index)
+{
+    m_configManager->setMonitorCaptureFormat((Emulator::CaptureFormat)index);
+    m_monitorCaptureIntervalSpinBox->setEnabled(index != (int)Emulator::CaptureFormat::NONE);
+}
+
+void SettingsDialog::monitorCaptureIntervalChanged(int interval)
+{
+    m_configManager->setMonitorCaptureInterval(interval);
+}
+
 void SettingsDialog::pixelScaleChanged(int scale)
 {
     m_configManager->setPixelScale(scale);
@@ -1025,11 +1215,13 @@ void SettingsDialog::initAssemblerSettingsLayout()
     mainLabel->setStyleSheet("font-weight: bold;");
 
     m_ramAsDefaultMemoryTargetCheckBox = new QCheckBox(tr("RAM as default memory target"), qobject_cast<QWidget*>(m_assemblerSettingsGeneralTabLayout));
+    m_incrementalAssemblyCheckBox = new QCheckBox(tr("Only process the files modified since the last assembly (cache saved in the project directory)"), qobject_cast<QWidget*>(m_assemblerSettingsGeneralTabLayout));
     // ------------------
 
 
     // Final layout configuration
     m_assemblerSettingsGeneralTabLayout->addWidget(m_ramAsDefaultMemoryTargetCheckBox);
+    m_assemblerSettingsGeneralTabLayout->addWidget(m_incrementalAssemblyCheckBox);
     m_assemblerSettingsGeneralTabLayout->addStretch();
     m_assemblerSettingsGeneralTabWidget->setLayout(m_assemblerSettingsGeneralTabLayout);
     m_assemblerSettingsTabWidget->addTab(m_assemblerSettingsGeneralTabWidget, tr("General"));
@@ -1041,6 +1233,7 @@ void SettingsDialog::initAssemblerSettingsLayout()
 
     // Connections
     connect(m_ramAsDefaultMemoryTargetCheckBox, SIGNAL(stateChanged(int)), this, SLOT(ramAsDefaultMemoryTargetChanged()));
+    connect(m_incrementalAssemblyCheckBox, SIGNAL(stateChanged(int)), this, SLOT(incrementalAssemblyChanged()));
 }
 
 void SettingsDialog::initEmulatorSettingsLayout()
@@ -1076,6 +1269,7 @@ void SettingsDialog::initEmulatorSettingsLayout()
 
     m_startPausedCheckBox = new QCheckBox(tr("Start paused"), qobject_cast<QWidget*>(m_emulatorSettingsGeneralTabLayout));
     m_dismissReassemblyWarningsCheckBox = new QCheckBox(tr("Dismiss warnings when running an unassembled project"), qobject_cast<QWidget*>(m_emulatorSettingsGeneralTabLayout));
+    m_loadProjectPluginsCheckBox = new QCheckBox(tr("Load the plugins of the project (native code, only for trusted projects)"), qobject_cast<QWidget*>(m_emulatorSettingsGeneralTabLayout));
     m_frequencyTargetComboBox = new QComboBox(qobject_cast<QWidget*>(m_emulatorSettingsGeneralTabLayout));
     for (unsigned int i(0); i < Emulator::FREQUENCIES_NB; i++)
     {
@@ -1091,8 +1285,32 @@ void SettingsDialog::initEmulatorSettingsLayout()
     pixelScaleLayout->addWidget(pixelScaleLabel);
     pixelScaleLayout->addWidget(m_pixelScaleSpinBox);
 
+    QLabel *monitorCaptureLabel = new QLabel(tr("Frame capture (in the project \"capture\" directory)"), qobject_cast<QWidget*>(m_emulatorSettingsMonitorTabLayout));
+    m_monitorCaptureFormatComboBox = new QComboBox(qobject_cast<QWidget*>(m_emulatorSettingsMonitorTabLayout));
+    for (unsigned int i(0); i < Emulator::CAPTURE_FORMATS_NB; i++)
+    {
+        m_monitorCaptureFormatComboBox->addItem(QString::fromStdString(Emulator::captureFormatStr[i]));
+    }
+
+    QLabel *monitorCaptureIntervalLabel = new QLabel(tr("CPU ticks between frames"), qobject_cast<QWidget*>(m_emulatorSettingsMonitorTabLayout));
+    m_monitorCaptureIntervalSpinBox = new QSpinBox(qobject_cast<QWidget*>(m_emulatorSettingsMonitorTabLayout));
+    m_monitorCaptureIntervalSpinBox->setRange(1000, 100000000);
+    m_monitorCaptureIntervalSpinBox->setSingleStep(1000);
+    QHBoxLayout *monitorCaptureIntervalLayout = new QHBoxLayout;
+    monitorCaptureIntervalLayout->addWidget(monitorCaptureIntervalLabel);
+    monitorCaptureIntervalLayout->addWidget(m_monitorCaptureIntervalSpinBox);
+
     m_plugRTCCheckBox = new QCheckBox(tr("Real Time Clock plugged-in by default"), qobject_cast<QWidget*>(m_emulatorSettingsRtcTabLayout));
     m_plugKeyboardCheckBox = new QCheckBox(tr("Keyboard plugged-in by default"), qobject_cast<QWidget*>(m_emulatorSettingsKeyboardTabLayout));
+
+    QLabel *keyboardBufferDepthLabel = new QLabel(tr("Key events waiting for the program"), qobject_cast<QWidget*>(m_emulatorSettingsKeyboardTabLayout));
+    m_keyboardBufferDepthSpinBox = new QSpinBox(qobject_cast<QWidget*>(m_emulatorSettingsKeyboardTabLayout));
+    m_keyboardBufferDepthSpinBox->setRange(1, Emulator::KEYBOARD_BUFFER_MAX_DEPTH);
+    QHBoxLayout *keyboardBufferDepthLayout = new QHBoxLayout;
+    keyboardBufferDepthLayout->addWidget(keyboardBufferDepthLabel);
+    keyboardBufferDepthLayout->addWidget(m_keyboardBufferDepthSpinBox);
+
+    m_keyboardCoalesceRepeatsCheckBox = new QCheckBox(tr("Drop repeated keys while the program is busy"), qobject_cast<QWidget*>(m_emulatorSettingsKeyboardTabLayout));
     m_plugEepromCheckBox = new QCheckBox(tr("EEPROM plugged-in by default"), qobject_cast<QWidget*>(m_emulatorSettingsEepromTabLayout));
     // ------------------
 
@@ -1100,12 +1318,16 @@ void SettingsDialog::initEmulatorSettingsLayout()
     // Final layout configuration
     m_emulatorSettingsGeneralTabLayout->addWidget(m_startPausedCheckBox);
     m_emulatorSettingsGeneralTabLayout->addWidget(m_dismissReassemblyWarningsCheckBox);
+    m_emulatorSettingsGeneralTabLayout->addWidget(m_loadProjectPluginsCheckBox);
     m_emulatorSettingsGeneralTabLayout->addWidget(m_frequencyTargetComboBox);
     m_emulatorSettingsGeneralTabLayout->addStretch();
     m_emulatorSettingsGeneralTabWidget->setLayout(m_emulatorSettingsGeneralTabLayout);
 
     m_emulatorSettingsMonitorTabLayout->addWidget(m_plugMonitorCheckBox);
     m_emulatorSettingsMonitorTabLayout->addLayout(pixelScaleLayout);
+    m_emulatorSettingsMonitorTabLayout->addWidget(monitorCaptureLabel);
+    m_emulatorSettingsMonitorTabLayout->addWidget(m_monitorCaptureFormatComboBox);
+    m_emulatorSettingsMonitorTabLayout->addLayout(monitorCaptureIntervalLayout);
     m_emulatorSettingsMonitorTabLayout->addStretch();
     m_emulatorSettingsMonitorTabWidget->setLayout(m_emulatorSettingsMonitorTabLayout);
 
@@ -1114,6 +1336,8 @@ void SettingsDialog::initEmulatorSettingsLayout()
     m_emulatorSettingsRtcTabWidget->setLayout(m_emulatorSettingsRtcTabLayout);
 
     m_emulatorSettingsKeyboardTabLayout->addWidget(m_plugKeyboardCheckBox);
+    m_emulatorSettingsKeyboardTabLayout->addLayout(keyboardBufferDepthLayout);
+    m_emulatorSettingsKeyboardTabLayout->addWidget(m_keyboardCoalesceRepeatsCheckBox);
     m_emulatorSettingsKeyboardTabLayout->addStretch();
     m_emulatorSettingsKeyboardTabWidget->setLayout(m_emulatorSettingsKeyboardTabLayout);
 
@@ -1135,11 +1359,16 @@ void SettingsDialog::initEmulatorSettingsLayout()
     // Connections
     connect(m_startPausedCheckBox, SIGNAL(stateChanged(int)), this, SLOT(startPausedChanged()));
     connect(m_dismissReassemblyWarningsCheckBox, SIGNAL(stateChanged(int)), this, SLOT(dismissReassemblyWarningsChanged()));
+    connect(m_loadProjectPluginsCheckBox, SIGNAL(stateChanged(int)), this, SLOT(loadProjectPluginsChanged()));
     connect(m_frequencyTargetComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(frequencyTargetChanged(int)));
     connect(m_plugMonitorCheckBox, SIGNAL(stateChanged(int)), this, SLOT(plugMonitorChanged()));
     connect(m_pixelScaleSpinBox, SIGNAL(valueChanged(int)), this, SLOT(pixelScaleChanged(int)));
+    connect(m_monitorCaptureFormatComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(monitorCaptureFormatChanged(int)));
+    connect(m_monitorCaptureIntervalSpinBox, SIGNAL(valueChanged(int)), this, SLOT(monitorCaptureIntervalChanged(int)));
     connect(m_plugRTCCheckBox, SIGNAL(stateChanged(int)), this, SLOT(plugRTCChanged()));
     connect(m_plugKeyboardCheckBox, SIGNAL(stateChanged(int)), this, SLOT(plugKeyboardChanged()));
+    connect(m_keyboardBufferDepthSpinBox, SIGNAL(valueChanged(int)), this, SLOT(keyboardBufferDepthChanged(int)));
+    connect(m_keyboardCoalesceRepeatsCheckBox, SIGNAL(stateChanged(int)), this, SLOT(keyboardCoalesceRepeatsChanged()));
     connect(m_plugEepromCheckBox, SIGNAL(stateChanged(int)), this, SLOT(plugEepromChanged()));
 }
 
@@ -1293,15 +1522,22 @@ void SettingsDialog::updateWidgets()
 
     // Assembler settings
     m_ramAsDefaultMemoryTargetCheckBox->setChecked(m_configManager->getRamAsDefaultMemoryTarget());
+    m_incrementalAssemblyCheckBox->setChecked(m_configManager->getIncrementalAssembly());
 
     // Emulator settings
     m_startPausedCheckBox->setChecked(m_configManager->getStartEmulatorPaused());
     m_dismissReassemblyWarningsCheckBox->setChecked(m_configManager->getDismissReassemblyWarnings());
+    m_loadProjectPluginsCheckBox->setChecked(m_configManager->getLoadProjectPlugins());
     m_frequencyTargetComboBox->setCurrentIndex((int)m_configManager->getFrequencyTarget());
     m_plugMonitorCheckBox->setChecked(m_configManager->getMonitorPlugged());
     m_pixelScaleSpinBox->setValue(m_configManager->getPixelScale());
+    m_monitorCaptureFormatComboBox->setCurrentIndex((int)m_configManager->getMonitorCaptureFormat());
+    m_monitorCaptureIntervalSpinBox->setValue(m_configManager->getMonitorCaptureInterval());
+    m_monitorCaptureIntervalSpinBox->setEnabled(m_configManager->getMonitorCaptureFormat() != Emulator::CaptureFormat::NONE);
     m_plugRTCCheckBox->setChecked(m_configManager->getRTCPlugged());
     m_plugKeyboardCheckBox->setChecked(m_configManager->getKeyboardPlugged());
+    m_keyboardBufferDepthSpinBox->setValue(m_configManager->getKeyboardBufferDepth());
+    m_keyboardCoalesceRepeatsCheckBox->setChecked(m_configManager->getKeyboardCoalesceRepeats());
     m_plugEepromCheckBox->setChecked(m_configManager->getEepromPlugged());
 
     // CPU State Viewer settings
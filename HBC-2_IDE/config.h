@@ -97,6 +97,7 @@ namespace Configuration
 
         // Assembler settings
         bool ramAsDefaultMemoryTarget = true; //<! Sets if the code will be assembled in the RAM by default
+        bool incrementalAssembly = false; //!< Sets if the tokens of the files unchanged since the last assembly are reused, opt-in because it writes a cache into the project directory
 
         // Emulator settings
         bool startEmulatorPaused = true; //!< Sets if the emulator starts paused
@@ -104,9 +105,17 @@ namespace Configuration
         bool rtcPlugged = true; //!< Sets if the emulator starts with the HbcRealTimeClock plugged in
         bool keyboardPlugged = true; //!< Sets if the emulator starts with the HbcKeyboard plugged in
         bool eepromPlugged = false; //!< Sets if the emulator starts with the HbcEeprom plugged in
+        bool serialPlugged = false; //!< Sets if the emulator starts with the HbcSerial plugged in
+        bool storagePlugged = false; //!< Sets if the emulator starts with the HbcStorage plugged in
+        bool dmaPlugged = false; //!< Sets if the emulator starts with the HbcDma plugged in
         bool dismissReassemblyWarnings = false; //!< Sets if warnings are thrown when trying to run a project which was modified or not yet assembled
         unsigned int pixelScale = 4; //!< Sets the size of a pixel in the HbcMonitor
         Emulator::FrequencyTargetIndex frequencyTarget = Emulator::FrequencyTargetIndex::MHZ_2; //!< Sets the default frequency target for the emulator on startup
+        Emulator::CaptureFormat monitorCaptureFormat = Emulator::CaptureFormat::NONE; //!< Sets the format of the frames captured from the HbcMonitor
+        unsigned int monitorCaptureInterval = Emulator::DEFAULT_CAPTURE_INTERVAL; //!< Sets the number of CPU ticks between two captured frames
+        unsigned int keyboardBufferDepth = Emulator::DEFAULT_KEYBOARD_BUFFER_DEPTH; //!< Sets the number of key events waiting for the guest program
+        bool keyboardCoalesceRepeats = true; //!< Sets if auto-repeated keys are dropped while the guest program has events waiting
+        bool loadProjectPlugins = false; //!< Sets if the native libraries of the project "plugins" directory are loaded, off because they run with the rights of the IDE
 
         // CPU state viewer settings
         bool openCpuStateViewerOnEmulatorPaused = true;
@@ -181,6 +190,11 @@ class ConfigManager
          */
         void setRamAsDefaultMemoryTarget(bool ramAsDefault);
 
+        /*!
+         * \brief Sets if only the modified files are tokenized and checked again
+         */
+        void setIncrementalAssembly(bool enable);
+
         // ===== Emulator settings =====
         /*!
          * \param paused Desired behaviour for the emulator on run command
@@ -202,11 +216,41 @@ class ConfigManager
          */
         void setKeyboardPlugged(bool plugged);
 
+        /*!
+         * \param depth Maximum number of key events waiting for the guest program
+         */
+        void setKeyboardBufferDepth(unsigned int depth);
+
+        /*!
+         * \param enable Drops auto-repeated keys while key events are waiting for the guest program
+         */
+        void setKeyboardCoalesceRepeats(bool enable);
+
         /*!
          * \param plugged Desired behaviour for the EEPROM on emulator start
          */
         void setEepromPlugged(bool plugged);
 
+        /*!
+         * \param plugged Desired behaviour for the DMA controller on emulator start
+         */
+        void setDmaPlugged(bool plugged);
+
+        /*!
+         * \param enable Loads the plugins of the project when it is loaded in the emulator
+         */
+        void setLoadProjectPlugins(bool enable);
+
+        /*!
+         * \param plugged Desired behaviour for the Storage device on emulator start
+         */
+        void setStoragePlugged(bool plugged);
+
+        /*!
+         * \param plugged Desired behaviour for the Serial port on emulator start
+         */
+        void setSerialPlugged(bool plugged);
+
         /*!
          * \param dismiss Desired reassembly warnings
          */
@@ -222,6 +266,16 @@ class ConfigManager
          */
         void setFrequencyTarget(Emulator::FrequencyTargetIndex target);
 
+        /*!
+         * \brief Sets the format of the frames captured from HbcMonitor
+         */
+        void setMonitorCaptureFormat(Emulator::CaptureFormat format);
+
+        /*!
+         * \brief Sets the number of CPU ticks between two frames captured from HbcMonitor
+         */
+        void setMonitorCaptureInterval(unsigned int interval);
+
         // ===== CPU state viewer settings =====
         /*!
          * \param enable Desired behaviour for the CpuStateViewer when the emulator is paused
@@ -283,6 +337,11 @@ class ConfigManager
          */
         bool getRamAsDefaultMemoryTarget();
 
+        /*!
+         * \return <b>true</b> if only the modified files are tokenized and checked again
+         */
+        bool getIncrementalAssembly();
+
         // ===== Emulator settings =====
         /*!
          * \return <b>true</b> if the emulator starts paused
@@ -304,11 +363,41 @@ class ConfigManager
          */
         bool getKeyboardPlugged();
 
+        /*!
+         * \return the maximum number of key events waiting for the guest program
+         */
+        unsigned int getKeyboardBufferDepth();
+
+        /*!
+         * \return <b>true</b> if auto-repeated keys are dropped while key events are waiting for the guest program
+         */
+        bool getKeyboardCoalesceRepeats();
+
         /*!
          * \return <b>true</b> if the emulator starts with the EEPROM plugged in
          */
         bool getEepromPlugged();
 
+        /*!
+         * \return <b>true</b> if the plugins of the project are loaded in the emulator
+         */
+        bool getLoadProjectPlugins();
+
+        /*!
+         * \return <b>true</b> if the emulator starts with the Serial port plugged in
+         */
+        bool getSerialPlugged();
+
+        /*!
+         * \return <b>true</b> if the emulator starts with the Storage device plugged in
+         */
+        bool getStoragePlugged();
+
+        /*!
+         * \return <b>true</b> if the emulator starts with the DMA controller plugged in
+         */
+        bool getDmaPlugged();
+
         /*!
          * \return <b>true</b> if warnings on emulator run with non assembled project are dismissed
          */
@@ -324,6 +413,16 @@ class ConfigManager
          */
         Emulator::FrequencyTargetIndex getFrequencyTarget();
 
+        /*!
+         * \return the format of the frames captured from HbcMonitor
+         */
+        Emulator::CaptureFormat getMonitorCaptureFormat();
+
+        /*!
+         * \return the number of CPU ticks between two frames captured from HbcMonitor
+         */
+        unsigned int getMonitorCaptureInterval();
+
         // ===== Cpu state viewer settings =====
         /*!
          * \return <b>true</b> if the CpuStateViewer opens when the emulator is paused
@@ -409,16 +508,22 @@ class SettingsDialog : public QDialog
 
         // Assembler
         void ramAsDefaultMemoryTargetChanged();
+        void incrementalAssemblyChanged();
 
         // Emulator
         void startPausedChanged();
         void plugMonitorChanged();
         void plugRTCChanged();
         void plugKeyboardChanged();
+        void keyboardBufferDepthChanged(int depth);
+        void keyboardCoalesceRepeatsChanged();
+        void loadProjectPluginsChanged();
         void plugEepromChanged();
         void dismissReassemblyWarningsChanged();
         void pixelScaleChanged(int scale);
         void frequencyTargetChanged(int index);
+        void monitorCaptureFormatChanged(int index);
+        void monitorCaptureIntervalChanged(int interval);
 
         // CpuStateViewer
         void openCpuStateViewerOnEmulatorPausedChanged();
@@ -482,6 +587,7 @@ class SettingsDialog : public QDialog
 
         // Assembler page widgets
         QCheckBox *m_ramAsDefaultMemoryTargetCheckBox;
+        QCheckBox *m_incrementalAssemblyCheckBox;
         QVBoxLayout *m_assemblerSettingsGeneralTabLayout;
         QWidget *m_assemblerSettingsGeneralTabWidget;
 
@@ -493,6 +599,7 @@ class SettingsDialog : public QDialog
         // Emulator page widgets
         // General tab
         QCheckBox *m_startPausedCheckBox;
+        QCheckBox *m_loadProjectPluginsCheckBox;
         QCheckBox *m_dismissReassemblyWarningsCheckBox;
         QComboBox *m_frequencyTargetComboBox;
         QVBoxLayout *m_emulatorSettingsGeneralTabLayout;
@@ -500,6 +607,8 @@ class SettingsDialog : public QDialog
         // Monitor tab
         QCheckBox *m_plugMonitorCheckBox;
         QSpinBox *m_pixelScaleSpinBox;
+        QComboBox *m_monitorCaptureFormatComboBox;
+        QSpinBox *m_monitorCaptureIntervalSpinBox;
         QVBoxLayout *m_emulatorSettingsMonitorTabLayout;
         QWidget *m_emulatorSettingsMonitorTabWidget;
         // RTC tab
@@ -508,6 +617,8 @@ class SettingsDialog : public QDialog
         QWidget *m_emulatorSettingsRtcTabWidget;
         // Keyboard tab
         QCheckBox *m_plugKeyboardCheckBox;
+        QSpinBox *m_keyboardBufferDepthSpinBox;
+        QCheckBox *m_keyboardCoalesceRepeatsCheckBox;
         QVBoxLayout *m_emulatorSettingsKeyboardTabLayout;
         QWidget *m_emulatorSettingsKeyboardTabWidget;
         // EEPROM tab
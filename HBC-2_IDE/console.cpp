@@ -36,6 +36,16 @@ void Console::log()
     returnLine();
 }
 
+void Console::write(QString text)
+{
+    m_lock.lock();
+    moveCursor(QTextCursor::End);
+    insertPlainText(text);
+    m_lock.unlock();
+
+    ensureCursorVisible();
+}
+
 void Console::returnLine()
 {
     m_lock.lock();
@@ -44,3 +54,10 @@ void Console::returnLine()
 
     ensureCursorVisible();
 }
+
+void Console::clearLog()
+{
+    m_lock.lock();
+    clear();
+    m_lock.unlock();
+}
@@ -11,6 +11,7 @@
 #include <QTime>
 #include <QTextEdit>
 #include <QMutex>
+#include "logOutput.h"
 
 /*!
  * \class Console
@@ -19,7 +20,7 @@
  * Prints time on each log.<br>
  * Thread safe and handles std::string, char* and QString.
  */
-class Console : public QTextEdit
+class Console : public QTextEdit, public LogOutput
 {
     Q_OBJECT
 
@@ -43,7 +44,7 @@ class Console : public QTextEdit
          *
          * \param line std::string to prompt
          */
-        void log(std::string line);
+        void log(std::string line) override;
 
         /*!
          * Logs a string of character and returns line
@@ -57,7 +58,15 @@ class Console : public QTextEdit
          */
         void log();
 
-        void returnLine();
+        void returnLine() override;
+        void clearLog() override;
+
+        /*!
+         * Prints raw text at the end of the console, without time nor line return
+         *
+         * \param text QString to prompt
+         */
+        void write(QString text);
 
     private:
         static constexpr int CONSOLE_HEIGHT = 200;
@@ -267,7 +267,7 @@ void DisassemblyViewer::disassemble(const QByteArray ramData)
         m_instruction += (((Dword)ramData[i + 2]) << 8) & 0x0000FF00;
         m_instruction += ramData[i + 3] & 0x000000FF;
 
-        decodeInstruction();
+        m_decodedInstruction = Cpu::Formats::decode(m_instruction);
         convertInstructionToQString();
 
         lines.push_back("                " + word2QString(i) + "\t" + m_disassembledInstructionStr);
@@ -339,340 +339,103 @@ void DisassemblyViewer::disassemble(const QByteArray ramData)
     m_disassembledCodeWidget->setTextCursor(cursor);
 }
 
-void DisassemblyViewer::decodeInstruction()
-{
-    m_decodedInstruction.opcode = (Cpu::InstructionOpcode)((m_instruction & Cpu::OPCODE_MASK) >> 26);
-    m_decodedInstruction.addressingMode = (Cpu::AddressingMode)((m_instruction & Cpu::ADDRMODE_MASK) >> 22);
-
-    m_decodedInstruction.r1 = (Cpu::Register)((m_instruction & Cpu::R1_MASK) >> 19);
-    m_decodedInstruction.r2 = (Cpu::Register)((m_instruction & Cpu::R2_MASK) >> 16);
-    m_decodedInstruction.r3 = (Cpu::Register)((m_instruction & Cpu::R3_MASK) >> 8);
-
-    m_decodedInstruction.v1 = (m_instruction & Cpu::V1_MASK) >> 8;
-    m_decodedInstruction.v2 = m_instruction & Cpu::V2_MASK;
-    m_decodedInstruction.vX = m_instruction & Cpu::VX_MASK;
-}
-
 void DisassemblyViewer::convertInstructionToQString()
 {
-    Disassembler::Label newLabel;
-    Disassembler::Variable newVariable;
-    QString opcodeStr("nop");
-    QString argsStr("");
-    bool valid(false);
-
-    if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::ADC || m_decodedInstruction.opcode == Cpu::InstructionOpcode::ADD
-     || m_decodedInstruction.opcode == Cpu::InstructionOpcode::AND || m_decodedInstruction.opcode == Cpu::InstructionOpcode::OR
-     || m_decodedInstruction.opcode == Cpu::InstructionOpcode::ADD || m_decodedInstruction.opcode == Cpu::InstructionOpcode::SUB
-     || m_decodedInstruction.opcode == Cpu::InstructionOpcode::SBB || m_decodedInstruction.opcode == Cpu::InstructionOpcode::XOR)
-    {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu ::REGISTERS_NB && (int)m_decodedInstruction.r2 < Cpu ::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += ", ";
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r2].c_str();
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG_IMM8)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu ::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += ", 0x";
-                argsStr += QString::number(m_decodedInstruction.v1, 16);
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG_RAM)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu ::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-
-                newVariable.address = m_decodedInstruction.vX;
-                newVariable.name = "var" + QString::number(m_variablesList.size() + 1);
-                int variableIndex(getVariableIndex(newVariable));
-
-                if (variableIndex == -1)
-                {
-                    m_variablesList.push_back(newVariable);
-                    argsStr += ", " + newLabel.name;
-                }
-                else
-                {
-                    argsStr += ", " + m_variablesList[variableIndex].name;
-                }
-
-                valid = true;
-            }
-        }
-    }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLC || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLE
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLI || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLN
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLS || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLZ
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::CLF || m_decodedInstruction.opcode == Cpu::InstructionOpcode::HLT
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::IRT || m_decodedInstruction.opcode == Cpu::InstructionOpcode::RET
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STC || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STE
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STI || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STN
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STS || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STZ
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::STF)
-    {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::NONE)
-        {
-            valid = true;
-        }
-    }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::IN  || m_decodedInstruction.opcode == Cpu::InstructionOpcode::OUT
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::POP || m_decodedInstruction.opcode == Cpu::InstructionOpcode::PSH
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::SHL || m_decodedInstruction.opcode == Cpu::InstructionOpcode::ASR
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::SHR)
-    {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                valid = true;
-            }
-        }
-    }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::CAL || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMC
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JME || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMN
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMP || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMS
-          || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMZ || m_decodedInstruction.opcode == Cpu::InstructionOpcode::JMF)
+    const Cpu::Formats::Format *format = Cpu::Formats::find(m_decodedInstruction.opcode, m_decodedInstruction.addrMode);
+
+    if (format == nullptr) // Not executed by the CPU
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG16)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r2 < Cpu::REGISTERS_NB)
-            {
-                argsStr =  "[";
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r2].c_str();
-                argsStr += "]";
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::IMM16)
-        {
-            // if address < 0x300 -> pas de label
-            if (m_decodedInstruction.vX >= Cpu::PROGRAM_START_ADDRESS)
-            {
-                newLabel.address = m_decodedInstruction.vX;
-                newLabel.name = "_location" + QString::number(m_labelsList.size());
-                int labelIndex(getLabelIndex(newLabel));
-
-                if (labelIndex == -1)
-                {
-                    m_labelsList.push_back(newLabel);
-                    argsStr = newLabel.name;
-                }
-                else
-                {
-                    argsStr = m_labelsList[labelIndex].name;
-                }
-            }
-            else
-            {
-                argsStr = word2QString(m_decodedInstruction.vX);
-            }
-
-            valid = true;
-        }
+        m_disassembledInstructionStr = "nop";
+        return;
     }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::DEC || m_decodedInstruction.opcode == Cpu::InstructionOpcode::INC)
+
+    QStringList operandsStr;
+
+    for (unsigned int i(0); i < format->getOperandsNb(); i++)
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG16)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r2 < Cpu::REGISTERS_NB)
-            {
-                argsStr =  "[";
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r2].c_str();
-                argsStr += "]";
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::IMM16)
-        {
-            newVariable.address = m_decodedInstruction.vX;
-            newVariable.name = "var" + QString::number(m_variablesList.size() + 1);
-            int variableIndex(getVariableIndex(newVariable));
-
-            if (variableIndex == -1)
-            {
-                m_variablesList.push_back(newVariable);
-                argsStr = newLabel.name;
-            }
-            else
-            {
-                argsStr = m_variablesList[variableIndex].name;
-            }
-
-            valid = true;
-        }
+        operandsStr.append(convertOperandToQString(format->operands[i]));
     }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::STR || m_decodedInstruction.opcode == Cpu::InstructionOpcode::LOD)
-    {
-        QString arg1, arg2;
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG_RAM)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                arg1 = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-
-                newVariable.address = m_decodedInstruction.vX;
-                newVariable.name = "var" + QString::number(m_variablesList.size() + 1);
-                int variableIndex(getVariableIndex(newVariable));
-
-                if (variableIndex == -1)
-                {
-                    m_variablesList.push_back(newVariable);
-                    arg2 = newLabel.name;
-                }
-                else
-                {
-                    arg2 = m_variablesList[variableIndex].name;
-                }
-
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::RAMREG_IMMREG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r2 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r3 < Cpu::REGISTERS_NB)
-            {
-                arg1 = Cpu::regStrArr[(int)m_decodedInstruction.r3].c_str();
-                arg2 += "[";
-                arg2 += Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                arg2 += Cpu::regStrArr[(int)m_decodedInstruction.r2].c_str();
-                arg2 += "]";
-                valid = true;
-            }
-        }
 
-        if (valid)
-        {
-            if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::STR)
-            {
-                argsStr = arg2 + ", " + arg1;
-            }
-            else
-            {
-                argsStr = arg1 + ", " + arg2;
-            }
-        }
-    }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::CMP)
+    m_disassembledInstructionStr = Cpu::instrStrArr[(int)m_decodedInstruction.opcode].c_str();
+
+    if (!operandsStr.isEmpty())
+        m_disassembledInstructionStr += " " + operandsStr.join(", ");
+}
+
+QString DisassemblyViewer::convertOperandToQString(Cpu::Formats::Operand operand)
+{
+    Byte reg(0x00);
+
+    switch (operand.field)
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG_IMM8)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += ", 0x";
-                argsStr += QString::number(m_decodedInstruction.v1, 16);
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::RAMREG_IMMREG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r2 < Cpu::REGISTERS_NB && (int)m_decodedInstruction.r3 < Cpu::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r3].c_str();
-                argsStr += ", [";
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += Cpu::regStrArr[(int)m_decodedInstruction.r2].c_str();
-                argsStr += "]";
-                valid = true;
-            }
-        }
+    case Cpu::Formats::Field::R1:
+        reg = m_decodedInstruction.r1;
+        break;
+
+    case Cpu::Formats::Field::R2:
+        reg = m_decodedInstruction.r2;
+        break;
+
+    case Cpu::Formats::Field::R3:
+        reg = m_decodedInstruction.r3;
+        break;
+
+    default:
+        break;
     }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::MOV)
+
+    switch (operand.type)
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG_IMM8)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr =  Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                argsStr += ", 0x";
-                argsStr += QString::number(m_decodedInstruction.v1, 16);
-                valid = true;
-            }
-        }
-    }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::NOT)
+    case Cpu::Formats::OperandType::REG:
+        return Cpu::regStrArr[reg].c_str();
+
+    case Cpu::Formats::OperandType::REG16:
+        return QString("[") + Cpu::regStrArr[m_decodedInstruction.r1].c_str() + Cpu::regStrArr[m_decodedInstruction.r2].c_str() + "]";
+
+    case Cpu::Formats::OperandType::IMM8:
+        return "0x" + QString::number(m_decodedInstruction.v1, 16);
+
+    case Cpu::Formats::OperandType::PORT8:
+        return word2QString(m_decodedInstruction.v1);
+
+    case Cpu::Formats::OperandType::DATA16:
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::REG)
-        {
-            if ((int)m_decodedInstruction.r1 < Cpu::REGISTERS_NB)
-            {
-                argsStr = Cpu::regStrArr[(int)m_decodedInstruction.r1].c_str();
-                valid = true;
-            }
-        }
-        else if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::IMM16)
+        Disassembler::Variable newVariable;
+        newVariable.address = m_decodedInstruction.vX;
+        newVariable.name = "var" + QString::number(m_variablesList.size() + 1);
+        int variableIndex(getVariableIndex(newVariable));
+
+        if (variableIndex == -1)
         {
-            newVariable.address = m_decodedInstruction.vX;
-            newVariable.name = "var" + QString::number(m_variablesList.size() + 1);
-            int variableIndex(getVariableIndex(newVariable));
-
-            if (variableIndex == -1)
-            {
-                m_variablesList.push_back(newVariable);
-                argsStr = newLabel.name;
-            }
-            else
-            {
-                argsStr = m_variablesList[variableIndex].name;
-            }
-
-            valid = true;
+            m_variablesList.push_back(newVariable);
+            return newVariable.name;
         }
+
+        return m_variablesList[variableIndex].name;
     }
-    else if (m_decodedInstruction.opcode == Cpu::InstructionOpcode::INT)
+
+    case Cpu::Formats::OperandType::CODE16:
     {
-        if (m_decodedInstruction.addressingMode == Cpu::AddressingMode::IMM8)
+        // No label before the program memory
+        if (m_decodedInstruction.vX < Cpu::PROGRAM_START_ADDRESS)
+            return word2QString(m_decodedInstruction.vX);
+
+        Disassembler::Label newLabel;
+        newLabel.address = m_decodedInstruction.vX;
+        newLabel.name = "_location" + QString::number(m_labelsList.size());
+        int labelIndex(getLabelIndex(newLabel));
+
+        if (labelIndex == -1)
         {
-            argsStr = word2QString(m_decodedInstruction.v1);
-            valid = true;
+            m_labelsList.push_back(newLabel);
+            return newLabel.name;
         }
-    }
 
-    if (valid)
-    {
-        opcodeStr = Cpu::instrStrArr[(int)m_decodedInstruction.opcode].c_str();
-        m_disassembledInstructionStr = opcodeStr + " " + argsStr;
+        return m_labelsList[labelIndex].name;
     }
-    else
-    {
-        m_disassembledInstructionStr = "nop";
+
+    default:
+        return "";
     }
 }
 
@@ -9,6 +9,7 @@
  * \date 20/09/2023
  */
 #include "computerDetails.h"
+#include "instructionFormats.h"
 #include "console.h"
 #include "config.h"
 #include "syntaxHighlighter.h"
@@ -21,21 +22,6 @@
  */
 namespace Disassembler
 {
-    /*!
-     * \brief Described a decoded instruction
-     */
-    struct Instruction
-    {
-        Cpu::InstructionOpcode opcode;
-        Cpu::AddressingMode addressingMode;
-        Cpu::Register r1;
-        Cpu::Register r2;
-        Cpu::Register r3;
-        Byte v1;
-        Byte v2;
-        Word vX;
-    };
-
     /*!
      * \brief Stores information about an identified label
      */
@@ -173,15 +159,15 @@ class DisassemblyViewer : public QDialog
         void setPosition();
 
         void disassemble(const QByteArray ramData);
-        void decodeInstruction();
-        void convertInstructionToQString();
+        void convertInstructionToQString(); //!< Writes the operands of the format of m_decodedInstruction (see Cpu::Formats)
+        QString convertOperandToQString(Cpu::Formats::Operand operand);
         int getLabelIndex(Disassembler::Label newLabel); // Returns -1 if not found
         int getVariableIndex(Disassembler::Variable newVariable); // Returns -1 if not found
 
         void highlightAddress(Word programCounter);
 
         Dword m_instruction;
-        Disassembler::Instruction m_decodedInstruction;
+        Cpu::Formats::Fields m_decodedInstruction;
         QString m_disassembledInstructionStr;
         std::vector<Disassembler::Label> m_labelsList;
         std::vector<Disassembler::Variable> m_variablesList;
@@ -0,0 +1,133 @@
+#include "dma.h"
+#include "monitor.h"
+#include "eeprom.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Dma;
+
+// PUBLIC
+HbcDma::HbcDma(HbcRam *ram, HbcMonitor *monitor, Eeprom::HbcEeprom *eeprom, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+{
+    m_ram = ram;
+    m_monitor = monitor;
+    m_eeprom = eeprom;
+}
+
+void HbcDma::init()
+{
+    m_sockets = Iod::requestPortsConnexions(*m_iod, DEVICE_ID, PORTS_NB);
+
+    if (m_sockets.size() < PORTS_NB)
+    {
+        m_consoleOutput->log("Cannot plug the DMA controller, not enough available ports");
+    }
+}
+
+void HbcDma::tick(bool step)
+{
+    if (m_sockets.size() < PORTS_NB)
+        return;
+
+    Command command = (Command)*m_sockets[(int)Port::CMD].portDataPointer;
+
+    if (command == Command::NOP)
+        return;
+
+    bool success(false);
+
+    if (command == Command::COPY_RAM)
+    {
+        success = copyRam((Word)getSourceAddress(), getDestination(), getLength());
+    }
+    else if (command == Command::FILL_RAM)
+    {
+        success = fillRam(getDestination(), getLength(), *m_sockets[(int)Port::VALUE].portDataPointer);
+    }
+    else if (command == Command::LOAD_EEPROM)
+    {
+        success = loadEeprom(getSourceAddress(), getDestination(), getLength());
+    }
+    else if (command == Command::COPY_TO_MONITOR)
+    {
+        success = copyToMonitor((Word)getSourceAddress(), getDestination(), getLength());
+    }
+
+    *m_sockets[(int)Port::CMD].portDataPointer = (int)Command::NOP;
+    *m_sockets[(int)Port::STATUS].portDataPointer = (int)(success ? Status::DONE : Status::ERROR);
+
+    Iod::triggerInterrupt(*m_iod, m_sockets[(int)Port::STATUS].portId);
+}
+
+// PRIVATE
+Dword HbcDma::getSourceAddress()
+{
+    Dword address = 0x00000000;
+
+    address += *m_sockets[(int)Port::SRC_2].portDataPointer;
+    address += ((int)*m_sockets[(int)Port::SRC_1].portDataPointer) << 8;
+    address += ((int)*m_sockets[(int)Port::SRC_0].portDataPointer) << 16;
+
+    return address;
+}
+
+Word HbcDma::getDestination()
+{
+    return (*m_sockets[(int)Port::DST_0].portDataPointer << 8) + *m_sockets[(int)Port::DST_1].portDataPointer;
+}
+
+Word HbcDma::getLength()
+{
+    return (*m_sockets[(int)Port::LEN_0].portDataPointer << 8) + *m_sockets[(int)Port::LEN_1].portDataPointer;
+}
+
+bool HbcDma::copyRam(Word source, Word destination, Word length)
+{
+    int copySize = std::min({ (int)length, Ram::MEMORY_SIZE - source, Ram::MEMORY_SIZE - destination });
+
+    m_ram->mutex.lock();
+    std::memmove(m_ram->memory + destination, m_ram->memory + source, copySize);
+    m_ram->mutex.unlock();
+
+    return true;
+}
+
+bool HbcDma::fillRam(Word destination, Word length, Byte value)
+{
+    int fillSize = std::min((int)length, Ram::MEMORY_SIZE - destination);
+
+    m_ram->mutex.lock();
+    std::memset(m_ram->memory + destination, value, fillSize);
+    m_ram->mutex.unlock();
+
+    return true;
+}
+
+bool HbcDma::loadEeprom(Dword source, Word destination, Word length)
+{
+    if (m_eeprom == nullptr)
+        return false;
+
+    int copySize = std::min((int)length, Ram::MEMORY_SIZE - destination);
+
+    m_ram->mutex.lock();
+    m_eeprom->readMemory(source & 0xFFFFF, m_ram->memory + destination, copySize);
+    m_ram->mutex.unlock();
+
+    return true;
+}
+
+bool HbcDma::copyToMonitor(Word source, Word destination, Word length)
+{
+    if (m_monitor == nullptr)
+        return false;
+
+    int copySize = std::min((int)length, Ram::MEMORY_SIZE - source);
+
+    m_ram->mutex.lock();
+    m_monitor->writeVideoMemory(destination, m_ram->memory + source, copySize);
+    m_ram->mutex.unlock();
+
+    return true;
+}
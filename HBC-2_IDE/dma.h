@@ -0,0 +1,177 @@
+#ifndef DMA_H
+#define DMA_H
+
+/*!
+ * \file dma.h
+ * \brief DMA controller device derived from HbcPeripheral
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include "peripheral.h"
+#include "ram.h"
+
+class HbcMonitor;
+
+namespace Eeprom
+{
+    class HbcEeprom;
+}
+
+/*!
+ * \namespace Dma
+ * \brief See HbcDma for detailed specifications.
+ */
+namespace Dma
+{
+    constexpr Byte DEVICE_ID = 0xDA; //!< Random to "look" nice
+
+    constexpr int PORTS_NB = 10;
+    enum class Port { STATUS = 0, CMD = 1, SRC_0 = 2, SRC_1 = 3, SRC_2 = 4, DST_0 = 5, DST_1 = 6, LEN_0 = 7, LEN_1 = 8, VALUE = 9 }; //!< Lists the ports used by the DMA device
+    enum class Command { NOP = 0, COPY_RAM = 1, FILL_RAM = 2, LOAD_EEPROM = 3, COPY_TO_MONITOR = 4 }; //!< Lists the commands used by the DMA device
+    enum class Status { IDLE = 0, DONE = 1, ERROR = 2 }; //!< Lists the values of the STATUS port
+
+    /*!
+     * \class HbcDma
+     * \brief Derived from HbcPeripheral, represents the DMA controller device
+     *
+     * This class is responsible for emulating a DMA controller moving blocks of memory without the help of HbcCpu.
+     *
+     * <b>Device ID:</b> 0xDA
+     *
+     * A transfer is executed entirely by the host on the tick the command is received, then:
+     * 1. the CMD port is set back to <b>NOP</b>,
+     * 2. the STATUS port is set to <b>DONE</b> (or <b>ERROR</b> if the transfer could not be executed),
+     * 3. an interrupt is triggered with the STATUS port as data.
+     *
+     * Addresses and lengths are given <b>most significant byte first</b>.<br>
+     * A transfer going past the end of the source or the destination is truncated.
+     *
+     * <h2>Control</h2>
+     * Like every HbcPeripheral, HbcDma uses sockets connecting it to HbcIod ports to communicate with HbcCpu.
+     *
+     * <table>
+     *  <caption>List of available ports</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Port</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>STATUS</td>
+     *   <td>Result of the last transfer (0: IDLE, 1: DONE, 2: ERROR)</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>CMD</td>
+     *   <td>Command sent by HbcCpu</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>SRC_0</td>
+     *   <td>Most significant byte of the 20-bit source address <i>(only used by LOAD_EEPROM)</i></td>
+     *  </tr>
+     *  <tr>
+     *   <td>3</td>
+     *   <td>SRC_1</td>
+     *   <td>Middle byte of the source address <i>(most significant byte of a RAM address)</i></td>
+     *  </tr>
+     *  <tr>
+     *   <td>4</td>
+     *   <td>SRC_2</td>
+     *   <td>Least significant byte of the source address</td>
+     *  </tr>
+     *  <tr>
+     *   <td>5</td>
+     *   <td>DST_0</td>
+     *   <td>Most significant byte of the 16-bit destination (RAM address or monitor video memory index)</td>
+     *  </tr>
+     *  <tr>
+     *   <td>6</td>
+     *   <td>DST_1</td>
+     *   <td>Least significant byte of the destination</td>
+     *  </tr>
+     *  <tr>
+     *   <td>7</td>
+     *   <td>LEN_0</td>
+     *   <td>Most significant byte of the 16-bit length</td>
+     *  </tr>
+     *  <tr>
+     *   <td>8</td>
+     *   <td>LEN_1</td>
+     *   <td>Least significant byte of the length</td>
+     *  </tr>
+     *  <tr>
+     *   <td>9</td>
+     *   <td>VALUE</td>
+     *   <td>Value written by FILL_RAM</td>
+     *  </tr>
+     * </table>
+     *
+     * <table>
+     *  <caption>List of available commands</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Command</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>NOP</td>
+     *   <td>No operation</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>COPY_RAM</td>
+     *   <td>Copies LEN bytes of RAM from SRC to DST <i>(overlapping areas are handled)</i></td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>FILL_RAM</td>
+     *   <td>Writes VALUE in LEN bytes of RAM starting at DST</td>
+     *  </tr>
+     *  <tr>
+     *   <td>3</td>
+     *   <td>LOAD_EEPROM</td>
+     *   <td>Copies LEN bytes of the EEPROM starting at SRC to the RAM at DST</td>
+     *  </tr>
+     *  <tr>
+     *   <td>4</td>
+     *   <td>COPY_TO_MONITOR</td>
+     *   <td>Copies LEN bytes of RAM from SRC to the video memory of the current monitor mode, starting at index DST<br>
+     *       In text mode, each character uses 2 bytes (colors, then ASCII code)</td>
+     *  </tr>
+     * </table>
+     *
+     * Any invalid command will result in <b>ERROR</b>.
+     */
+    class HbcDma final : public HbcPeripheral
+    {
+        public:
+            /*!
+             * \param monitor Pointer to the monitor <i>(<b>nullptr</b> if not plugged in)</i>
+             * \param eeprom Pointer to the EEPROM <i>(<b>nullptr</b> if not plugged in)</i>
+             */
+            HbcDma(HbcRam *ram, HbcMonitor *monitor, Eeprom::HbcEeprom *eeprom, HbcIod *iod, Console *consoleOutput);
+
+            void init() override;
+            void tick(bool step) override;
+
+        private:
+            Dword getSourceAddress();
+            Word getDestination();
+            Word getLength();
+
+            bool copyRam(Word source, Word destination, Word length);
+            bool fillRam(Word destination, Word length, Byte value);
+            bool loadEeprom(Dword source, Word destination, Word length);
+            bool copyToMonitor(Word source, Word destination, Word length);
+
+            HbcRam *m_ram;
+            HbcMonitor *m_monitor;
+            Eeprom::HbcEeprom *m_eeprom;
+    };
+}
+
+#endif // DMA_H
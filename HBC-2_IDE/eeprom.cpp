@@ -2,6 +2,9 @@
 
 #include <QFile>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace Eeprom;
 
 HbcEeprom::HbcEeprom(QString binaryFilePath, HbcRam *ram, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
@@ -76,6 +79,21 @@ QByteArray HbcEeprom::getMemoryContent()
     return exportContent;
 }
 
+int HbcEeprom::readMemory(Dword address, Byte *buffer, int size)
+{
+    int copySize(0);
+
+    m_safeMemory.mutex.lock();
+    if (address < (Dword)m_safeMemory.memory.size())
+    {
+        copySize = std::min(size, (int)(m_safeMemory.memory.size() - address));
+        std::memcpy(buffer, m_safeMemory.memory.constData() + address, copySize);
+    }
+    m_safeMemory.mutex.unlock();
+
+    return copySize;
+}
+
 // PRIVATE
 bool HbcEeprom::loadBinaryData()
 {
@@ -14,8 +14,6 @@ namespace Eeprom
     enum class Port { CMD = 0, DATA = 1, ADDR_0 = 2, ADDR_1 = 3, ADDR_2 = 4 }; //!< Lists the ports used by the EEPROM device
     enum class Command { NOP = 0, READ = 1, WRITE = 2 }; //<! Lists the commands used by the EEPROM device
 
-    constexpr int MEMORY_SIZE = 0x100000; //<! 1,048,576 bytes (1 MiB)
-
     struct SafeMemory
     {
         QMutex mutex;
@@ -105,7 +103,7 @@ namespace Eeprom
      *
      * Any invalid command will result in <b>NOP</b>.
      */
-    class HbcEeprom : public HbcPeripheral
+    class HbcEeprom final : public HbcPeripheral
     {
         public:
             HbcEeprom(QString binaryFilePath, HbcRam *ram, HbcIod *iod, Console *consoleOutput);
@@ -115,6 +113,13 @@ namespace Eeprom
 
             QByteArray getMemoryContent();
 
+            /*!
+             * \brief Copies a block of the EEPROM memory, locking it once
+             * \param address 20-bit address of the first byte
+             * \return the number of bytes copied <i>(the copy stops at the end of the memory)</i>
+             */
+            int readMemory(Dword address, Byte *buffer, int size);
+
         private:
             bool loadBinaryData();
 
@@ -19,6 +19,8 @@ HbcEmulator::~HbcEmulator()
 
     wait();
 
+    unplugPeripherals();
+
     m_singleton = nullptr;
 }
 
@@ -118,37 +120,14 @@ bool HbcEmulator::loadProject(QString romBinaryFilePath, QString projectName)
         m_status.projectName = projectName.toStdString();
         m_computer.initialRamData.clear();
 
-        for (unsigned int i(0); i < m_computer.peripherals.size(); i++)
-        {
-            delete m_computer.peripherals[i];
-        }
-        m_computer.peripherals.clear();
-
-        if (m_status.useMonitor)
-        {
-            m_computer.peripherals.push_back(new HbcMonitor(&m_computer.motherboard.m_iod, m_consoleOutput));
-            m_computer.monitor = dynamic_cast<HbcMonitor*>(m_computer.peripherals.back());
-        }
-
-        if (m_status.useRTC)
-        {
-            m_computer.peripherals.push_back(new RealTimeClock::HbcRealTimeClock(&m_computer.motherboard.m_iod, m_consoleOutput));
-            m_computer.rtc = dynamic_cast<RealTimeClock::HbcRealTimeClock*>(m_computer.peripherals.back());
-        }
-
-        if (m_status.useKeyboard)
-        {
-            m_computer.peripherals.push_back(new Keyboard::HbcKeyboard(&m_computer.motherboard.m_iod, m_consoleOutput));
-            m_computer.keyboard = dynamic_cast<Keyboard::HbcKeyboard*>(m_computer.peripherals.back());
-        }
-
         // EEPROM always loaded because this function is called only if the EEPROM is plugged in by the IDE
-        m_computer.peripherals.push_back(new Eeprom::HbcEeprom(romBinaryFilePath, &m_computer.motherboard.m_ram, &m_computer.motherboard.m_iod, m_consoleOutput));
-        m_computer.eeprom = dynamic_cast<Eeprom::HbcEeprom*>(m_computer.peripherals.back());
+        m_status.mutex.lock(); // The emulator thread publishes the monitor frames under that lock
+        plugPeripherals(romBinaryFilePath);
 
         initComputer();
 
         m_status.state = Emulator::State::READY;
+        m_status.mutex.unlock();
         success = true;
     }
     else
@@ -171,35 +150,14 @@ bool HbcEmulator::loadProject(QByteArray initialRamData, QString projectName)
             m_status.projectName = projectName.toStdString();
             m_computer.initialRamData = initialRamData;
 
-            for (unsigned int i(0); i < m_computer.peripherals.size(); i++)
-            {
-                delete m_computer.peripherals[i];
-            }
-            m_computer.peripherals.clear();
-
-            if (m_status.useMonitor)
-            {
-                m_computer.peripherals.push_back(new HbcMonitor(&m_computer.motherboard.m_iod, m_consoleOutput));
-                m_computer.monitor = dynamic_cast<HbcMonitor*>(m_computer.peripherals.back());
-            }
-
-            if (m_status.useRTC)
-            {
-                m_computer.peripherals.push_back(new RealTimeClock::HbcRealTimeClock(&m_computer.motherboard.m_iod, m_consoleOutput));
-                m_computer.rtc = dynamic_cast<RealTimeClock::HbcRealTimeClock*>(m_computer.peripherals.back());
-            }
-
-            if (m_status.useKeyboard)
-            {
-                m_computer.peripherals.push_back(new Keyboard::HbcKeyboard(&m_computer.motherboard.m_iod, m_consoleOutput));
-                m_computer.keyboard = dynamic_cast<Keyboard::HbcKeyboard*>(m_computer.peripherals.back());
-            }
-
             // EEPROM never loaded because this function is only called if the EEPROM is not plugged in by the IDE
+            m_status.mutex.lock(); // The emulator thread publishes the monitor frames under that lock
+            plugPeripherals(QString());
 
             initComputer();
 
             m_status.state = Emulator::State::READY;
+            m_status.mutex.unlock();
             success = true;
         }
         else
@@ -237,9 +195,9 @@ const QByteArray HbcEmulator::getCurrentEepromBinaryData()
 {
     QByteArray exportContent;
 
-    if (m_computer.eeprom != nullptr)
+    if (m_computer.peripherals.get<Eeprom::HbcEeprom>() != nullptr)
     {
-        exportContent = m_computer.eeprom->getMemoryContent();
+        exportContent = m_computer.peripherals.get<Eeprom::HbcEeprom>()->getMemoryContent();
     }
 
     return exportContent;
@@ -270,11 +228,48 @@ void HbcEmulator::useKeyboard(bool enable)
     m_status.useKeyboard = enable;
 }
 
+void HbcEmulator::useDma(bool enable)
+{
+    m_status.useDma = enable;
+}
+
+void HbcEmulator::useStorage(bool enable)
+{
+    m_status.useStorage = enable;
+}
+
+void HbcEmulator::useSerial(bool enable)
+{
+    m_status.useSerial = enable;
+}
+
 void HbcEmulator::setStartPaused(bool enable)
 {
     m_status.startPaused = enable;
 }
 
+void HbcEmulator::setMonitorCapture(Emulator::CaptureFormat format, unsigned int intervalTicks)
+{
+    m_status.captureFormat = format;
+    m_status.captureInterval = intervalTicks;
+}
+
+void HbcEmulator::setKeyboardBuffer(int depth, bool coalesceRepeats)
+{
+    m_status.keyboardBufferDepth = depth;
+    m_status.keyboardCoalesceRepeats = coalesceRepeats;
+}
+
+void HbcEmulator::setLoadPlugins(bool enable)
+{
+    m_status.loadPlugins = enable;
+}
+
+void HbcEmulator::setProjectDirectory(QString dirPath)
+{
+    m_status.projectDirPath = dirPath;
+}
+
 Emulator::State HbcEmulator::getState()
 {
     Emulator::State currentState;
@@ -299,17 +294,17 @@ Emulator::FrequencyTarget HbcEmulator::getFrequencyTarget()
 
 HbcMonitor* HbcEmulator::getHbcMonitor()
 {
-    return m_computer.monitor;
+    return m_computer.peripherals.get<HbcMonitor>();
 }
 
 RealTimeClock::HbcRealTimeClock* HbcEmulator::getHbcRealTimeClock()
 {
-    return m_computer.rtc;
+    return m_computer.peripherals.get<RealTimeClock::HbcRealTimeClock>();
 }
 
 Keyboard::HbcKeyboard* HbcEmulator::getHbcKeyboard()
 {
-    return m_computer.keyboard;
+    return m_computer.peripherals.get<Keyboard::HbcKeyboard>();
 }
 
 void HbcEmulator::setFrequencyTarget(Emulator::FrequencyTarget target)
@@ -333,6 +328,17 @@ HbcEmulator::HbcEmulator(MainWindow *mainWin, Console *consoleOutput)
     m_status.useMonitor = true;
     m_status.useRTC = true;
     m_status.useKeyboard = true;
+    m_status.useDma = false;
+    m_status.useStorage = false;
+    m_status.useSerial = false;
+    m_status.captureFormat = Emulator::CaptureFormat::NONE;
+    m_status.captureInterval = Emulator::DEFAULT_CAPTURE_INTERVAL;
+    m_status.keyboardBufferDepth = Emulator::DEFAULT_KEYBOARD_BUFFER_DEPTH;
+    m_status.keyboardCoalesceRepeats = true;
+    m_status.loadPlugins = false;
+
+    m_computer.tickCount = 0;
+    m_computer.nextPluginDeadline = Plugin::NO_DEADLINE;
 
     m_consoleOutput = consoleOutput;
     m_mainWindow = mainWin;
@@ -350,12 +356,13 @@ void HbcEmulator::run()
     Emulator::State currentState(getState());
     Emulator::FrequencyTarget frequencyTarget(getFrequencyTarget());
 
-    QElapsedTimer frequencyTimer, commandsTimer, frequencyTargetTimer;
+    QElapsedTimer frequencyTimer, commandsTimer, frequencyTargetTimer, monitorFrameTimer;
 
-    int ticks(0), targetTicks(0);
+    int ticks(0), targetTicks(0), framePollLoops(0);
 
     commandsTimer.start();
     frequencyTargetTimer.start();
+    monitorFrameTimer.start();
     while (!stop)
     {
         // --- EXECUTION ---
@@ -412,6 +419,22 @@ void HbcEmulator::run()
             }
         }
 
+        // --- MONITOR FRAME PUBLICATION ---
+        if ((currentState == Emulator::State::RUNNING || currentState == Emulator::State::PAUSED) && ++framePollLoops >= Emulator::FRAME_POLL_LOOPS)
+        {
+            framePollLoops = 0;
+
+            if (monitorFrameTimer.nsecsElapsed() >= Monitor::FRAME_DURATION_US * 1000)
+            {
+                // Same lock as loadProject(), which replaces the monitor from the GUI thread
+                m_status.mutex.lock();
+                publishMonitorFrame();
+                m_status.mutex.unlock();
+
+                monitorFrameTimer.restart();
+            }
+        }
+
         // --- COMMANDS CHECKS ---
         if (commandsTimer.elapsed() >= 100) // in ms
         {
@@ -437,6 +460,9 @@ void HbcEmulator::run()
 
                 tickComputer(true);
                 storeCpuStatus();
+
+                // Also stepped from READY, when frames are not published
+                publishMonitorFrame();
             }
             else if (m_status.command == Emulator::Command::PAUSE)
             {
@@ -455,6 +481,7 @@ void HbcEmulator::run()
 
                 storeCpuStatus(true);
 
+                flushStorage();
                 initComputer();
 
                 m_consoleOutput->log("Emulator stopped");
@@ -465,6 +492,8 @@ void HbcEmulator::run()
                 m_status.state = Emulator::State::NOT_INITIALIZED;
                 m_status.command = Emulator::Command::NONE;
 
+                flushStorage();
+
                 stop = true;
             }
 
@@ -485,13 +514,150 @@ void HbcEmulator::run()
     }
 }
 
+void HbcEmulator::plugPeripherals(QString romBinaryFilePath)
+{
+    unplugPeripherals();
+
+    bool capture = m_status.captureFormat != Emulator::CaptureFormat::NONE && !m_status.projectDirPath.isEmpty();
+
+    if (m_status.useMonitor || capture)
+    {
+        HbcMonitor *monitor = new HbcMonitor(&m_computer.motherboard.m_ram, &m_computer.motherboard.m_iod, m_consoleOutput);
+
+        if (capture)
+            monitor->setCapture(new MonitorCapture(m_status.projectDirPath, m_status.captureFormat, m_status.captureInterval, Monitor::WIDTH, Monitor::HEIGHT, m_consoleOutput));
+
+        m_computer.peripherals.get<HbcMonitor>() = monitor;
+
+        // Ports of the bulk commands, plugged last
+        HbcMonitorExtension *extension = new HbcMonitorExtension(&m_computer.motherboard.m_iod, m_consoleOutput);
+
+        monitor->setExtension(extension);
+        m_computer.peripherals.get<HbcMonitorExtension>() = extension;
+    }
+
+    if (m_status.useRTC)
+    {
+        m_computer.peripherals.get<RealTimeClock::HbcRealTimeClock>() = new RealTimeClock::HbcRealTimeClock(&m_computer.motherboard.m_iod, m_consoleOutput);
+    }
+
+    if (m_status.useKeyboard)
+    {
+        Keyboard::HbcKeyboard *keyboard = new Keyboard::HbcKeyboard(m_status.keyboardBufferDepth, m_status.keyboardCoalesceRepeats, &m_computer.motherboard.m_iod, m_consoleOutput);
+
+        // Ports of the ACK mode, plugged last
+        Keyboard::HbcKeyboardExtension *extension = new Keyboard::HbcKeyboardExtension(&m_computer.motherboard.m_iod, m_consoleOutput);
+
+        keyboard->setExtension(extension);
+        m_computer.peripherals.get<Keyboard::HbcKeyboard>() = keyboard;
+        m_computer.peripherals.get<Keyboard::HbcKeyboardExtension>() = extension;
+    }
+
+    if (!romBinaryFilePath.isEmpty())
+    {
+        m_computer.peripherals.get<Eeprom::HbcEeprom>() = new Eeprom::HbcEeprom(romBinaryFilePath, &m_computer.motherboard.m_ram, &m_computer.motherboard.m_iod, m_consoleOutput);
+    }
+
+    if (m_status.useDma) // Plugged after the devices it transfers data to
+    {
+        m_computer.peripherals.get<Dma::HbcDma>() = new Dma::HbcDma(&m_computer.motherboard.m_ram, m_computer.peripherals.get<HbcMonitor>(), m_computer.peripherals.get<Eeprom::HbcEeprom>(), &m_computer.motherboard.m_iod, m_consoleOutput);
+    }
+
+    if (m_status.useStorage)
+    {
+        m_computer.peripherals.get<Storage::HbcStorage>() = new Storage::HbcStorage(m_status.projectDirPath, &m_computer.motherboard.m_ram, &m_computer.motherboard.m_iod, m_consoleOutput);
+    }
+
+    if (m_status.useSerial)
+    {
+        Serial::HbcSerial *serial = new Serial::HbcSerial(m_status.projectDirPath, Serial::SINK_PANE | Serial::SINK_FILE, &m_computer.motherboard.m_iod, m_consoleOutput);
+
+        // Queued: the worker thread never waits for the IDE
+        connect(serial->getWorker(), SIGNAL(outputReady(QByteArray)), m_mainWindow, SLOT(onSerialOutputReceived(QByteArray)), Qt::ConnectionType::QueuedConnection);
+        connect(serial->getWorker(), SIGNAL(bytesDropped(quint64)), m_mainWindow, SLOT(onSerialBytesDropped(quint64)), Qt::ConnectionType::QueuedConnection);
+
+        m_computer.peripherals.get<Serial::HbcSerial>() = serial;
+    }
+
+    loadPlugins();
+}
+
+void HbcEmulator::unplugPeripherals()
+{
+    m_computer.peripherals.clear();
+
+    for (unsigned int i(0); i < m_computer.plugins.size(); i++)
+    {
+        delete m_computer.plugins[i];
+    }
+    m_computer.plugins.clear();
+}
+
+void HbcEmulator::flushStorage()
+{
+    Storage::HbcStorage *storage = m_computer.peripherals.get<Storage::HbcStorage>();
+
+    if (storage != nullptr)
+        storage->flush(); // Logs its own write errors
+}
+
+void HbcEmulator::loadPlugins()
+{
+    QDir pluginsDir(m_status.projectDirPath + "/" + Plugin::DIRECTORY_NAME);
+
+    if (m_status.projectDirPath.isEmpty() || !pluginsDir.exists())
+        return;
+
+    QStringList files = pluginsDir.entryList(QDir::Files, QDir::Name); // Sorted to plug the devices in a reproducible order
+
+    for (int i(0); i < files.size(); i++)
+    {
+        QString libraryPath = pluginsDir.absoluteFilePath(files[i]);
+
+        if (!QLibrary::isLibrary(libraryPath))
+            continue;
+
+        if (!m_status.loadPlugins) // Never loaded without the consent of the user
+        {
+            m_consoleOutput->log("Plugin skipped, plugins loading disabled in the emulator settings: " + files[i].toStdString());
+            continue;
+        }
+
+        Plugin::HbcPluginPeripheral *plugin = new Plugin::HbcPluginPeripheral(libraryPath, &m_computer.tickCount, &m_computer.motherboard.m_ram, &m_computer.motherboard.m_iod, m_consoleOutput);
+
+        if (plugin->isLoaded())
+        {
+            m_computer.plugins.push_back(plugin);
+            m_consoleOutput->log("Plugin loaded: " + plugin->getName());
+        }
+        else
+        {
+            delete plugin;
+        }
+    }
+}
+
+void HbcEmulator::publishMonitorFrame()
+{
+    HbcMonitor *monitor = m_computer.peripherals.get<HbcMonitor>();
+
+    if (monitor != nullptr)
+        monitor->publishFrame();
+}
+
 void HbcEmulator::initComputer()
 {
     Motherboard::init(m_computer.motherboard, m_computer.initialRamData);
 
-    for (unsigned int i(0); i < m_computer.peripherals.size(); i++)
+    m_computer.tickCount = 0;
+    m_computer.nextPluginDeadline = Plugin::NO_DEADLINE;
+
+    m_computer.peripherals.init();
+
+    for (unsigned int i(0); i < m_computer.plugins.size(); i++)
     {
-        m_computer.peripherals[i]->init();
+        m_computer.plugins[i]->init();
+        m_computer.nextPluginDeadline = std::min(m_computer.nextPluginDeadline, m_computer.plugins[i]->getDeadline());
     }
 }
 
@@ -499,9 +665,45 @@ void HbcEmulator::tickComputer(bool step)
 {
     Motherboard::tick(m_computer.motherboard);
 
-    for (unsigned int i(0); i < m_computer.peripherals.size(); i++)
+    m_computer.peripherals.tick(step);
+
+    m_computer.tickCount++;
+
+    // Plugins are only called on events, keeping the common path free of extra calls
+    if (!m_computer.motherboard.m_iod.m_portWriteEvents.empty() || m_computer.tickCount >= m_computer.nextPluginDeadline)
+    {
+        dispatchPluginEvents();
+    }
+}
+
+void HbcEmulator::dispatchPluginEvents()
+{
+    std::vector<Byte> &portWriteEvents = m_computer.motherboard.m_iod.m_portWriteEvents;
+
+    for (unsigned int i(0); i < portWriteEvents.size(); i++)
+    {
+        for (unsigned int j(0); j < m_computer.plugins.size(); j++)
+        {
+            if (m_computer.plugins[j]->ownsPort(portWriteEvents[i]))
+            {
+                m_computer.plugins[j]->portWritten(portWriteEvents[i]);
+                break;
+            }
+        }
+    }
+    portWriteEvents.clear();
+
+    // Deadlines may have been (re)scheduled by the calls above
+    m_computer.nextPluginDeadline = Plugin::NO_DEADLINE;
+
+    for (unsigned int i(0); i < m_computer.plugins.size(); i++)
     {
-        m_computer.peripherals[i]->tick(step);
+        if (m_computer.plugins[i]->getDeadline() <= m_computer.tickCount)
+        {
+            m_computer.plugins[i]->deadlineReached();
+        }
+
+        m_computer.nextPluginDeadline = std::min(m_computer.nextPluginDeadline, m_computer.plugins[i]->getDeadline());
     }
 }
 
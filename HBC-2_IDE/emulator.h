@@ -14,6 +14,11 @@
 #include "monitor.h"
 #include "realTimeClock.h"
 #include "eeprom.h"
+#include "dma.h"
+#include "storage.h"
+#include "serial.h"
+#include "pluginPeripheral.h"
+#include "peripheralPack.h"
 #include "console.h"
 
 /*!
@@ -25,6 +30,8 @@ namespace Emulator
     enum class State { NOT_INITIALIZED = 0, READY = 1, RUNNING = 2, PAUSED = 3 }; //!< Lists emulator states
     enum class Command { NONE = 0, RUN = 1, STEP = 2, PAUSE = 3, STOP = 4, CLOSE = 5 }; //!< Lists emulator commands
 
+    constexpr int FRAME_POLL_LOOPS = 1024; //!< Loops of the emulator thread between two reads of the monitor frame timer
+
     /*!
      * \struct Status
      * \brief Contains thread safe data to control the emulator
@@ -40,11 +47,28 @@ namespace Emulator
         bool useMonitor; //!< Defined by user before an emulator run
         bool useRTC; //!< Defined by user before an emulator run
         bool useKeyboard; //!< Defined by user before an emulator run
+        bool useDma; //!< Defined by user before an emulator run
+        bool useStorage; //!< Defined by user before an emulator run
+        bool useSerial; //!< Defined by user before an emulator run
         bool startPaused; //!< Defined by user before an emulator run
+        CaptureFormat captureFormat; //!< Defined by user before an emulator run
+        unsigned int captureInterval; //!< In CPU ticks
+        int keyboardBufferDepth; //!< Defined by user before an emulator run
+        bool keyboardCoalesceRepeats; //!< Defined by user before an emulator run
+        QString projectDirPath; //!< Directory of the loaded project, containing the plugins and the storage image <i>(empty = none)</i>
+        bool loadPlugins; //!< Defined by user before loading a project, plugins run native code
 
         std::string projectName;
     };
 
+    /*!
+     * \brief Built-in peripherals, in the order they are plugged into HbcIod
+     *
+     * New devices are appended, so the ports of the existing ones do not move.
+     */
+    using StandardPeripherals = PeripheralPack<HbcMonitor, RealTimeClock::HbcRealTimeClock, Keyboard::HbcKeyboard, Eeprom::HbcEeprom, Dma::HbcDma, Storage::HbcStorage, Serial::HbcSerial,
+                                               HbcMonitorExtension, Keyboard::HbcKeyboardExtension>;
+
     /*!
      * \struct Computer
      * \brief Stores the computer information for the emulator <i>(only used in the emulator thread)</i>
@@ -52,11 +76,11 @@ namespace Emulator
     struct Computer {
         HbcMotherboard motherboard;
 
-        HbcMonitor *monitor;
-        RealTimeClock::HbcRealTimeClock *rtc;
-        Keyboard::HbcKeyboard *keyboard;
-        Eeprom::HbcEeprom *eeprom;
-        std::vector<HbcPeripheral*> peripherals; //!< General vector of the peripherals for simpler systemwide iterations
+        StandardPeripherals peripherals; //!< Built-in peripherals, ticked without virtual calls
+        std::vector<Plugin::HbcPluginPeripheral*> plugins; //!< Event driven peripherals, never ticked (see HbcPluginPeripheral)
+
+        quint64 tickCount; //!< Clock cycles executed since the last initialization
+        quint64 nextPluginDeadline; //!< Earliest deadline scheduled by the plugins
 
         QByteArray initialRamData; //!< Binary data used on emulator first run
         CpuStatus cpuState; //!< Only updated when the emulator is stopped or when requested
@@ -244,7 +268,35 @@ class HbcEmulator : public QThread
         void useMonitor(bool enable);
         void useRTC(bool enable);
         void useKeyboard(bool enable);
+        void useDma(bool enable);
+        void useStorage(bool enable);
+        void useSerial(bool enable);
         void setStartPaused(bool enable);
+        void setLoadPlugins(bool enable); //!< Applies to the next loadProject()
+
+        /*!
+         * \brief Sets the capture of the monitor frames on the next run
+         *
+         * The monitor is plugged even if useMonitor() is disabled, frames being rendered without MonitorDialog.<br>
+         * Only available with a project directory, see MonitorCapture.
+         *
+         * \param intervalTicks Number of CPU ticks between two captured frames
+         */
+        void setMonitorCapture(Emulator::CaptureFormat format, unsigned int intervalTicks);
+
+        /*!
+         * \brief Sets the key events FIFO of the keyboard plugged on the next run (see HbcKeyboard)
+         */
+        void setKeyboardBuffer(int depth, bool coalesceRepeats);
+
+        /*!
+         * \brief Sets the project directory used on the next loadProject() call
+         *
+         * Plugins are loaded from its Plugin::DIRECTORY_NAME subdirectory if setLoadPlugins() allows it, and the storage device only accesses files inside it.
+         *
+         * \param dirPath Project directory <i>(empty to disable plugins and storage)</i>
+         */
+        void setProjectDirectory(QString dirPath);
 
         /*!
          * \return current emulator's state
@@ -306,9 +358,25 @@ class HbcEmulator : public QThread
 
         void run() override;
 
+        /*!
+         * \brief Deletes the current peripherals and plugs the ones selected by the user
+         * \param romBinaryFilePath EEPROM binary file <i>(empty if the EEPROM is not plugged in)</i>
+         */
+        void plugPeripherals(QString romBinaryFilePath);
+        void unplugPeripherals(); //!< Deletes the peripherals and the plugins, their destructors write what they still hold
+        void loadPlugins();
+
+        void flushStorage(); //!< Writes the sectors the guest modified to the storage image
+
+        void publishMonitorFrame(); //!< Call with m_status.mutex locked
         void initComputer();
         void tickComputer(bool step = false);
 
+        /*!
+         * \brief Forwards watched port writes and reached deadlines to the plugins
+         */
+        void dispatchPluginEvents();
+
         void storeCpuStatus(bool lastState = false);
 
         Emulator::Status m_status;
@@ -0,0 +1,293 @@
+#ifndef INSTRUCTIONFORMATS_H
+#define INSTRUCTIONFORMATS_H
+
+/*!
+ * \file instructionFormats.h
+ * \brief Operands accepted by every instruction and their place in the binary instruction
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <array>
+#include <cstdint>
+#include "computerDetails.h"
+
+/*!
+ * \namespace Cpu::Formats
+ * \brief Declarative table of the instruction formats, shared by the assembler and the disassembler
+ *
+ * A format is an opcode, an addressing mode and the list of its operands, in the order they are written in the code.<br>
+ * Every operand tells which tokens it accepts and in which field of the binary instruction it is encoded:
+ * - TokenLine::checkValidity() selects the addressing mode from the first format whose operands match the tokens
+ * - Assembler::getBinaryFromTokenLine() places every token in the field of its operand
+ * - DisassemblyViewer reads the fields back and writes the operands in the same order
+ *
+ * Adding an instruction or an addressing mode to an instruction only needs a new line in FORMATS.
+ */
+namespace Cpu::Formats
+{
+    /*!
+     * \enum OperandType
+     * \brief Kind of value accepted by an operand (more info in the assembly language documentation)
+     */
+    enum class OperandType : uint8_t { NONE,
+                                       REG,    //!< a
+                                       REG16,  //!< [ab]
+                                       IMM8,   //!< 0xXX, 255, label.msb, label.lsb
+                                       PORT8,  //!< 0xXX, 255 (interrupt port)
+                                       DATA16, //!< $0xXXXX, variable
+                                       CODE16  //!< $0xXXXX, label
+                                     };
+
+    /*!
+     * \enum Field
+     * \brief Bits of the instruction holding an operand (see Cpu::R1_MASK and the following masks)
+     */
+    enum class Field : uint8_t { NONE, R1, R2, R3, V1, VX, R1_R2 };
+
+    struct Operand
+    {
+        OperandType type = OperandType::NONE;
+        Field field = Field::NONE;
+    };
+
+    constexpr std::size_t MAX_OPERANDS_NB = 2;
+
+    struct Format
+    {
+        InstructionOpcode opcode = InstructionOpcode::NOP;
+        AddressingMode addrMode = AddressingMode::NONE;
+        std::array<Operand, MAX_OPERANDS_NB> operands{};
+
+        constexpr unsigned int getOperandsNb() const
+        {
+            unsigned int operandsNb(0);
+
+            while (operandsNb < MAX_OPERANDS_NB && operands[operandsNb].type != OperandType::NONE)
+                operandsNb++;
+
+            return operandsNb;
+        }
+    };
+
+    // Operands of the table
+    constexpr Operand REG_R1  = { OperandType::REG,    Field::R1 };
+    constexpr Operand REG_R2  = { OperandType::REG,    Field::R2 };
+    constexpr Operand REG_R3  = { OperandType::REG,    Field::R3 };
+    constexpr Operand REG16   = { OperandType::REG16,  Field::R1_R2 };
+    constexpr Operand IMM8    = { OperandType::IMM8,   Field::V1 };
+    constexpr Operand PORT8   = { OperandType::PORT8,  Field::V1 };
+    constexpr Operand DATA16  = { OperandType::DATA16, Field::VX };
+    constexpr Operand CODE16  = { OperandType::CODE16, Field::VX };
+
+    /*!
+     * \brief Every valid instruction, sorted by opcode
+     */
+    constexpr Format FORMATS[] = {
+        { InstructionOpcode::NOP, AddressingMode::NONE,          {} },
+        { InstructionOpcode::ADC, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::ADC, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::ADC, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::ADD, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::ADD, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::ADD, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::AND, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::AND, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::AND, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::CAL, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::CAL, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::CLC, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLE, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLI, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLN, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLS, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLZ, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CLF, AddressingMode::NONE,          {} },
+        { InstructionOpcode::CMP, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::CMP, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::CMP, AddressingMode::RAMREG_IMMREG, { REG_R3, REG16 } },
+        { InstructionOpcode::DEC, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::DEC, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::DEC, AddressingMode::IMM16,         { DATA16 } },
+        { InstructionOpcode::HLT, AddressingMode::NONE,          {} },
+        { InstructionOpcode::IN,  AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::OUT, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::INC, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::INC, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::INC, AddressingMode::IMM16,         { DATA16 } },
+        { InstructionOpcode::INT, AddressingMode::IMM8,          { PORT8 } },
+        { InstructionOpcode::IRT, AddressingMode::NONE,          {} },
+        { InstructionOpcode::JMC, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMC, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JME, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JME, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JMN, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMN, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JMP, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMP, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JMS, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMS, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JMZ, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMZ, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::JMF, AddressingMode::REG16,         { REG16 } },
+        { InstructionOpcode::JMF, AddressingMode::IMM16,         { CODE16 } },
+        { InstructionOpcode::STR, AddressingMode::RAMREG_IMMREG, { REG16, REG_R3 } }, // [rr] <- r
+        { InstructionOpcode::STR, AddressingMode::REG_RAM,       { DATA16, REG_R1 } }, // $0xXXXX <- r
+        { InstructionOpcode::LOD, AddressingMode::RAMREG_IMMREG, { REG_R3, REG16 } },
+        { InstructionOpcode::LOD, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::MOV, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::MOV, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::NOT, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::NOT, AddressingMode::IMM16,         { DATA16 } },
+        { InstructionOpcode::OR,  AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::OR,  AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::OR,  AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::POP, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::PSH, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::RET, AddressingMode::NONE,          {} },
+        { InstructionOpcode::SHL, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::ASR, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::SHR, AddressingMode::REG,           { REG_R1 } },
+        { InstructionOpcode::STC, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STE, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STI, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STN, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STS, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STZ, AddressingMode::NONE,          {} },
+        { InstructionOpcode::STF, AddressingMode::NONE,          {} },
+        { InstructionOpcode::SUB, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::SUB, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::SUB, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::SBB, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::SBB, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::SBB, AddressingMode::REG_RAM,       { REG_R1, DATA16 } },
+        { InstructionOpcode::XOR, AddressingMode::REG,           { REG_R1, REG_R2 } },
+        { InstructionOpcode::XOR, AddressingMode::REG_IMM8,      { REG_R1, IMM8 } },
+        { InstructionOpcode::XOR, AddressingMode::REG_RAM,       { REG_R1, DATA16 } }
+    };
+
+    constexpr std::size_t FORMATS_NB = sizeof(FORMATS) / sizeof(Format);
+
+    /*!
+     * \brief Formats of an opcode: FORMATS[first] to FORMATS[first + count - 1]
+     */
+    struct OpcodeFormats
+    {
+        uint8_t first = 0;
+        uint8_t count = 0;
+    };
+
+    constexpr std::array<OpcodeFormats, INSTRUCTIONS_NB> makeOpcodeFormats()
+    {
+        std::array<OpcodeFormats, INSTRUCTIONS_NB> opcodeFormats{};
+
+        for (std::size_t f(FORMATS_NB); f > 0; f--)
+        {
+            OpcodeFormats &formats = opcodeFormats[(std::size_t)FORMATS[f - 1].opcode];
+
+            formats.first = (uint8_t)(f - 1);
+            formats.count++;
+        }
+
+        return opcodeFormats;
+    }
+
+    inline constexpr std::array<OpcodeFormats, INSTRUCTIONS_NB> OPCODE_FORMATS = makeOpcodeFormats();
+
+    //! Every opcode has formats, listed together, all with the same number of operands
+    constexpr bool isTableValid()
+    {
+        for (std::size_t i(0); i < INSTRUCTIONS_NB; i++)
+        {
+            const OpcodeFormats &formats = OPCODE_FORMATS[i];
+
+            if (formats.count == 0)
+                return false;
+
+            for (std::size_t f(formats.first); f < formats.first + formats.count; f++)
+            {
+                if ((std::size_t)FORMATS[f].opcode != i || FORMATS[f].getOperandsNb() != FORMATS[formats.first].getOperandsNb())
+                    return false;
+            }
+        }
+
+        return FORMATS_NB < 256;
+    }
+
+    static_assert(isTableValid(), "Instruction formats must be sorted by opcode and cover every opcode");
+
+    /*!
+     * \brief Returns the number of operands written after the mnemonic
+     */
+    constexpr unsigned int getOperandsNb(InstructionOpcode opcode)
+    {
+        return FORMATS[OPCODE_FORMATS[(std::size_t)opcode].first].getOperandsNb();
+    }
+
+    /*!
+     * \brief Returns the format of the instruction, or <b>nullptr</b> if the CPU does not execute it
+     */
+    constexpr const Format* find(InstructionOpcode opcode, AddressingMode addrMode)
+    {
+        if ((std::size_t)opcode >= INSTRUCTIONS_NB)
+            return nullptr;
+
+        const OpcodeFormats &formats = OPCODE_FORMATS[(std::size_t)opcode];
+
+        for (std::size_t f(formats.first); f < formats.first + formats.count; f++)
+        {
+            if (FORMATS[f].addrMode == addrMode)
+                return &FORMATS[f];
+        }
+
+        return nullptr;
+    }
+
+    /*!
+     * \brief Fields of a binary instruction, unused fields being 0
+     */
+    struct Fields
+    {
+        InstructionOpcode opcode = InstructionOpcode::NOP;
+        AddressingMode addrMode = AddressingMode::NONE;
+        Byte r1 = 0x00;
+        Byte r2 = 0x00;
+        Byte r3 = 0x00;
+        Byte v1 = 0x00;
+        Word vX = 0x0000;
+    };
+
+    /*!
+     * \brief Builds the binary instruction (V1 and R3 share bits with VX, a format uses only one of them)
+     */
+    constexpr Dword encode(const Fields& fields)
+    {
+        return (((Dword)fields.opcode << 26) & OPCODE_MASK)
+             | (((Dword)fields.addrMode << 22) & ADDRMODE_MASK)
+             | (((Dword)fields.r1 << 19) & R1_MASK)
+             | (((Dword)fields.r2 << 16) & R2_MASK)
+             | (((Dword)fields.r3 << 8) & R3_MASK)
+             | (((Dword)fields.v1 << 8) & V1_MASK)
+             | (fields.vX & VX_MASK);
+    }
+
+    /*!
+     * \brief Reads every field of a binary instruction, whatever its format
+     */
+    constexpr Fields decode(Dword instruction)
+    {
+        Fields fields;
+
+        fields.opcode = (InstructionOpcode)((instruction & OPCODE_MASK) >> 26);
+        fields.addrMode = (AddressingMode)((instruction & ADDRMODE_MASK) >> 22);
+        fields.r1 = (instruction & R1_MASK) >> 19;
+        fields.r2 = (instruction & R2_MASK) >> 16;
+        fields.r3 = (instruction & R3_MASK) >> 8;
+        fields.v1 = (instruction & V1_MASK) >> 8;
+        fields.vX = instruction & VX_MASK;
+
+        return fields;
+    }
+}
+
+#endif // INSTRUCTIONFORMATS_H
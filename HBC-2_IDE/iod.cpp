@@ -8,8 +8,11 @@ void Iod::init(HbcIod &iod, HbcMotherboard *mb)
     {
         iod.m_ports[i].peripheralId = 0x00;
         iod.m_ports[i].data = 0x00;
+        iod.m_watchedPorts[i] = false;
     }
 
+    iod.m_portWriteEvents.clear();
+
     while (iod.m_interruptsQueue.size() > 0)
         iod.m_interruptsQueue.pop();
 }
@@ -42,6 +45,14 @@ Byte Iod::getPortData(HbcIod &iod, Byte portId)
 void Iod::setPortData(HbcIod &iod, Byte portId, Byte data)
 {
     iod.m_ports[portId].data = data;
+
+    if (iod.m_watchedPorts[portId])
+        iod.m_portWriteEvents.push_back(portId);
+}
+
+void Iod::watchPort(HbcIod &iod, Byte portId, bool watch)
+{
+    iod.m_watchedPorts[portId] = watch;
 }
 
 void Iod::triggerInterrupt(HbcIod &iod, Byte peripheralFirstPortID)
@@ -9,6 +9,7 @@
  * \date 27/08/2023
  */
 #include <queue>
+#include <vector>
 #include "computerDetails.h"
 
 struct HbcMotherboard;
@@ -23,6 +24,9 @@ struct HbcIod
 
     Iod::Port m_ports[Iod::PORTS_NB]; //!< Input/Output Device ports
     std::queue<Iod::Interrupt> m_interruptsQueue; //!< Queue size is defined by INTERRUPT_QUEUE_SIZE
+
+    bool m_watchedPorts[Iod::PORTS_NB]; //!< Ports for which writes are recorded in m_portWriteEvents
+    std::vector<Byte> m_portWriteEvents; //!< IDs of the watched ports written since the last HbcEmulator dispatch
 };
 
 namespace Iod
@@ -50,6 +54,16 @@ namespace Iod
      */
     void setPortData(HbcIod &iod, Byte portId, Byte data);
 
+    /*!
+     * \brief Records (or stops recording) writes made on a port by setPortData()
+     *
+     * Used by event driven peripherals (see HbcPluginPeripheral) so they do not need to poll their ports on each tick.
+     *
+     * \param portId ID of the port (must be inferior to PORTS_NB)
+     * \param watch <b>true</b> to record writes on this port
+     */
+    void watchPort(HbcIod &iod, Byte portId, bool watch);
+
     /*!
      * \brief Triggers an interrupt for HbcCpu
      *
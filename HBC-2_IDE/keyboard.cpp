@@ -1,9 +1,21 @@
 #include "keyboard.h"
 
+#include <algorithm>
+
 using namespace Keyboard;
 
-HbcKeyboard::HbcKeyboard(HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
-{ }
+// PUBLIC
+HbcKeyboard::HbcKeyboard(int bufferDepth, bool coalesceRepeats, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput), m_droppedEventsNb(0), m_coalescedEventsNb(0)
+{
+    m_bufferDepth = std::max(1, std::min(bufferDepth, Emulator::KEYBOARD_BUFFER_MAX_DEPTH));
+    m_coalesceRepeats = coalesceRepeats;
+    m_extension = nullptr;
+
+    m_ackMode = false;
+    m_waitingForAck = false;
+    m_ticksSinceDelivery = 0;
+    m_droppedEventsNbAtClear = 0;
+}
 
 void HbcKeyboard::init()
 {
@@ -13,26 +25,133 @@ void HbcKeyboard::init()
     {
         m_consoleOutput->log("Cannot plug the keyboard, not enough available ports");
     }
+
+    // Keys pressed before the reset are not delivered to the new run
+    KeyEvent event;
+    while (m_events.pop(event));
+
+    m_ackMode = false;
+    m_waitingForAck = false;
+    m_ticksSinceDelivery = 0;
+    m_droppedEventsNbAtClear = m_droppedEventsNb.load(std::memory_order_relaxed);
 }
 
 void HbcKeyboard::tick(bool step)
-{ }
-
-void HbcKeyboard::sendKeyCode(quint32 qtKeyCode, bool release)
 {
-    if (azertyKeyCodeMap.find(qtKeyCode) != azertyKeyCodeMap.end())
-    {
-        Byte keyCode(azertyKeyCodeMap.at(qtKeyCode));
+    if (m_sockets.size() < PORTS_NB)
+        return;
 
-        if (release)
-        {
-            *m_sockets[(int)Port::RELEASED_SCAN_CODE].portDataPointer = keyCode;
-            Iod::triggerInterrupt(*m_iod, m_sockets[(int)Port::RELEASED_SCAN_CODE].portId);
-        }
-        else
+    Command command = (m_extension != nullptr && m_extension->isPlugged()) ? (Command)m_extension->read(ExtensionPort::CMD) : Command::NOP;
+
+    if (command != Command::NOP)
+    {
+        if (command == Command::ACK)
         {
-            *m_sockets[(int)Port::PRESSED_SCAN_CODE].portDataPointer = keyCode;
-            Iod::triggerInterrupt(*m_iod, m_sockets[(int)Port::PRESSED_SCAN_CODE].portId);
+            m_ackMode = true;
+            m_waitingForAck = false;
         }
+        else if (command == Command::CLEAR_DROPPED)
+            m_droppedEventsNbAtClear = m_droppedEventsNb.load(std::memory_order_relaxed);
+
+        m_extension->write(ExtensionPort::CMD, (Byte)Command::NOP);
+    }
+
+    if (m_waitingForAck && ++m_ticksSinceDelivery >= ACK_TIMEOUT_TICKS)
+        m_waitingForAck = false;
+
+    if (!m_waitingForAck && !m_events.empty())
+        deliverEvent();
+}
+
+void HbcKeyboard::sendKeyCode(quint32 qtKeyCode, bool release, bool autoRepeat)
+{
+    if (azertyKeyCodeMap.find(qtKeyCode) == azertyKeyCodeMap.end())
+        return;
+
+    if (autoRepeat && m_coalesceRepeats && (release || !m_events.empty()))
+    {
+        m_coalescedEventsNb.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_events.size() >= m_bufferDepth || !m_events.push({ azertyKeyCodeMap.at(qtKeyCode), release }))
+        m_droppedEventsNb.fetch_add(1, std::memory_order_relaxed);
+}
+
+quint64 HbcKeyboard::getDroppedEventsNb()
+{
+    return m_droppedEventsNb.load(std::memory_order_relaxed);
+}
+
+quint64 HbcKeyboard::getCoalescedEventsNb()
+{
+    return m_coalescedEventsNb.load(std::memory_order_relaxed);
+}
+
+void HbcKeyboard::setExtension(HbcKeyboardExtension *extension)
+{
+    m_extension = extension;
+}
+
+// PRIVATE
+void HbcKeyboard::deliverEvent()
+{
+    KeyEvent event;
+    m_events.pop(event);
+
+    Port port = (event.release ? Port::RELEASED_SCAN_CODE : Port::PRESSED_SCAN_CODE);
+    quint64 droppedEventsNb = m_droppedEventsNb.load(std::memory_order_relaxed) - m_droppedEventsNbAtClear;
+    Byte status(0x00);
+
+    if (!m_events.empty())
+        status |= EVENTS_PENDING;
+
+    if (droppedEventsNb > 0)
+        status |= EVENTS_DROPPED;
+
+    if (m_extension != nullptr && m_extension->isPlugged())
+    {
+        m_extension->write(ExtensionPort::STATUS, status);
+        m_extension->write(ExtensionPort::DROPPED, (Byte)std::min(droppedEventsNb, (quint64)0xFF));
     }
+
+    *m_sockets[(int)port].portDataPointer = event.scanCode;
+
+    Iod::triggerInterrupt(*m_iod, m_sockets[(int)port].portId);
+
+    m_waitingForAck = m_ackMode; // Programs never sending ACK get every event without delay
+    m_ticksSinceDelivery = 0;
+}
+
+
+// ===== HbcKeyboardExtension class =====
+HbcKeyboardExtension::HbcKeyboardExtension(HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+{ }
+
+void HbcKeyboardExtension::init()
+{
+    m_sockets = Iod::requestPortsConnexions(*m_iod, EXTENSION_DEVICE_ID, EXTENSION_PORTS_NB);
+
+    if (m_sockets.size() < EXTENSION_PORTS_NB)
+    {
+        m_consoleOutput->log("Cannot plug the keyboard extension, not enough available ports");
+    }
+}
+
+void HbcKeyboardExtension::tick(bool step)
+{ }
+
+bool HbcKeyboardExtension::isPlugged() const
+{
+    return m_sockets.size() >= EXTENSION_PORTS_NB;
+}
+
+Byte HbcKeyboardExtension::read(ExtensionPort port) const
+{
+    return *m_sockets[(int)port].portDataPointer;
+}
+
+void HbcKeyboardExtension::write(ExtensionPort port, Byte data)
+{
+    *m_sockets[(int)port].portDataPointer = data;
 }
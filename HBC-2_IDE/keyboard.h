@@ -8,8 +8,10 @@
  * \version 0.1
  * \date 08/09/2023
  */
+#include <atomic>
 #include <QKeyEvent>
 #include "peripheral.h"
+#include "spscRing.h"
 
 /*!
  * \namespace Keyboard
@@ -19,9 +21,36 @@
 namespace Keyboard
 {
     constexpr Byte DEVICE_ID = 0xAA; //!< Random to "look" nice
+    constexpr Byte EXTENSION_DEVICE_ID = 0xAB; //!< Next to DEVICE_ID, see HbcKeyboardExtension
+
+    constexpr int ACK_TIMEOUT_TICKS = 20000; //!< Once ACK was used, an unacknowledged event is replaced by the next one after this delay
 
     constexpr int PORTS_NB = 2;
+    constexpr int EXTENSION_PORTS_NB = 3;
     enum class Port { PRESSED_SCAN_CODE = 0, RELEASED_SCAN_CODE = 1 }; //!< Lists the ports used by the keyboard device
+    enum class ExtensionPort { CMD = 0, STATUS = 1, DROPPED = 2 }; //!< Lists the ports used by the keyboard extension device
+    enum class Command { NOP = 0, ACK = 1, CLEAR_DROPPED = 2 }; //!< Lists the commands used by the keyboard device
+
+    /*!
+     * \brief Bits of the STATUS port
+     */
+    enum StatusFlag : Byte
+    {
+        EVENTS_PENDING = 0x01, //!< More events are waiting after the delivered one
+        EVENTS_DROPPED = 0x02 //!< Events were lost since the last CLEAR_DROPPED
+    };
+
+    /*!
+     * \struct KeyEvent
+     * \brief Key event waiting to be delivered to the guest program
+     */
+    struct KeyEvent
+    {
+        Byte scanCode;
+        bool release;
+    };
+
+    using EventRing = SpscRing<KeyEvent, Emulator::KEYBOARD_BUFFER_MAX_DEPTH>;
 
     const std::map<quint32, Byte> azertyKeyCodeMap = {
     { 0x76, 0x01 },
@@ -117,6 +146,15 @@ namespace Keyboard
      *
      * <b>Device ID:</b> 0xAA
      *
+     * Key events are sent by the GUI thread to a lock-free FIFO, and only the emulator thread writes the ports.<br>
+     * One event is delivered (scan code written, interrupt triggered) per tick, like the keys were sent before the FIFO existed.<br>
+     * Once the guest program sent the <b>ACK</b> command to HbcKeyboardExtension, the next event is only delivered when the previous one
+     * was acknowledged, or ACK_TIMEOUT_TICKS after it was delivered. That mode lasts until the next init().
+     *
+     * When the FIFO holds more events than the configured depth, new events are dropped and counted.<br>
+     * If repeats coalescing is enabled, auto-repeated key presses are dropped while events are waiting, and auto-repeated releases are ignored:
+     * a held key is seen as a sequence of presses followed by a single release.
+     *
      * <h2>Communication</h2>
      * Like every HbcPeripheral, HbcKeyboard uses sockets connecting it to HbcIod ports to send its scan code to the HbcCpu.
      *
@@ -135,22 +173,105 @@ namespace Keyboard
      *  <tr>
      *   <td>1</td>
      *   <td>RELEASED_SCAN_CODE</td>
-     *   <td>Holds the scan code of the pressed key</td>
+     *   <td>Holds the scan code of the released key</td>
      *  </tr>
      * </table>
      *
      * <b>AZERTY map</b>
      * \image html keyboard_azerty_map.png
      */
-    class HbcKeyboard : public HbcPeripheral
+    class HbcKeyboardExtension;
+
+    class HbcKeyboard final : public HbcPeripheral
     {
         public:
-            HbcKeyboard(HbcIod *iod, Console *consoleOutput);
+            /*!
+             * \param bufferDepth Maximum number of events waiting for the guest program <i>(at most KEYBOARD_BUFFER_MAX_DEPTH)</i>
+             * \param coalesceRepeats Drops auto-repeated keys while events are waiting
+             */
+            HbcKeyboard(int bufferDepth, bool coalesceRepeats, HbcIod *iod, Console *consoleOutput);
 
             void init() override;
             void tick(bool step) override;
 
-            void sendKeyCode(quint32 qtKeyCode, bool release);
+            /*!
+             * \brief <b>GUI thread</b>, adds a key event to the FIFO
+             * \param autoRepeat Set if the event was generated by the key repeat of the host
+             */
+            void sendKeyCode(quint32 qtKeyCode, bool release, bool autoRepeat = false);
+
+            quint64 getDroppedEventsNb(); //!< Since the keyboard was plugged, thread safe
+            quint64 getCoalescedEventsNb(); //!< Since the keyboard was plugged, thread safe
+
+            /*!
+             * \brief Gives the ports of the ACK mode, the extension is not owned by the keyboard
+             */
+            void setExtension(HbcKeyboardExtension *extension);
+
+        private:
+            void deliverEvent();
+
+            HbcKeyboardExtension *m_extension; //!< <b>nullptr</b> if not plugged
+
+            EventRing m_events;
+            std::size_t m_bufferDepth;
+            bool m_coalesceRepeats;
+
+            std::atomic<quint64> m_droppedEventsNb;
+            std::atomic<quint64> m_coalescedEventsNb;
+
+            // Emulator thread only
+            bool m_ackMode; //!< Set by the first ACK command
+            bool m_waitingForAck;
+            int m_ticksSinceDelivery;
+            quint64 m_droppedEventsNbAtClear; //!< Value of m_droppedEventsNb on the last CLEAR_DROPPED
+    };
+
+    /*!
+     * \class HbcKeyboardExtension
+     * \brief Derived from HbcPeripheral, holds the acknowledgment and status ports of HbcKeyboard
+     *
+     * <b>Device ID:</b> 0xAB
+     *
+     * Plugged after every other built-in device, so the ports of HbcKeyboard and of the devices plugged after it
+     * are the same as before these ports existed.<br>
+     * The extension executes nothing: HbcKeyboard reads and writes its ports.
+     *
+     * <table>
+     *  <caption>List of available ports</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Port</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>CMD</td>
+     *   <td>Command sent by HbcCpu (0: NOP, 1: ACK, 2: CLEAR_DROPPED), set back to <b>NOP</b> once executed</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>STATUS</td>
+     *   <td>Bit 0: EVENTS_PENDING, bit 1: EVENTS_DROPPED</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>DROPPED</td>
+     *   <td>Number of events lost since the last CLEAR_DROPPED <i>(saturates at 255)</i></td>
+     *  </tr>
+     * </table>
+     */
+    class HbcKeyboardExtension final : public HbcPeripheral
+    {
+        public:
+            HbcKeyboardExtension(HbcIod *iod, Console *consoleOutput);
+
+            void init() override;
+            void tick(bool step) override; //!< No operation, see class description
+
+            bool isPlugged() const; //!< <b>false</b> if HbcIod had not enough ports
+            Byte read(ExtensionPort port) const;
+            void write(ExtensionPort port, Byte data);
     };
 }
 
@@ -0,0 +1,142 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+/*!
+ * \file keywords.h
+ * \brief Perfect hash table of the reserved words of the assembly language, built at compile time
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "computerDetails.h"
+
+/*!
+ * \namespace Token::Keywords
+ * \brief Classifies mnemonics, registers, macros and preprocessor directives with one hash and one comparison
+ *
+ * Every keyword has its own slot in SLOT_TABLE: a string hashing to an empty slot, or to the slot of another keyword, is not a keyword.<br>
+ * The hash seed is searched by the compiler, so adding a mnemonic or a register to computerDetails.h does not need any other change.
+ */
+namespace Token::Keywords
+{
+    enum class KeywordType : uint8_t { NONE, INSTRUCTION, REGISTER, DEFINE, INCLUDE, DATA, DIRECTIVE };
+
+    struct Keyword
+    {
+        std::string_view str;
+        KeywordType type = KeywordType::NONE;
+        uint8_t id = 0; //!< Cpu::InstructionOpcode, Cpu::Register or Token::Directive
+    };
+
+    constexpr std::size_t MACROS_NB = 3;
+    constexpr std::size_t DIRECTIVES_NB = 7;
+    constexpr std::array<std::string_view, DIRECTIVES_NB> DIRECTIVES = { ".macro", ".endm", ".if", ".ifdef", ".ifndef", ".else", ".endif" }; //!< In the order of Token::Directive
+    constexpr std::size_t KEYWORDS_NB = Cpu::INSTRUCTIONS_NB + Cpu::REGISTERS_NB + MACROS_NB + DIRECTIVES_NB;
+    constexpr std::size_t SLOTS_NB = 512; //!< About 8 slots per keyword, a seed is found in a few tries
+    constexpr std::size_t MAX_KEYWORD_SIZE = 8; //!< ".include"
+    constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+    static_assert(KEYWORDS_NB < EMPTY_SLOT, "Keyword indexes must fit in a slot");
+
+    constexpr std::array<Keyword, KEYWORDS_NB> makeKeywords()
+    {
+        std::array<Keyword, KEYWORDS_NB> keywords{};
+        std::size_t k(0);
+
+        for (std::size_t i(0); i < Cpu::INSTRUCTIONS_NB; i++)
+            keywords[k++] = { Cpu::instrNames[i], KeywordType::INSTRUCTION, (uint8_t)i };
+
+        for (std::size_t i(0); i < Cpu::REGISTERS_NB; i++)
+            keywords[k++] = { Cpu::regNames[i], KeywordType::REGISTER, (uint8_t)i };
+
+        keywords[k++] = { ".define", KeywordType::DEFINE, 0 };
+        keywords[k++] = { ".include", KeywordType::INCLUDE, 0 };
+        keywords[k++] = { ".data", KeywordType::DATA, 0 };
+
+        for (std::size_t i(0); i < DIRECTIVES_NB; i++)
+            keywords[k++] = { DIRECTIVES[i], KeywordType::DIRECTIVE, (uint8_t)i };
+
+        return keywords;
+    }
+
+    inline constexpr std::array<Keyword, KEYWORDS_NB> KEYWORDS = makeKeywords();
+
+    //! FNV-1a 32 bits with a seed instead of the offset basis
+    constexpr uint32_t hash(std::string_view str, uint32_t seed)
+    {
+        uint32_t result(seed);
+
+        for (std::size_t i(0); i < str.size(); i++)
+        {
+            result ^= (uint8_t)str[i];
+            result *= 0x01000193;
+        }
+
+        return result ^ (result >> 16);
+    }
+
+    struct SlotTable
+    {
+        uint32_t seed = 0; //!< 0 if no seed was found
+        std::array<uint8_t, SLOTS_NB> indexes{}; //!< Index in KEYWORDS, or EMPTY_SLOT
+    };
+
+    constexpr SlotTable makeSlotTable()
+    {
+        for (uint32_t seed(0x811C9DC5); seed < 0x811C9DC5 + 4096; seed++)
+        {
+            SlotTable table;
+            bool collision(false);
+
+            table.seed = seed;
+
+            for (std::size_t s(0); s < SLOTS_NB; s++)
+                table.indexes[s] = EMPTY_SLOT;
+
+            for (std::size_t k(0); k < KEYWORDS_NB && !collision; k++)
+            {
+                std::size_t slot(hash(KEYWORDS[k].str, seed) % SLOTS_NB);
+
+                if (table.indexes[slot] != EMPTY_SLOT)
+                    collision = true;
+                else
+                    table.indexes[slot] = (uint8_t)k;
+            }
+
+            if (!collision)
+                return table;
+        }
+
+        return SlotTable();
+    }
+
+    inline constexpr SlotTable SLOT_TABLE = makeSlotTable();
+
+    static_assert(SLOT_TABLE.seed != 0, "No perfect hash seed found for the keywords, increase SLOTS_NB");
+
+    /*!
+     * \brief Returns the keyword written <i>str</i>, or a keyword of type NONE
+     */
+    constexpr Keyword find(std::string_view str)
+    {
+        if (str.empty() || str.size() > MAX_KEYWORD_SIZE)
+            return Keyword();
+
+        uint8_t index(SLOT_TABLE.indexes[hash(str, SLOT_TABLE.seed) % SLOTS_NB]);
+
+        if (index == EMPTY_SLOT || KEYWORDS[index].str != str)
+            return Keyword();
+
+        return KEYWORDS[index];
+    }
+
+    static_assert(find("xor").type == KeywordType::INSTRUCTION && find("xor").id == (uint8_t)Cpu::InstructionOpcode::XOR, "Keywords table is inconsistent");
+    static_assert(find("y").type == KeywordType::REGISTER && find("y").id == (uint8_t)Cpu::Register::Y, "Keywords table is inconsistent");
+    static_assert(find(".ifndef").type == KeywordType::DIRECTIVE && find(".ifndef").id == 4, "Keywords table is inconsistent");
+    static_assert(find(".include").type == KeywordType::INCLUDE && find("label").type == KeywordType::NONE, "Keywords table is inconsistent");
+}
+
+#endif // KEYWORDS_H
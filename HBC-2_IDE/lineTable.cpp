@@ -0,0 +1,162 @@
+#include "lineTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace Assembly;
+
+// PUBLIC
+void LineTable::clear()
+{
+    m_filesPaths.clear();
+    m_filesIds.clear();
+    m_rows.clear();
+    m_rowsByLine.clear();
+}
+
+void LineTable::add(uint32_t address, const QString &filePath, unsigned int lineNb)
+{
+    auto inserted = m_filesIds.emplace(filePath, (uint32_t)m_filesPaths.size());
+
+    if (inserted.second) // New file
+        m_filesPaths.push_back(filePath);
+
+    m_rows.push_back({ address, inserted.first->second, lineNb });
+}
+
+void LineTable::buildIndexes()
+{
+    // Routine blocks are converted by address, so the rows usually are already sorted
+    if (!std::is_sorted(m_rows.begin(), m_rows.end(), [](const Row &a, const Row &b) { return a.address < b.address; }))
+        std::stable_sort(m_rows.begin(), m_rows.end(), [](const Row &a, const Row &b) { return a.address < b.address; });
+
+    m_rowsByLine.resize(m_rows.size());
+    std::iota(m_rowsByLine.begin(), m_rowsByLine.end(), 0);
+
+    std::sort(m_rowsByLine.begin(), m_rowsByLine.end(), [this](uint32_t a, uint32_t b)
+    {
+        const Row &rowA(m_rows[a]), &rowB(m_rows[b]);
+
+        if (rowA.fileId != rowB.fileId)
+            return rowA.fileId < rowB.fileId;
+
+        if (rowA.lineNb != rowB.lineNb)
+            return rowA.lineNb < rowB.lineNb;
+
+        return rowA.address < rowB.address;
+    });
+}
+
+std::size_t LineTable::size() const
+{
+    return m_rows.size();
+}
+
+ByteDebugSymbol LineTable::at(std::size_t index, uint32_t &address) const
+{
+    address = m_rows[index].address;
+
+    return { m_filesPaths[m_rows[index].fileId], m_rows[index].lineNb };
+}
+
+ByteDebugSymbol LineTable::findSymbol(uint32_t address) const
+{
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), address, [](const Row &row, uint32_t address) { return row.address < address; });
+
+    if (it == m_rows.end() || it->address != address)
+        return ByteDebugSymbol();
+
+    return { m_filesPaths[it->fileId], it->lineNb };
+}
+
+bool LineTable::findAddress(const QString &filePath, unsigned int lineNb, uint32_t &address) const
+{
+    auto file = m_filesIds.find(filePath);
+
+    if (file == m_filesIds.end())
+        return false;
+
+    uint32_t fileId(file->second);
+
+    auto it = std::partition_point(m_rowsByLine.begin(), m_rowsByLine.end(), [this, fileId, lineNb](uint32_t rowIndex)
+    {
+        const Row &row(m_rows[rowIndex]);
+
+        return (row.fileId < fileId) || (row.fileId == fileId && row.lineNb < lineNb);
+    });
+
+    if (it == m_rowsByLine.end() || m_rows[*it].fileId != fileId || m_rows[*it].lineNb != lineNb)
+        return false;
+
+    address = m_rows[*it].address;
+
+    return true;
+}
+
+void LineTable::write(QDataStream &stream) const
+{
+    stream.writeRawData("HBCL", 4);
+    stream << FORMAT_VERSION << (quint32)m_filesPaths.size();
+
+    for (const QString &filePath : m_filesPaths)
+        stream << filePath;
+
+    stream << (quint32)m_rows.size();
+
+    for (const Row &row : m_rows)
+        stream << (quint32)row.address << (quint32)row.fileId << (quint32)row.lineNb;
+}
+
+bool LineTable::read(QDataStream &stream)
+{
+    char magic[4];
+    quint32 version, filesNb, rowsNb;
+
+    clear();
+
+    if (stream.readRawData(magic, 4) != 4 || memcmp(magic, "HBCL", 4) != 0)
+        return false;
+
+    stream >> version >> filesNb;
+
+    if (version != FORMAT_VERSION)
+        return false;
+
+    for (quint32 f(0); f < filesNb && stream.status() == QDataStream::Ok; f++)
+    {
+        QString filePath;
+
+        stream >> filePath;
+
+        m_filesIds.emplace(filePath, (uint32_t)m_filesPaths.size());
+        m_filesPaths.push_back(filePath);
+    }
+
+    stream >> rowsNb;
+
+    for (quint32 r(0); r < rowsNb && stream.status() == QDataStream::Ok; r++)
+    {
+        quint32 address, fileId, lineNb;
+
+        stream >> address >> fileId >> lineNb;
+
+        if (fileId >= m_filesPaths.size())
+        {
+            clear();
+            return false;
+        }
+
+        m_rows.push_back({ address, fileId, lineNb });
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        clear();
+        return false;
+    }
+
+    buildIndexes();
+
+    return true;
+}
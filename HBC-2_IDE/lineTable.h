@@ -0,0 +1,88 @@
+#ifndef LINETABLE_H
+#define LINETABLE_H
+
+/*!
+ * \file lineTable.h
+ * \brief Debug symbols of an assembled binary: source file and line of each instruction
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <QDataStream>
+#include <QString>
+
+namespace Assembly
+{
+    /*!
+     * \brief Debug symbol storing the original code file and line number
+     *
+     * Associated to the first byte of an instruction <b>only</b>
+     */
+    struct ByteDebugSymbol
+    {
+        QString filePath = "";
+        unsigned int lineNb = 0;
+    };
+
+    /*!
+     * \class LineTable
+     * \brief Rows of (address, file, line) sorted by address, the files paths are stored once in a strings table
+     *
+     * Replaces one ByteDebugSymbol per byte of memory: 12 bytes per instruction, whatever the memory size.<br>
+     * Both queries are binary searches, a second index sorts the rows by file and line for the breakpoints.
+     *
+     * Serialized by write() as "HBCL", the format version, the files paths, then the rows <i>(QDataStream, big endian)</i>.
+     */
+    class LineTable
+    {
+        public:
+            void clear();
+
+            /*!
+             * \brief Adds the instruction starting at <i>address</i>, call buildIndexes() once all are added
+             */
+            void add(uint32_t address, const QString &filePath, unsigned int lineNb);
+            void buildIndexes();
+
+            std::size_t size() const; //!< Number of instructions
+
+            /*!
+             * \return the source of the <i>index</i>-th instruction by address, and its address
+             */
+            ByteDebugSymbol at(std::size_t index, uint32_t &address) const;
+
+            /*!
+             * \return an empty symbol if <i>address</i> is not the first byte of an instruction
+             */
+            ByteDebugSymbol findSymbol(uint32_t address) const;
+
+            /*!
+             * \brief Finds the lowest address of the instructions written at that line
+             * \return <b>false</b> if no instruction comes from that line
+             */
+            bool findAddress(const QString &filePath, unsigned int lineNb, uint32_t &address) const;
+
+            void write(QDataStream &stream) const;
+            bool read(QDataStream &stream); //!< Returns <b>false</b> if the data is not a line table of this version
+
+            static constexpr quint32 FORMAT_VERSION = 1;
+
+        private:
+            struct Row
+            {
+                uint32_t address;
+                uint32_t fileId; //!< Index in m_filesPaths
+                uint32_t lineNb;
+            };
+
+            std::vector<QString> m_filesPaths;
+            std::map<QString, uint32_t> m_filesIds; //!< Index in m_filesPaths by path, to add rows and to find the address of a line
+            std::vector<Row> m_rows; //!< By address once indexed
+            std::vector<uint32_t> m_rowsByLine; //!< Indexes in m_rows, by file, line and address
+    };
+}
+
+#endif // LINETABLE_H
@@ -0,0 +1,333 @@
+#include "linker.h"
+
+#include <algorithm>
+#include <cstring>
+#include "assembler.h"
+
+using namespace Assembly;
+
+// PUBLIC
+bool Linker::link(const std::vector<const ObjectFile*> &objects, bool targetEeprom, PlacementPolicy policy, BinaryWithSymbols &binary, Error &error)
+{
+    m_routines.clear();
+    m_definedVars.clear();
+    m_undefinedVars.clear();
+    m_symbols.clear();
+    m_memoryUse = 0;
+
+    // Variables without address are placed after the reserved memory
+    m_memoryMap.init({ Cpu::PROGRAM_START_ADDRESS, (uint32_t)(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE) - 1 });
+
+    if (!listSections(objects, targetEeprom, error))
+        return false;
+
+    if (!placeRoutines(targetEeprom, error))
+        return false;
+
+    if (!placeVariables(policy, error))
+        return false;
+
+    bindSymbols();
+
+    return writeBinary(targetEeprom, binary, error);
+}
+
+Fragmentation Linker::getFragmentation() const
+{
+    return m_memoryMap.getFragmentation();
+}
+
+uint32_t Linker::getMemoryUse() const
+{
+    return m_memoryUse;
+}
+
+
+// PRIVATE
+bool Linker::listSections(const std::vector<const ObjectFile*> &objects, bool targetEeprom, Error &error)
+{
+    uint32_t memorySize(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE);
+
+    for (const ObjectFile *object : objects)
+    {
+        if (object->targetEeprom != targetEeprom)
+        {
+            error.originFilePath = "";
+            error.originLineNb = 0;
+            error.originColumnNb = 0;
+            error.type = Token::ErrorType::OBJECT_TARGET;
+            error.additionalInfo = object->name.toStdString() + "\"";
+
+            return false;
+        }
+
+        for (const Section &section : object->sections)
+        {
+            Placement placement{ object, &section, { ADDRESS_NOT_SET, ADDRESS_NOT_SET } };
+
+            m_memoryUse += placement.size();
+
+            if (section.fixedAddress)
+                placement.range = { section.address, section.address + placement.size() - 1 };
+
+            if (section.type == SectionType::ROUTINE)
+            {
+                // Each object checked its own routines, the same name in two objects is only found here
+                SymbolId symbol(m_symbols.intern(object->names[section.name]));
+
+                if (m_symbols.getBinding(symbol, SymbolKind::ROUTINE) != NO_BINDING)
+                    return sectionError(placement, Token::ErrorType::LABEL_ALREADY_USED, "", error);
+
+                if (section.fixedAddress && (section.address >= memorySize || placement.size() >= memorySize - section.address)) // Without overflow
+                    return sectionError(placement, Token::ErrorType::LABEL_MEM_USE, "", error);
+
+                m_symbols.bind(symbol, SymbolKind::ROUTINE, (int)m_routines.size());
+                m_routines.push_back(placement);
+            }
+            else if (section.fixedAddress)
+            {
+                if (section.address >= memorySize || placement.size() > memorySize - section.address) // Without overflow
+                    return sectionError(placement, Token::ErrorType::DATA_MEM_USE, "", error);
+
+                // Check if that data definition does not overlap any other one
+                const Reservation *overlapped(m_memoryMap.reserve(placement.range, SymbolKind::VARIABLE, (int)m_definedVars.size()));
+
+                if (overlapped != nullptr)
+                {
+                    const Placement &other(m_definedVars[overlapped->index]);
+
+                    return sectionError(placement, Token::ErrorType::DATA_OVERLAP, other.object->names[other.section->name] + "\"", error);
+                }
+
+                m_definedVars.push_back(placement);
+            }
+            else
+                m_undefinedVars.push_back(placement);
+        }
+    }
+
+    // A label without instruction at the end of the last file is not stored as a section
+    if (m_symbols.getBinding(m_symbols.find("_start"), SymbolKind::ROUTINE) == NO_BINDING)
+    {
+        error.originFilePath = "";
+        error.originLineNb = 0;
+        error.originColumnNb = 0;
+        error.type = Token::ErrorType::START_ROUTINE_MISSING;
+        error.additionalInfo = "";
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Linker::placeRoutines(bool targetEeprom, Error &error)
+{
+    uint32_t nextAvailableAddress(ADDRESS_NOT_SET);
+
+    for (unsigned int i(0); i < m_routines.size(); i++)
+    {
+        if (!m_routines[i].section->fixedAddress) // Follows the previous routine
+        {
+            m_routines[i].range.begin = nextAvailableAddress;
+            m_routines[i].range.end = nextAvailableAddress + m_routines[i].size() - 1;
+
+            if (m_routines[i].range.end >= (uint32_t)(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE))
+            {
+                error.originFilePath = "";
+                error.originLineNb = 0;
+                error.originColumnNb = 0;
+                error.type = Token::ErrorType::MEM_USE;
+                error.additionalInfo = "";
+
+                return false;
+            }
+        }
+
+        nextAvailableAddress = m_routines[i].range.begin + m_routines[i].size();
+    }
+
+    // Check if any routine overlaps another one
+    MemoryMap routinesMap;
+    const Reservation *overlapped;
+
+    routinesMap.init({ 1, 0 }); // No free space, only used to find overlaps
+
+    for (unsigned int i(0); i < m_routines.size(); i++)
+    {
+        overlapped = routinesMap.reserve(m_routines[i].range, SymbolKind::ROUTINE, (int)i);
+
+        if (overlapped != nullptr)
+            return sectionError(m_routines[overlapped->index], Token::ErrorType::ROUTINE_OVERLAP, m_routines[i].object->names[m_routines[i].section->name] + "\"", error);
+    }
+
+    // Check if any data definition overlaps a routine
+    for (unsigned int i(0); i < m_routines.size(); i++)
+    {
+        overlapped = m_memoryMap.reserve(m_routines[i].range, SymbolKind::ROUTINE, (int)i);
+
+        if (overlapped != nullptr)
+        {
+            return sectionError(m_definedVars[overlapped->index], Token::ErrorType::DATA_OVERWRITES_INSTR,
+                                m_routines[i].object->names[m_routines[i].section->name] + "\", try automatic data address calculation", error);
+        }
+    }
+
+    return true;
+}
+
+bool Linker::placeVariables(PlacementPolicy policy, Error &error)
+{
+    if (policy == PlacementPolicy::BEST_FIT) // Large variables first, small ones then fill the gaps
+    {
+        std::stable_sort(m_undefinedVars.begin(), m_undefinedVars.end(), [](const Placement &a, const Placement &b) { return a.size() > b.size(); });
+    }
+
+    m_definedVars.reserve(m_definedVars.size() + m_undefinedVars.size());
+
+    for (unsigned int i(0); i < m_undefinedVars.size(); i++)
+    {
+        if (!m_memoryMap.allocate(m_undefinedVars[i].size(), policy, SymbolKind::VARIABLE, (int)m_definedVars.size(), m_undefinedVars[i].range.begin))
+        {
+            error.originFilePath = "";
+            error.originLineNb = 0;
+            error.originColumnNb = 0;
+            error.type = Token::ErrorType::MEM_USE;
+            error.additionalInfo = "";
+
+            return false;
+        }
+
+        m_undefinedVars[i].range.end = m_undefinedVars[i].range.begin + m_undefinedVars[i].size() - 1;
+        m_definedVars.push_back(m_undefinedVars[i]);
+    }
+
+    m_undefinedVars.clear();
+
+    return true;
+}
+
+void Linker::bindSymbols()
+{
+    SymbolId symbol;
+
+    // Addresses are final: bind the symbols to their indexes once sorted
+    std::stable_sort(m_definedVars.begin(), m_definedVars.end(), [](const Placement &a, const Placement &b) { return a.range.begin < b.range.begin; });
+    std::stable_sort(m_routines.begin(), m_routines.end(), [](const Placement &a, const Placement &b) { return a.range.begin < b.range.begin; });
+
+    m_symbols.clearBindings(SymbolKind::VARIABLE);
+    m_symbols.clearBindings(SymbolKind::ROUTINE);
+
+    for (unsigned int i(0); i < m_definedVars.size(); i++)
+    {
+        symbol = m_symbols.intern(m_definedVars[i].object->names[m_definedVars[i].section->name]);
+
+        if (m_symbols.getBinding(symbol, SymbolKind::VARIABLE) == NO_BINDING) // The variable with the lowest address is used
+            m_symbols.bind(symbol, SymbolKind::VARIABLE, i);
+    }
+
+    for (unsigned int i(0); i < m_routines.size(); i++)
+    {
+        m_symbols.bind(m_symbols.intern(m_routines[i].object->names[m_routines[i].section->name]), SymbolKind::ROUTINE, i);
+    }
+}
+
+bool Linker::findSymbolAddress(const std::string &name, uint32_t &address) const
+{
+    SymbolId symbol = m_symbols.find(name);
+    int index;
+
+    index = m_symbols.getBinding(symbol, SymbolKind::VARIABLE);
+    if (index != NO_BINDING)
+    {
+        address = m_definedVars[index].range.begin;
+        return true;
+    }
+
+    index = m_symbols.getBinding(symbol, SymbolKind::ROUTINE);
+    if (index != NO_BINDING)
+    {
+        address = m_routines[index].range.begin;
+        return true;
+    }
+
+    return false;
+}
+
+bool Linker::writeBinary(bool targetEeprom, BinaryWithSymbols &binary, Error &error)
+{
+    binary.binaryData = QByteArray(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE, 0);
+    binary.lines.clear();
+
+    char *data(binary.binaryData.data());
+
+    for (const Placement &routine : m_routines)
+    {
+        const Section &section(*routine.section);
+
+        if (section.content.isEmpty())
+            continue;
+
+        memcpy(data + routine.range.begin, section.content.constData(), section.content.size());
+
+        for (const Relocation &relocation : section.relocations)
+        {
+            uint32_t address;
+            uint32_t instructionAddress(routine.range.begin + relocation.offset);
+
+            if (!findSymbolAddress(routine.object->names[relocation.symbol], address))
+            {
+                // Located at the instruction using the symbol
+                auto line = std::lower_bound(section.lines.begin(), section.lines.end(), relocation.offset,
+                                             [](const SectionLine &line, uint32_t offset) { return line.offset < offset; });
+
+                error.originFilePath = (line != section.lines.end()) ? routine.object->filesPaths[line->fileId] : routine.object->filesPaths[section.originFileId];
+                error.originLineNb = (line != section.lines.end()) ? line->lineNb : section.originLineNb;
+                error.originColumnNb = 0;
+                error.type = Token::ErrorType::UNKNOWN_VARIABLE;
+                error.additionalInfo = "";
+
+                return false;
+            }
+
+            Dword instructionBinary = ((Dword)(uint8_t)data[instructionAddress] << 24) | ((Dword)(uint8_t)data[instructionAddress + 1] << 16)
+                                    | ((Dword)(uint8_t)data[instructionAddress + 2] << 8) | (Dword)(uint8_t)data[instructionAddress + 3];
+            Cpu::Formats::Fields fields(Cpu::Formats::decode(instructionBinary));
+
+            if (relocation.type == RelocationType::ADDRESS)
+                fields.vX = (Word)address;
+            else if (relocation.type == RelocationType::ADDRESS_MSB)
+                fields.v1 = (Byte)(address >> 8);
+            else // ADDRESS_LSB
+                fields.v1 = (Byte)address;
+
+            instructionBinary = Cpu::Formats::encode(fields);
+
+            data[instructionAddress + 2] = (char)((instructionBinary & 0x0000FF00) >> 8);
+            data[instructionAddress + 3] = (char)(instructionBinary & 0x000000FF);
+        }
+
+        for (const SectionLine &line : section.lines)
+            binary.lines.add(routine.range.begin + line.offset, routine.object->filesPaths[line.fileId], line.lineNb);
+    }
+
+    for (const Placement &variable : m_definedVars)
+    {
+        memcpy(data + variable.range.begin, variable.section->content.constData(), variable.section->content.size());
+    }
+
+    binary.lines.buildIndexes();
+
+    return true;
+}
+
+bool Linker::sectionError(const Placement &placement, Token::ErrorType type, const std::string &additionalInfo, Error &error)
+{
+    error.originFilePath = placement.object->filesPaths[placement.section->originFileId];
+    error.originLineNb = placement.section->originLineNb;
+    error.originColumnNb = 0;
+    error.type = type;
+    error.additionalInfo = additionalInfo;
+
+    return false;
+}
@@ -0,0 +1,80 @@
+#ifndef LINKER_H
+#define LINKER_H
+
+/*!
+ * \file linker.h
+ * \brief Placement of the sections of relocatable objects, and resolution of their relocations into a binary image
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <vector>
+#include "memoryMap.h"
+#include "objectFile.h"
+#include "symbolTable.h"
+#include "token.h"
+
+namespace Assembly
+{
+    struct BinaryWithSymbols;
+    struct Error;
+
+    /*!
+     * \class Linker
+     * \brief Lays out the sections of one or more objects in memory, as the Assembler did for a single project
+     *
+     * The objects are read in the given order, as if their final files were written one after the other:
+     * - a routine without address follows the previous routine in that order
+     * - then the variables without address are given a free memory space following the PlacementPolicy
+     * - then every relocation receives the address of its symbol, a variable first, or else a routine
+     *
+     * A routine library is assembled once as an object, then linked into the image of every project using it.
+     */
+    class Linker
+    {
+        public:
+            /*!
+             * \brief Places the sections of all <i>objects</i>, and writes them with their line table into <i>binary</i>
+             *
+             * \param targetEeprom Every object must have been assembled for the same memory
+             * \return <b>false</b> with <i>error</i> set if the objects cannot be linked
+             */
+            bool link(const std::vector<const ObjectFile*> &objects, bool targetEeprom, PlacementPolicy policy, BinaryWithSymbols &binary, Error &error);
+
+            Fragmentation getFragmentation() const; //!< Free memory once the last link succeeded
+            uint32_t getMemoryUse() const; //!< Bytes of all sections of the last link
+
+        private:
+            /*!
+             * \brief Section of an object and its range once placed
+             */
+            struct Placement
+            {
+                const ObjectFile *object;
+                const Section *section;
+                MemoryRange range;
+
+                uint32_t size() const { return (uint32_t)section->content.size(); }
+            };
+
+            bool listSections(const std::vector<const ObjectFile*> &objects, bool targetEeprom, Error &error);
+            bool placeRoutines(bool targetEeprom, Error &error); //!< Routines without address in a row, then checks the overlaps
+            bool placeVariables(PlacementPolicy policy, Error &error);
+            void bindSymbols(); //!< Binds every name to the index of its placement, once all are sorted by address
+            bool findSymbolAddress(const std::string &name, uint32_t &address) const; //!< Variables first, then routines
+            bool writeBinary(bool targetEeprom, BinaryWithSymbols &binary, Error &error);
+
+            static bool sectionError(const Placement &placement, Token::ErrorType type, const std::string &additionalInfo, Error &error); //!< Always returns <b>false</b>
+
+            // Attributes
+            std::vector<Placement> m_routines;
+            std::vector<Placement> m_definedVars; //!< Then all variables, once placed
+            std::vector<Placement> m_undefinedVars;
+            MemoryMap m_memoryMap; //!< Ranges of the defined variables and routines, then of the placed variables
+            SymbolTable m_symbols; //!< Names of the routines and variables of all objects
+            uint32_t m_memoryUse = 0;
+    };
+}
+
+#endif // LINKER_H
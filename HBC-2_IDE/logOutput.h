@@ -0,0 +1,29 @@
+#ifndef LOGOUTPUT_H
+#define LOGOUTPUT_H
+
+/*!
+ * \file logOutput.h
+ * \brief Interface of the outputs the assembler reports its progress to
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <string>
+
+/*!
+ * \class LogOutput
+ * \brief Lines of text, shown by the Console widget in the IDE and by the terminal in <b>hbc2-as</b>
+ *
+ * Keeps the assembler free of any widget, so it runs without a display server.
+ */
+class LogOutput
+{
+    public:
+        virtual ~LogOutput() = default;
+
+        virtual void log(std::string line) = 0;
+        virtual void returnLine() = 0;
+        virtual void clearLog() = 0; //!< Removes the lines of the previous assembly
+};
+
+#endif // LOGOUTPUT_H
@@ -195,6 +195,18 @@ void MainWindow::setupMenuBar()
     m_eepromToggle->setCheckable(true);
     m_eepromToggle->setChecked(m_configManager->getEepromPlugged());
 
+    m_serialToggle = m_emulatorPeripheralsMenu->addAction(tr("Serial port"));
+    m_serialToggle->setCheckable(true);
+    m_serialToggle->setChecked(m_configManager->getSerialPlugged());
+
+    m_storageToggle = m_emulatorPeripheralsMenu->addAction(tr("Storage device"));
+    m_storageToggle->setCheckable(true);
+    m_storageToggle->setChecked(m_configManager->getStoragePlugged());
+
+    m_dmaToggle = m_emulatorPeripheralsMenu->addAction(tr("DMA controller"));
+    m_dmaToggle->setCheckable(true);
+    m_dmaToggle->setChecked(m_configManager->getDmaPlugged());
+
     m_emulatorMenu->addSeparator();
 
     m_startPausedToggle = m_emulatorMenu->addAction(tr("Start paused"), this, &MainWindow::startPausedAction);
@@ -262,6 +274,13 @@ void MainWindow::setupWidgets()
 
     m_consoleOutput = new Console(this);
 
+    // Serial port output
+    m_serialLabel = new QLabel(this);
+    m_serialLabel->setText(tr("Serial output"));
+
+    m_serialOutput = new Console(this);
+    m_serialOutput->document()->setMaximumBlockCount(SERIAL_OUTPUT_MAX_LINES);
+
     updateWinTabMenu();
 }
 
@@ -276,8 +295,19 @@ void MainWindow::setupLayout()
     m_editorLayout->addWidget(m_projectManager);
 
     m_mainLayout->addLayout(m_editorLayout);
-    m_mainLayout->addWidget(m_consoleLabel);
-    m_mainLayout->addWidget(m_consoleOutput);
+    m_outputLayout = new QHBoxLayout;
+    m_consoleLayout = new QVBoxLayout;
+    m_serialLayout = new QVBoxLayout;
+
+    m_consoleLayout->addWidget(m_consoleLabel);
+    m_consoleLayout->addWidget(m_consoleOutput);
+    m_serialLayout->addWidget(m_serialLabel);
+    m_serialLayout->addWidget(m_serialOutput);
+
+    m_outputLayout->addLayout(m_consoleLayout, 2);
+    m_outputLayout->addLayout(m_serialLayout, 1);
+
+    m_mainLayout->addLayout(m_outputLayout);
 
     m_window->setLayout(m_mainLayout);
 
@@ -813,9 +843,25 @@ void MainWindow::onTickCountReceived(int countIn100Ms)
         statusBarStr += QString::number(MonitorDialog::getFPS());
     }
 
+    if (m_emulator->getHbcKeyboard() != nullptr && m_emulator->getHbcKeyboard()->getDroppedEventsNb() > 0)
+    {
+        statusBarStr += " | Keys dropped: ";
+        statusBarStr += QString::number(m_emulator->getHbcKeyboard()->getDroppedEventsNb());
+    }
+
     setStatusBarRightMessage(statusBarStr);
 }
 
+void MainWindow::onSerialOutputReceived(QByteArray data)
+{
+    m_serialOutput->write(QString::fromLatin1(data));
+}
+
+void MainWindow::onSerialBytesDropped(quint64 count)
+{
+    m_consoleOutput->log("Serial port overrun, " + QString::number(count) + " bytes dropped");
+}
+
 void MainWindow::onMonitorClosed()
 {
     stopEmulatorAction();
@@ -1079,6 +1125,8 @@ void MainWindow::openProject(QString projectPath)
         bool loaded(false);
 
         memoryTargetAction(false);
+        m_emulator->setProjectDirectory(m_projectManager->getCurrentProject()->getDirPath());
+        m_emulator->setLoadPlugins(m_configManager->getLoadProjectPlugins());
         loaded = m_emulator->loadProject(m_projectManager->getCurrentProject()->getRomFilePath(), m_projectManager->getCurrentProject()->getName());
 
         m_projectManager->getCurrentProject()->setAssembled(loaded);
@@ -1086,7 +1134,12 @@ void MainWindow::openProject(QString projectPath)
         plugMonitorPeripheralAction();
         plugRTCPeripheralAction();
         plugKeyboardPeripheralAction();
+        plugSerialPeripheralAction();
+        plugStoragePeripheralAction();
+        plugDmaPeripheralAction();
         startPausedAction();
+        m_emulator->setMonitorCapture(m_configManager->getMonitorCaptureFormat(), m_configManager->getMonitorCaptureInterval());
+        m_emulator->setKeyboardBuffer(m_configManager->getKeyboardBufferDepth(), m_configManager->getKeyboardCoalesceRepeats());
 
         BinaryViewer::update(m_emulator->getCurrentRamBinaryData());
     }
@@ -1366,13 +1419,29 @@ void MainWindow::assembleAction()
     }
 
     // Assemble the project
-    if (m_assembler->assembleProject(m_projectManager->getCurrentProject(), m_eepromTargetToggle->isChecked()))
+    std::shared_ptr<Project> project = m_projectManager->getCurrentProject();
+    Assembly::Sources sources;
+
+    sources.name = project->getName();
+    sources.path = project->getPath();
+    sources.filesPaths = project->getFilesPaths();
+
+    if (m_assembler->assembleProject(sources, m_eepromTargetToggle->isChecked(), m_configManager->getIncrementalAssembly()))
     {
+        project->setAssembled(true);
+
         // Emulator
         plugMonitorPeripheralAction();
         plugRTCPeripheralAction();
         plugKeyboardPeripheralAction();
+        plugSerialPeripheralAction();
+        plugStoragePeripheralAction();
+        plugDmaPeripheralAction();
         startPausedAction();
+        m_emulator->setMonitorCapture(m_configManager->getMonitorCaptureFormat(), m_configManager->getMonitorCaptureInterval());
+        m_emulator->setKeyboardBuffer(m_configManager->getKeyboardBufferDepth(), m_configManager->getKeyboardCoalesceRepeats());
+        m_emulator->setProjectDirectory(m_projectManager->getCurrentProject()->getDirPath());
+        m_emulator->setLoadPlugins(m_configManager->getLoadProjectPlugins());
 
         if (m_eepromTargetToggle->isChecked())
         {
@@ -1602,6 +1671,21 @@ void MainWindow::plugEepromPeripheralAction()
     m_eepromTargetToggle->setChecked(m_eepromToggle->isChecked());
 }
 
+void MainWindow::plugDmaPeripheralAction()
+{
+    m_emulator->useDma(m_dmaToggle->isChecked());
+}
+
+void MainWindow::plugStoragePeripheralAction()
+{
+    m_emulator->useStorage(m_storageToggle->isChecked());
+}
+
+void MainWindow::plugSerialPeripheralAction()
+{
+    m_emulator->useSerial(m_serialToggle->isChecked());
+}
+
 void MainWindow::startPausedAction()
 {
     m_emulator->setStartPaused(m_startPausedToggle->isChecked());
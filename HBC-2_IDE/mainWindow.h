@@ -21,6 +21,7 @@
 #include <QDirIterator>
 #include "codeEditor.h"
 #include "assembler.h"
+#include "projectManager.h"
 #include "emulator.h"
 #include "config.h"
 
@@ -78,6 +79,8 @@ class MainWindow : public QMainWindow
         void onEmulatorStatusChanged(Emulator::State newState);
         void onEmulatorStepped();
         void onTickCountReceived(int countIn100Ms);
+        void onSerialOutputReceived(QByteArray data);
+        void onSerialBytesDropped(quint64 count);
         void onMonitorClosed();
         void dontShowAgainReassemblyWarnings();
         // Monitor signals
@@ -152,6 +155,9 @@ class MainWindow : public QMainWindow
         void plugRTCPeripheralAction();
         void plugKeyboardPeripheralAction();
         void plugEepromPeripheralAction();
+        void plugSerialPeripheralAction();
+        void plugStoragePeripheralAction();
+        void plugDmaPeripheralAction();
         void startPausedAction();
         // Tools actions
         void openCpuStateViewer();
@@ -182,6 +188,9 @@ class MainWindow : public QMainWindow
         // Layouts
         QVBoxLayout *m_mainLayout;
         QHBoxLayout *m_editorLayout;
+        QHBoxLayout *m_outputLayout;
+        QVBoxLayout *m_consoleLayout;
+        QVBoxLayout *m_serialLayout;
 
         // Menu Bar
         QMenu *m_fileMenu;
@@ -223,6 +232,9 @@ class MainWindow : public QMainWindow
         QAction *m_rtcToggle;
         QAction *m_keyboardToggle;
         QAction *m_eepromToggle;
+        QAction *m_serialToggle;
+        QAction *m_storageToggle;
+        QAction *m_dmaToggle;
         QAction *m_startPausedToggle;
         // Project Manager right-click menu
         QAction *m_setActiveProjectActionRC;
@@ -260,6 +272,8 @@ class MainWindow : public QMainWindow
         QTabWidget *m_assemblyEditor;
         QLabel *m_consoleLabel;
         Console *m_consoleOutput;
+        QLabel *m_serialLabel;
+        Console *m_serialOutput;
         FileManager *m_fileManager;
         ProjectManager *m_projectManager;
 
@@ -273,6 +287,7 @@ class MainWindow : public QMainWindow
 
         static constexpr int WINDOW_WIDTH = 1280;
         static constexpr int WINDOW_HEIGHT = 720;
+        static constexpr int SERIAL_OUTPUT_MAX_LINES = 5000; //!< Older lines of the serial output are discarded
 
         QFont defaultEditorFont;
         QWidget *m_window;
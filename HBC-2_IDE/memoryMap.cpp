@@ -0,0 +1,211 @@
+#include "memoryMap.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Assembly;
+
+// PUBLIC
+void MemoryMap::init(MemoryRange freeSpace)
+{
+    m_reservations.clear();
+    m_freeSpaces.clear();
+    m_freeSpacesBySize.clear();
+    m_freeBytes = 0;
+    m_largestFreeValid = false;
+
+    if (freeSpace.end >= freeSpace.begin)
+        addFreeSpace(freeSpace.begin, freeSpace.end, 0);
+}
+
+const Reservation* MemoryMap::findOverlap(MemoryRange range) const
+{
+    if (range.end < range.begin)
+        return nullptr;
+
+    // Reservations never overlap: only the last one starting before the range can reach it, then the ones starting in it
+    auto it = m_reservations.upper_bound(range.begin);
+
+    if (it != m_reservations.begin() && std::prev(it)->second.range.end >= range.begin)
+        return &(std::prev(it)->second);
+
+    if (it != m_reservations.end() && it->first <= range.end)
+        return &(it->second);
+
+    return nullptr;
+}
+
+const Reservation* MemoryMap::reserve(MemoryRange range, SymbolKind kind, int index)
+{
+    if (range.end < range.begin)
+        return nullptr;
+
+    const Reservation *overlapped(findOverlap(range));
+
+    if (overlapped != nullptr)
+        return overlapped;
+
+    m_reservations[range.begin] = { range, kind, index };
+
+    // Removes the range from the free spaces it covers, splitting them if needed
+    auto it = m_freeSpaces.upper_bound(range.begin);
+
+    if (it != m_freeSpaces.begin())
+        it--;
+
+    while (it != m_freeSpaces.end() && it->first <= range.end)
+    {
+        uint32_t begin(it->first), end(it->second.end);
+        auto next = std::next(it);
+
+        if (end >= range.begin)
+        {
+            removeFreeSpace(it);
+
+            if (begin < range.begin)
+                addFreeSpace(begin, range.begin - 1, 0);
+
+            if (end > range.end)
+                addFreeSpace(range.end + 1, end, 0);
+
+            m_largestFreeValid = false;
+        }
+
+        it = next;
+    }
+
+    return nullptr;
+}
+
+bool MemoryMap::allocate(uint32_t size, PlacementPolicy policy, SymbolKind kind, int index, uint32_t &address)
+{
+    uint32_t begin(0);
+
+    if (m_freeSpaces.empty())
+        return false;
+
+    if (size == 0) // Nothing to reserve
+    {
+        address = m_freeSpaces.begin()->first;
+        return true;
+    }
+
+    if (policy == PlacementPolicy::BEST_FIT)
+    {
+        auto best = m_freeSpacesBySize.lower_bound({ size, 0 }); // Lowest address among the smallest ones
+
+        if (best == m_freeSpacesBySize.end())
+            return false;
+
+        begin = best->second;
+    }
+    else
+    {
+        if (!m_largestFreeValid)
+            buildLargestFree();
+
+        if (!findFirstFit(size, begin))
+            return false;
+    }
+
+    // The variable takes the beginning of the free space, which keeps its leaf
+    auto it = m_freeSpaces.find(begin);
+    uint32_t end(it->second.end);
+    unsigned int leaf(it->second.leaf);
+
+    removeFreeSpace(it);
+
+    if (end - begin + 1 > size)
+        addFreeSpace(begin + size, end, leaf);
+
+    if (m_largestFreeValid)
+    {
+        m_leavesBegin[leaf] = begin + size;
+        updateLargestFree(leaf, end - begin + 1 - size);
+    }
+
+    m_reservations[begin] = { { begin, begin + size - 1 }, kind, index };
+    address = begin;
+
+    return true;
+}
+
+Fragmentation MemoryMap::getFragmentation() const
+{
+    Fragmentation fragmentation;
+
+    fragmentation.freeBytes = m_freeBytes;
+    fragmentation.freeSpacesNb = (unsigned int)m_freeSpaces.size();
+    fragmentation.largestFreeSpace = m_freeSpacesBySize.empty() ? 0 : m_freeSpacesBySize.rbegin()->first;
+    fragmentation.percent = (m_freeBytes == 0) ? 0 : (unsigned int)((uint64_t)(m_freeBytes - fragmentation.largestFreeSpace) * 100 / m_freeBytes);
+
+    return fragmentation;
+}
+
+
+// PRIVATE
+void MemoryMap::addFreeSpace(uint32_t begin, uint32_t end, unsigned int leaf)
+{
+    m_freeSpaces[begin] = { end, leaf };
+    m_freeSpacesBySize.insert({ end - begin + 1, begin });
+    m_freeBytes += end - begin + 1;
+}
+
+void MemoryMap::removeFreeSpace(std::map<uint32_t, FreeSpace>::iterator it)
+{
+    m_freeSpacesBySize.erase({ it->second.end - it->first + 1, it->first });
+    m_freeBytes -= it->second.end - it->first + 1;
+    m_freeSpaces.erase(it);
+}
+
+void MemoryMap::buildLargestFree()
+{
+    unsigned int leaf(0);
+
+    m_leavesNb = 1;
+
+    while (m_leavesNb < m_freeSpaces.size())
+        m_leavesNb *= 2;
+
+    m_largestFree.assign(2 * m_leavesNb, 0);
+    m_leavesBegin.assign(m_leavesNb, 0);
+
+    for (auto &freeSpace : m_freeSpaces)
+    {
+        freeSpace.second.leaf = leaf;
+        m_leavesBegin[leaf] = freeSpace.first;
+        m_largestFree[m_leavesNb + leaf] = freeSpace.second.end - freeSpace.first + 1;
+        leaf++;
+    }
+
+    for (unsigned int node(m_leavesNb - 1); node > 0; node--)
+        m_largestFree[node] = std::max(m_largestFree[2 * node], m_largestFree[2 * node + 1]);
+
+    m_largestFreeValid = true;
+}
+
+void MemoryMap::updateLargestFree(unsigned int leaf, uint32_t size)
+{
+    unsigned int node(m_leavesNb + leaf);
+
+    m_largestFree[node] = size;
+
+    for (node /= 2; node > 0; node /= 2)
+        m_largestFree[node] = std::max(m_largestFree[2 * node], m_largestFree[2 * node + 1]);
+}
+
+bool MemoryMap::findFirstFit(uint32_t size, uint32_t &begin) const
+{
+    unsigned int node(1);
+
+    if (m_largestFree[1] < size)
+        return false;
+
+    // Goes down to the leftmost leaf large enough
+    while (node < m_leavesNb)
+        node = (m_largestFree[2 * node] >= size) ? 2 * node : 2 * node + 1;
+
+    begin = m_leavesBegin[node - m_leavesNb];
+
+    return true;
+}
@@ -0,0 +1,125 @@
+#ifndef MEMORYMAP_H
+#define MEMORYMAP_H
+
+/*!
+ * \file memoryMap.h
+ * \brief Reserved and free memory ranges of an assembly, with the placement of the variables without address
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "symbolTable.h"
+
+namespace Assembly
+{
+    /*!
+     * \struct MemoryRange
+     * \brief First and last address (inclusive).
+     */
+    struct MemoryRange
+    {
+        uint32_t begin; //!< Inclusive
+        uint32_t end; //!< Inclusive
+    };
+
+    /*!
+     * \enum PlacementPolicy
+     * \brief How a variable without address is given a free memory space
+     */
+    enum class PlacementPolicy
+    {
+        FIRST_FIT, //!< Lowest address large enough, the placement of the IDE
+        BEST_FIT //!< Smallest free space large enough, largest variables first: packs memory more tightly
+    };
+
+    /*!
+     * \struct Reservation
+     * \brief Range used by a routine block or a variable, <i>index</i> is its position in the lists of the Assembler
+     */
+    struct Reservation
+    {
+        MemoryRange range;
+        SymbolKind kind;
+        int index;
+    };
+
+    /*!
+     * \struct Fragmentation
+     * \brief State of the free memory, <i>percent</i> is the share of free bytes outside of the largest free space
+     */
+    struct Fragmentation
+    {
+        uint32_t freeBytes;
+        unsigned int freeSpacesNb;
+        uint32_t largestFreeSpace;
+        unsigned int percent;
+    };
+
+    /*!
+     * \class MemoryMap
+     * \brief Ordered maps of the reserved ranges and of the free memory spaces
+     *
+     * Reserved ranges never overlap, so finding the ones overlapping a range only looks at its neighbours: <i>O(log n)</i>.<br>
+     * Free spaces are indexed by address and by size, and by a tree of their largest size for the first fit: every placement is <i>O(log n)</i>.
+     */
+    class MemoryMap
+    {
+        public:
+            /*!
+             * \brief Clears all reservations, <i>freeSpace</i> is the only memory available for placements
+             */
+            void init(MemoryRange freeSpace);
+
+            /*!
+             * \return the reservation with the lowest address overlapping <i>range</i>
+             * \return nullptr if <i>range</i> is free
+             */
+            const Reservation* findOverlap(MemoryRange range) const;
+
+            /*!
+             * \brief Marks <i>range</i> as used, it can be outside of the free memory space given to init()
+             * \return nullptr if reserved, or the overlapped reservation <i>(nothing is reserved then)</i>
+             */
+            const Reservation* reserve(MemoryRange range, SymbolKind kind, int index);
+
+            /*!
+             * \brief Finds a free space of <i>size</i> bytes following <i>policy</i>, and reserves it
+             * \return <b>false</b> if no free space is large enough
+             */
+            bool allocate(uint32_t size, PlacementPolicy policy, SymbolKind kind, int index, uint32_t &address);
+
+            Fragmentation getFragmentation() const;
+
+        private:
+            struct FreeSpace
+            {
+                uint32_t end;
+                unsigned int leaf; //!< Position in m_largestFree, valid if m_largestFreeValid
+            };
+
+            void addFreeSpace(uint32_t begin, uint32_t end, unsigned int leaf);
+            void removeFreeSpace(std::map<uint32_t, FreeSpace>::iterator it);
+            void buildLargestFree();
+            void updateLargestFree(unsigned int leaf, uint32_t size);
+            bool findFirstFit(uint32_t size, uint32_t &begin) const;
+
+            std::map<uint32_t, Reservation> m_reservations; //!< By first address
+            std::map<uint32_t, FreeSpace> m_freeSpaces; //!< By first address
+            std::set<std::pair<uint32_t, uint32_t>> m_freeSpacesBySize; //!< Size and first address, for the best fit
+            uint32_t m_freeBytes = 0;
+
+            // Segment tree of the free spaces in address order, each node holds the largest size below it
+            // Placements only shrink free spaces, so it is only rebuilt after a reservation split or trimmed one
+            std::vector<uint32_t> m_largestFree;
+            std::vector<uint32_t> m_leavesBegin; //!< First address of the free space of each leaf
+            unsigned int m_leavesNb = 0; //!< Power of 2
+            bool m_largestFreeValid = false;
+    };
+}
+
+#endif // MEMORYMAP_H
@@ -9,16 +9,204 @@
 #include <QRandomGenerator>
 #include <QGuiApplication>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace Monitor;
 
+// ===== MonitorRasterizer class =====
+MonitorRasterizer::MonitorRasterizer()
+{
+    m_fontLoaded = false;
+    m_glyphAtlas.fill(SOLID_GLYPH_ROW);
 
-// ===== HbcMonitor class =====
-HbcMonitor::HbcMonitor(HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+    for (int glyphRow(0); glyphRow < (1 << CHARACTER_WIDTH); glyphRow++)
+    {
+        for (int x(0); x < CHARACTER_WIDTH; x++)
+        {
+            m_glyphRowMasks[glyphRow][x] = (glyphRow >> x) & 1 ? 0xFFFFFFFF : 0x00000000;
+        }
+    }
+
+    QImage font(":/font/res/charMap.png");
+
+    if (!font.isNull())
+    {
+        if (font.width() == (DISPLAYABLE_CHARS * CHARACTER_WIDTH) && font.height() == CHARACTER_HEIGHT)
+        {
+            for (int i(0); i < DISPLAYABLE_CHARS; i++)
+            {
+                for (int y(0); y < CHARACTER_HEIGHT; y++)
+                {
+                    Byte glyphRow(0x00);
+
+                    for (int x(0); x < CHARACTER_WIDTH; x++)
+                    {
+                        if (font.pixel(x + i * CHARACTER_WIDTH, y) == Monitor::colorArray[(int)Monitor::Color::WHITE])
+                            glyphRow |= 1 << x;
+                    }
+
+                    m_glyphAtlas[(i + 32) * CHARACTER_HEIGHT + y] = glyphRow;
+                }
+            }
+
+            m_fontLoaded = true;
+        }
+    }
+}
+
+bool MonitorRasterizer::isFontLoaded()
+{
+    return m_fontLoaded;
+}
+
+const std::array<Byte, GLYPHS_NB * CHARACTER_HEIGHT>& MonitorRasterizer::getGlyphAtlas()
+{
+    return m_glyphAtlas;
+}
+
+void MonitorRasterizer::render(const Monitor::CharData *textBuffer, const Monitor::DirtyMap &dirtyMap, uint32_t *destination, int &firstRow, int &lastRow)
+{
+    int columns[TEXT_MODE_COLUMNS];
+    const Byte *glyphs[TEXT_MODE_COLUMNS];
+    uint32_t fontColors[TEXT_MODE_COLUMNS], backgroundColors[TEXT_MODE_COLUMNS];
+
+    for (int row(0); row < TEXT_MODE_ROWS; row++)
+    {
+        int columnsNb(0);
+
+        // Characters of the row to redraw
+        for (int column(0); column < TEXT_MODE_COLUMNS; column++)
+        {
+            int index = column + row * TEXT_MODE_COLUMNS;
+
+            if (!dirtyMap.full && !(dirtyMap.textCells[index / DIRTY_WORD_BITS] & ((uint64_t)1 << (index % DIRTY_WORD_BITS))))
+                continue;
+
+            columns[columnsNb] = column;
+            glyphs[columnsNb] = &m_glyphAtlas[textBuffer[index].ascii * CHARACTER_HEIGHT];
+            fontColors[columnsNb] = Monitor::colorArray[textBuffer[index].colors & 0x0F];
+            backgroundColors[columnsNb] = Monitor::colorArray[(textBuffer[index].colors & 0xF0) >> 4];
+            columnsNb++;
+        }
+
+        if (columnsNb == 0)
+            continue;
+
+        // Drawn line by line, in memory order
+        for (int y(0); y < CHARACTER_HEIGHT; y++)
+        {
+            uint32_t *line = destination + (row * CHARACTER_HEIGHT + y) * WIDTH;
+
+            for (int i(0); i < columnsNb; i++)
+            {
+                blitGlyphRow(line + columns[i] * CHARACTER_WIDTH, glyphs[i][y], fontColors[i], backgroundColors[i]);
+            }
+        }
+
+        firstRow = std::min(firstRow, row * CHARACTER_HEIGHT);
+        lastRow = std::max(lastRow, (row + 1) * CHARACTER_HEIGHT - 1);
+    }
+}
+
+void MonitorRasterizer::render(const Byte *pixelBuffer, const Monitor::DirtyMap &dirtyMap, uint32_t *destination, int &firstRow, int &lastRow)
+{
+    for (int y(0); y < HEIGHT; y++)
+    {
+        if (!dirtyMap.full && !(dirtyMap.pixelRows[y / DIRTY_WORD_BITS] & ((uint64_t)1 << (y % DIRTY_WORD_BITS))))
+            continue;
+
+        uint32_t *line = destination + y * WIDTH;
+        const Byte *videoLine = pixelBuffer + y * WIDTH;
+
+        for (int x(0); x < WIDTH; x++)
+        {
+            line[x] = Monitor::colorArray[videoLine[x] & 0x0F];
+        }
+
+        firstRow = std::min(firstRow, y);
+        lastRow = std::max(lastRow, y);
+    }
+}
+
+// PRIVATE
+void MonitorRasterizer::blitGlyphRow(uint32_t *destination, Byte glyphRow, uint32_t fontColor, uint32_t backgroundColor)
+{
+    const uint32_t *masks = m_glyphRowMasks[glyphRow].data();
+    uint32_t colorsDifference = fontColor ^ backgroundColor;
+
+    // Fixed size and no branch, vectorized by the compiler
+    for (int x(0); x < CHARACTER_WIDTH; x++)
+    {
+        destination[x] = backgroundColor ^ (colorsDifference & masks[x]);
+    }
+}
+
+
+// ===== HbcMonitorExtension class =====
+HbcMonitorExtension::HbcMonitorExtension(HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
 { }
 
-HbcMonitor::~HbcMonitor()
+void HbcMonitorExtension::init()
+{
+    m_sockets = Iod::requestPortsConnexions(*m_iod, EXTENSION_DEVICE_ID, EXTENSION_PORTS_NB);
+
+    if (m_sockets.size() < EXTENSION_PORTS_NB)
+    {
+        m_consoleOutput->log("Cannot plug the monitor extension, not enough available ports");
+    }
+}
+
+void HbcMonitorExtension::tick(bool step)
 { }
 
+bool HbcMonitorExtension::isPlugged() const
+{
+    return m_sockets.size() >= EXTENSION_PORTS_NB;
+}
+
+Byte HbcMonitorExtension::read(Monitor::ExtensionPort port) const
+{
+    return *m_sockets[(int)port].portDataPointer;
+}
+
+
+// ===== HbcMonitor class =====
+HbcMonitor::HbcMonitor(HbcRam *ram, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+{
+    m_ram = ram;
+    m_extension = nullptr;
+    m_videoMapped = false;
+    m_videoMappedAddress = 0x0000;
+    m_mode = Monitor::Mode::TEXT;
+    m_dirtyMap.clear();
+    m_lastPublishedDirtyMap.clear();
+
+    for (int i(0); i < FRAMES_NB; i++)
+    {
+        m_frames[i].mode = Monitor::Mode::TEXT;
+        std::memset(m_frames[i].textBuffer, 0x00, sizeof(m_frames[i].textBuffer));
+        std::memset(m_frames[i].pixelBuffer, 0x00, sizeof(m_frames[i].pixelBuffer));
+        m_frames[i].dirtyMap.clear();
+    }
+
+    m_backFrameIndex = 0;
+    m_middleFrameIndex = 1;
+    m_frontFrameIndex = 2;
+
+    m_capture = nullptr;
+    m_captureRasterizer = nullptr;
+    m_ticksNb = 0;
+}
+
+HbcMonitor::~HbcMonitor()
+{
+    Ram::unmapDevice(*m_ram, this);
+
+    delete m_capture;
+    delete m_captureRasterizer;
+}
+
 void HbcMonitor::init()
 {
     m_sockets = Iod::requestPortsConnexions(*m_iod, DEVICE_ID, PORTS_NB);
@@ -30,140 +218,579 @@ void HbcMonitor::init()
 
     m_mode = Monitor::Mode::TEXT; // Default
 
-    int index;
-    for (unsigned int x(0); x < WIDTH; x++)
-    {
-        for (unsigned int y(0); y < HEIGHT; y++)
-        {
-            index = x + y * WIDTH;
+    m_videoMapped = false;
+    Ram::unmapDevice(*m_ram, this);
 
-            m_videoData.pixelBuffer[index] = 0x00;
+    std::memset(m_pixelBuffer, 0x00, sizeof(m_pixelBuffer));
+    std::memset(m_textBuffer, 0x00, sizeof(m_textBuffer));
 
-            if (index < TEXT_MODE_BUFFER_SIZE)
-            {
-                m_videoData.textBuffer[index].colors = 0x00;
-                m_videoData.textBuffer[index].ascii = 0x00;
-            }
-        }
+    m_dirtyMap.markAll();
+    publishFrame();
+
+    m_ticksNb = 0;
+
+    if (m_capture != nullptr && !m_capture->start())
+    {
+        delete m_capture;
+        m_capture = nullptr;
     }
 }
 
 void HbcMonitor::tick(bool step)
 {
+    // Headless capture, before the command so the first frame is the initial screen
+    if (m_capture != nullptr && m_ticksNb++ % m_capture->getInterval() == 0)
+    {
+        renderFrame(m_captureBuffer.data());
+        m_capture->write(m_captureBuffer.data(), m_ticksNb - 1);
+    }
+
+    if (m_sockets.size() < PORTS_NB)
+        return;
+
     Monitor::Command command = (Monitor::Command)*m_sockets[(int)Monitor::Port::CMD].portDataPointer;
-    int videoIndex, textIndex;
 
     // Check command
-    if (command != Monitor::Command::NOP)
+    if (command == Monitor::Command::NOP)
+        return;
+
+    Byte data0 = *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer;
+    Byte data1 = *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer;
+    int index = *m_sockets[(int)Monitor::Port::POS_X].portDataPointer + *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer * (m_mode == Monitor::Mode::PIXEL ? WIDTH : TEXT_MODE_COLUMNS);
+    bool extended = (m_extension != nullptr && m_extension->isPlugged()); // Parameters of the rectangle and address commands
+    int x, y, width, height;
+
+    switch (command)
     {
-        videoIndex = *m_sockets[(int)Monitor::Port::POS_X].portDataPointer + *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer * WIDTH;
-        textIndex = *m_sockets[(int)Monitor::Port::POS_X].portDataPointer + *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer * TEXT_MODE_COLUMNS;
+        case Monitor::Command::WRITE:
+            writeCell(index, data0, data1);
+            return; // Executed on every tick, as long as the CPU does not change the command
 
-        if (command == Monitor::Command::WRITE)
-        {
-            if (m_mode == Monitor::Mode::PIXEL)
-            {
-                m_videoData.mutex.lock();
+        case Monitor::Command::READ:
+            readCell(index);
+            return;
 
-                if (videoIndex < PIXEL_MODE_BUFFER_SIZE)
-                {
-                    m_videoData.pixelBuffer[videoIndex] = *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer;
-                }
+        case Monitor::Command::SWITCH_TO_PIXEL_MODE:
+            if (m_mode != Monitor::Mode::PIXEL) // Executed on every tick, only the first one changes the mode
+            {
+                m_mode = Monitor::Mode::PIXEL;
+                m_dirtyMap.markAll();
+                updateVideoMapping();
+                qDebug() << "[MONITOR]: Switches to pixel mode";
+            }
+            return;
 
-                m_videoData.mutex.unlock();
+        case Monitor::Command::SWITCH_TO_TEXT_MODE:
+            if (m_mode != Monitor::Mode::TEXT) // Executed on every tick, only the first one changes the mode
+            {
+                m_mode = Monitor::Mode::TEXT;
+                m_dirtyMap.markAll();
+                updateVideoMapping();
+                qDebug() << "[MONITOR]: Switches to text mode";
             }
-            else // TEXT
+            return;
+
+        case Monitor::Command::WRITE_NEXT:
+            writeCell(index, data0, data1);
+            advanceCursor();
+            break;
+
+        case Monitor::Command::READ_NEXT:
+            readCell(index);
+            advanceCursor();
+            break;
+
+        case Monitor::Command::FILL_RECT:
+            if (extended && getRectangle(x, y, width, height))
+                fillRectangle(x, y, width, height, data0, data1);
+            break;
+
+        case Monitor::Command::SCROLL_UP:
+            if (extended)
+                scrollRectangle(true);
+            break;
+
+        case Monitor::Command::SCROLL_DOWN:
+            if (extended)
+                scrollRectangle(false);
+            break;
+
+        case Monitor::Command::BLIT_FROM_RAM:
+            if (extended)
+                blitFromRam();
+            break;
+
+        case Monitor::Command::MAP_VIDEO_MEMORY:
+            if (extended)
             {
-                m_videoData.mutex.lock();
+                m_videoMapped = true;
+                m_videoMappedAddress = (m_extension->read(Monitor::ExtensionPort::ADDR_0) << 8) | m_extension->read(Monitor::ExtensionPort::ADDR_1);
+                updateVideoMapping();
+            }
+            break;
 
-                if (textIndex < TEXT_MODE_BUFFER_SIZE)
-                {
-                    m_videoData.textBuffer[textIndex].colors = *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer;
-                    m_videoData.textBuffer[textIndex].ascii = *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer;
-                }
+        case Monitor::Command::UNMAP_VIDEO_MEMORY:
+            m_videoMapped = false;
+            updateVideoMapping();
+            break;
 
-                m_videoData.mutex.unlock();
-            }
+        default:
+            return;
+    }
+
+    // Bulk commands are only executed once
+    *m_sockets[(int)Monitor::Port::CMD].portDataPointer = (int)Monitor::Command::NOP;
+}
+
+int HbcMonitor::writeVideoMemory(int index, const Byte *data, int size)
+{
+    int written(0);
+
+    if (m_mode == Monitor::Mode::PIXEL)
+    {
+        written = std::max(0, std::min(size, PIXEL_MODE_BUFFER_SIZE - index));
+        std::memcpy(m_pixelBuffer + index, data, written);
+
+        for (int row(index / WIDTH); written > 0 && row <= (index + written - 1) / WIDTH; row++)
+        {
+            m_dirtyMap.markPixelRow(row);
         }
-        else if (command == Monitor::Command::READ)
+    }
+    else // TEXT
+    {
+        written = std::max(0, std::min(size, TEXT_MODE_BUFFER_SIZE * 2 - index));
+
+        for (int i(0); i < written; i++)
         {
-            if (m_mode == Monitor::Mode::PIXEL)
-            {
-                m_videoData.mutex.lock();
+            CharData &character = m_textBuffer[(index + i) / 2];
 
-                *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer = 0x00;
+            if ((index + i) % 2 == 0)
+                character.colors = data[i];
+            else
+                character.ascii = data[i];
 
-                if (videoIndex >= PIXEL_MODE_BUFFER_SIZE)
-                {
-                    *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer = 0x00;
-                }
-                else
-                {
-                    *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer = m_videoData.pixelBuffer[videoIndex];
-                }
+            m_dirtyMap.markTextCell((index + i) / 2);
+        }
+    }
 
-                m_videoData.mutex.unlock();
-            }
-            else // TEXT
-            {
-                m_videoData.mutex.lock();
+    return written;
+}
 
-                if (textIndex >= TEXT_MODE_BUFFER_SIZE)
-                {
-                    *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer = 0x00;
-                    *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer = 0x00;
-                }
-                else
-                {
-                    *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer = m_videoData.textBuffer[textIndex].colors;
-                    *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer = m_videoData.textBuffer[textIndex].ascii;
-                }
+void HbcMonitor::publishFrame()
+{
+    if (m_dirtyMap.empty())
+        return;
 
-                m_videoData.mutex.unlock();
-            }
+    // If the renderer did not take the last published frame, it will be skipped: its changes must be redrawn too
+    bool lastFrameTaken = !(m_middleFrameIndex.load(std::memory_order_acquire) & FRESH_FRAME_FLAG);
+
+    Monitor::Frame &frame = m_frames[m_backFrameIndex];
+
+    frame.mode = m_mode;
+    frame.dirtyMap = m_dirtyMap;
+
+    if (!lastFrameTaken)
+        frame.dirtyMap.merge(m_lastPublishedDirtyMap);
+
+    // Only the video memory of the displayed mode is copied
+    if (m_mode == Monitor::Mode::TEXT)
+        std::memcpy(frame.textBuffer, m_textBuffer, sizeof(m_textBuffer));
+    else
+        std::memcpy(frame.pixelBuffer, m_pixelBuffer, sizeof(m_pixelBuffer));
+
+    m_lastPublishedDirtyMap = frame.dirtyMap;
+    m_dirtyMap.clear();
+
+    m_backFrameIndex = m_middleFrameIndex.exchange(m_backFrameIndex | FRESH_FRAME_FLAG, std::memory_order_acq_rel) & FRAME_INDEX_MASK;
+
+    m_frameMutex.lock();
+    m_frameReady.wakeAll();
+    m_frameMutex.unlock();
+}
+
+bool HbcMonitor::acquireFrame()
+{
+    if (!(m_middleFrameIndex.load(std::memory_order_acquire) & FRESH_FRAME_FLAG))
+        return false;
+
+    m_frontFrameIndex = m_middleFrameIndex.exchange(m_frontFrameIndex, std::memory_order_acq_rel) & FRAME_INDEX_MASK;
+
+    return true;
+}
+
+const Monitor::Frame& HbcMonitor::getFrontFrame()
+{
+    return m_frames[m_frontFrameIndex];
+}
+
+bool HbcMonitor::waitForFrame(unsigned long timeoutMs)
+{
+    bool fresh;
+
+    m_frameMutex.lock();
+
+    if (!(m_middleFrameIndex.load(std::memory_order_acquire) & FRESH_FRAME_FLAG))
+        m_frameReady.wait(&m_frameMutex, timeoutMs);
+
+    fresh = m_middleFrameIndex.load(std::memory_order_acquire) & FRESH_FRAME_FLAG;
+    m_frameMutex.unlock();
+
+    return fresh;
+}
+
+void HbcMonitor::wakeRenderer()
+{
+    m_frameMutex.lock();
+    m_frameReady.wakeAll();
+    m_frameMutex.unlock();
+}
+
+void HbcMonitor::renderFrame(uint32_t *destination)
+{
+    if (m_captureRasterizer == nullptr)
+        m_captureRasterizer = new MonitorRasterizer();
+
+    Monitor::DirtyMap everything;
+    everything.markAll();
+
+    int firstRow(HEIGHT), lastRow(-1);
+
+    if (m_mode == Monitor::Mode::TEXT)
+    {
+        std::fill(destination, destination + WIDTH * HEIGHT, colorArray[(int)Color::BLACK]); // Margins not covered by the characters
+        m_captureRasterizer->render(m_textBuffer, everything, destination, firstRow, lastRow);
+    }
+    else // PIXEL
+    {
+        m_captureRasterizer->render(m_pixelBuffer, everything, destination, firstRow, lastRow);
+    }
+}
+
+Byte HbcMonitor::readMapped(int offset)
+{
+    if (m_mode == Monitor::Mode::PIXEL)
+        return m_pixelBuffer[offset];
+    else // TEXT
+        return (offset % 2 == 0 ? m_textBuffer[offset / 2].colors : m_textBuffer[offset / 2].ascii);
+}
+
+void HbcMonitor::writeMapped(int offset, Byte data)
+{
+    // The window is never larger than the video memory of the current mode
+    if (m_mode == Monitor::Mode::PIXEL)
+    {
+        m_pixelBuffer[offset] = data;
+        m_dirtyMap.markPixelRow(offset / WIDTH);
+    }
+    else // TEXT
+    {
+        if (offset % 2 == 0)
+            m_textBuffer[offset / 2].colors = data;
+        else
+            m_textBuffer[offset / 2].ascii = data;
+
+        m_dirtyMap.markTextCell(offset / 2);
+    }
+}
+
+void HbcMonitor::setCapture(MonitorCapture *capture)
+{
+    delete m_capture;
+
+    m_capture = capture;
+    m_captureBuffer.resize(WIDTH * HEIGHT);
+}
+
+void HbcMonitor::setExtension(HbcMonitorExtension *extension)
+{
+    m_extension = extension;
+}
+
+// PRIVATE
+void HbcMonitor::writeCell(int index, Byte data0, Byte data1)
+{
+    if (m_mode == Monitor::Mode::PIXEL)
+    {
+        if (index < PIXEL_MODE_BUFFER_SIZE)
+        {
+            m_pixelBuffer[index] = data0;
+            m_dirtyMap.markPixelRow(index / WIDTH);
+        }
+    }
+    else // TEXT
+    {
+        if (index < TEXT_MODE_BUFFER_SIZE)
+        {
+            m_textBuffer[index].colors = data0;
+            m_textBuffer[index].ascii = data1;
+            m_dirtyMap.markTextCell(index);
+        }
+    }
+}
+
+void HbcMonitor::readCell(int index)
+{
+    Byte data0(0x00), data1(0x00);
+
+    if (m_mode == Monitor::Mode::PIXEL)
+    {
+        if (index < PIXEL_MODE_BUFFER_SIZE)
+            data0 = m_pixelBuffer[index];
+    }
+    else // TEXT
+    {
+        if (index < TEXT_MODE_BUFFER_SIZE)
+        {
+            data0 = m_textBuffer[index].colors;
+            data1 = m_textBuffer[index].ascii;
         }
-        else if (command == Monitor::Command::SWITCH_TO_PIXEL_MODE)
+    }
+
+    *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer = data0;
+    *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer = data1;
+}
+
+void HbcMonitor::advanceCursor()
+{
+    int columns = (m_mode == Monitor::Mode::PIXEL ? WIDTH : TEXT_MODE_COLUMNS);
+    int rows = (m_mode == Monitor::Mode::PIXEL ? HEIGHT : TEXT_MODE_ROWS);
+
+    int x = *m_sockets[(int)Monitor::Port::POS_X].portDataPointer + 1;
+    int y = *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer;
+
+    if (x >= columns)
+    {
+        x = 0;
+        y++;
+    }
+
+    if (y >= rows)
+        y = 0;
+
+    *m_sockets[(int)Monitor::Port::POS_X].portDataPointer = x;
+    *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer = y;
+}
+
+bool HbcMonitor::getRectangle(int &x, int &y, int &width, int &height)
+{
+    int columns = (m_mode == Monitor::Mode::PIXEL ? WIDTH : TEXT_MODE_COLUMNS);
+    int rows = (m_mode == Monitor::Mode::PIXEL ? HEIGHT : TEXT_MODE_ROWS);
+
+    x = *m_sockets[(int)Monitor::Port::POS_X].portDataPointer;
+    y = *m_sockets[(int)Monitor::Port::POS_Y].portDataPointer;
+    width = m_extension->read(Monitor::ExtensionPort::SIZE_X);
+    height = m_extension->read(Monitor::ExtensionPort::SIZE_Y);
+
+    if (width == 0)
+        width = 256;
+
+    if (height == 0)
+        height = 256;
+
+    if (x >= columns || y >= rows)
+        return false;
+
+    width = std::min(width, columns - x);
+    height = std::min(height, rows - y);
+
+    return true;
+}
+
+void HbcMonitor::fillRectangle(int x, int y, int width, int height, Byte data0, Byte data1)
+{
+    for (int row(y); row < y + height; row++)
+    {
+        if (m_mode == Monitor::Mode::PIXEL)
         {
-            m_mode = Monitor::Mode::PIXEL;
-            qDebug() << "[MONITOR]: Switches to pixel mode";
+            std::memset(m_pixelBuffer + row * WIDTH + x, data0, width);
         }
-        else if (command == Monitor::Command::SWITCH_TO_TEXT_MODE)
+        else // TEXT
         {
-            m_mode = Monitor::Mode::TEXT;
-            qDebug() << "[MONITOR]: Switches to text mode";
+            CharData *line = m_textBuffer + row * TEXT_MODE_COLUMNS + x;
+
+            for (int i(0); i < width; i++)
+            {
+                line[i].colors = data0;
+                line[i].ascii = data1;
+            }
         }
     }
+
+    markRectangle(x, y, width, height);
 }
 
-Monitor::CharData* HbcMonitor::getTextBuffer()
+void HbcMonitor::scrollRectangle(bool up)
 {
-    Monitor::CharData *textBuffer(nullptr);
+    int x, y, width, height;
+
+    if (!getRectangle(x, y, width, height))
+        return;
+
+    int count = std::min((int)m_extension->read(Monitor::ExtensionPort::COUNT), height);
 
-    m_videoData.mutex.lock();
-    textBuffer = m_videoData.textBuffer;
-    m_videoData.mutex.unlock();
+    if (count == 0)
+        return;
 
-    return textBuffer;
+    // Rows moved in an order that never overwrites a row before it is read
+    for (int i(0); i < height - count; i++)
+    {
+        int destinationRow = (up ? y + i : y + height - 1 - i);
+        int sourceRow = (up ? destinationRow + count : destinationRow - count);
+
+        if (m_mode == Monitor::Mode::PIXEL)
+            std::memcpy(m_pixelBuffer + destinationRow * WIDTH + x, m_pixelBuffer + sourceRow * WIDTH + x, width);
+        else // TEXT
+            std::memcpy(m_textBuffer + destinationRow * TEXT_MODE_COLUMNS + x, m_textBuffer + sourceRow * TEXT_MODE_COLUMNS + x, width * sizeof(CharData));
+    }
+
+    fillRectangle(x, (up ? y + height - count : y), width, count, *m_sockets[(int)Monitor::Port::DATA_0].portDataPointer, *m_sockets[(int)Monitor::Port::DATA_1].portDataPointer);
+    markRectangle(x, y, width, height);
 }
 
-Byte* HbcMonitor::getPixelBuffer()
+void HbcMonitor::blitFromRam()
 {
-    Byte *pixelBuffer(nullptr);
+    int x, y, width, height;
+
+    if (!getRectangle(x, y, width, height))
+        return;
+
+    int bytesPerCell = (m_mode == Monitor::Mode::PIXEL ? 1 : (int)sizeof(CharData));
+    int stride = m_extension->read(Monitor::ExtensionPort::SIZE_X); // Rows of the source are not clipped
+
+    if (stride == 0)
+        stride = 256;
+
+    stride *= bytesPerCell;
+
+    int address = (m_extension->read(Monitor::ExtensionPort::ADDR_0) << 8) | m_extension->read(Monitor::ExtensionPort::ADDR_1);
+
+    m_ram->mutex.lock();
+
+    for (int row(0); row < height; row++)
+    {
+        int source = address + row * stride;
+        int cellsNb = std::min(width, (Ram::MEMORY_SIZE - source) / bytesPerCell); // Truncated at the end of the RAM
+
+        if (cellsNb <= 0)
+        {
+            height = row;
+            break;
+        }
+
+        if (m_mode == Monitor::Mode::PIXEL)
+        {
+            std::memcpy(m_pixelBuffer + (y + row) * WIDTH + x, m_ram->memory + source, cellsNb);
+        }
+        else // TEXT
+        {
+            CharData *line = m_textBuffer + (y + row) * TEXT_MODE_COLUMNS + x;
+
+            for (int i(0); i < cellsNb; i++)
+            {
+                line[i].colors = m_ram->memory[source + i * 2];
+                line[i].ascii = m_ram->memory[source + i * 2 + 1];
+            }
+        }
+    }
 
-    m_videoData.mutex.lock();
-    pixelBuffer = m_videoData.pixelBuffer;
-    m_videoData.mutex.unlock();
+    m_ram->mutex.unlock();
 
-    return pixelBuffer;
+    markRectangle(x, y, width, height);
 }
 
-Monitor::Mode HbcMonitor::getMode()
+void HbcMonitor::markRectangle(int x, int y, int width, int height)
 {
-    return m_mode;
+    for (int row(y); row < y + height; row++)
+    {
+        if (m_mode == Monitor::Mode::PIXEL)
+        {
+            m_dirtyMap.markPixelRow(row);
+        }
+        else // TEXT
+        {
+            for (int column(x); column < x + width; column++)
+            {
+                m_dirtyMap.markTextCell(column + row * TEXT_MODE_COLUMNS);
+            }
+        }
+    }
 }
 
+void HbcMonitor::updateVideoMapping()
+{
+    if (!m_videoMapped)
+    {
+        Ram::unmapDevice(*m_ram, this);
+        return;
+    }
+
+    Ram::mapDevice(*m_ram, this, m_videoMappedAddress, (m_mode == Monitor::Mode::PIXEL ? PIXEL_MODE_BUFFER_SIZE : TEXT_MODE_BUFFER_SIZE * (int)sizeof(CharData)));
+}
 
 // ===== MonitorWidget class =====
+// Shaders written for GLSL 1.10 / GLSL ES 1.00, so they also run on software renderers (Mesa llvmpipe)
+static const char *VERTEX_SHADER_SOURCE = R"(
+attribute vec2 vertex;
+uniform vec2 screenSize;
+varying vec2 screenPosition;
+
+void main()
+{
+    screenPosition = vec2(vertex.x + 1.0, 1.0 - vertex.y) * 0.5 * screenSize;
+    gl_Position = vec4(vertex, 0.0, 1.0);
+}
+)";
+
+static const char *FRAGMENT_SHADER_SOURCE = R"(
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D indexTexture;
+uniform sampler2D textTexture;
+uniform sampler2D fontTexture;
+uniform sampler2D paletteTexture;
+uniform bool textMode;
+uniform vec2 screenSize;
+uniform vec2 characterSize;
+uniform vec2 textSize;
+varying vec2 screenPosition;
+
+float readByte(sampler2D sampler, vec2 texel, vec2 size, int channel)
+{
+    vec4 value = texture2D(sampler, (texel + 0.5) / size);
+    return floor((channel == 0 ? value.r : value.a) * 255.0 + 0.5);
+}
+
+void main()
+{
+    vec2 pixel = floor(screenPosition);
+    float colorIndex = 0.0;
+
+    if (textMode)
+    {
+        vec2 cell = floor(pixel / characterSize);
+
+        if (cell.x < textSize.x && cell.y < textSize.y)
+        {
+            float colors = readByte(textTexture, cell, textSize, 0);
+            float ascii = readByte(textTexture, cell, textSize, 1);
+            vec2 glyphPixel = pixel - cell * characterSize;
+            float glyphRow = readByte(fontTexture, vec2(glyphPixel.y, ascii), vec2(characterSize.y, 256.0), 0);
+            float fontPixel = mod(floor(glyphRow / exp2(glyphPixel.x)), 2.0);
+
+            colorIndex = mix(floor(colors / 16.0), mod(colors, 16.0), fontPixel);
+        }
+    }
+    else
+    {
+        colorIndex = mod(readByte(indexTexture, pixel, screenSize, 0), 16.0);
+    }
+
+    gl_FragColor = vec4(texture2D(paletteTexture, vec2((colorIndex + 0.5) / 16.0, 0.5)).rgb, 1.0);
+}
+)";
+
 // PUBLIC
 MonitorWidget::MonitorWidget(HbcMonitor *hbcMonitor, Console *consoleOutput) : QOpenGLWidget(nullptr)
 {
@@ -171,6 +798,20 @@ MonitorWidget::MonitorWidget(HbcMonitor *hbcMonitor, Console *consoleOutput) : Q
     m_height = 0;
     m_texture = 0;
     m_hbcMonitor = hbcMonitor;
+    m_consoleOutput = consoleOutput;
+    m_fullRedraw = true;
+    m_uploadFirstRow = HEIGHT;
+    m_uploadLastRow = -1;
+
+    m_renderer = (int)Monitor::Renderer::UNKNOWN;
+    m_shaderProgram = nullptr;
+    m_indexTexture = 0;
+    m_textTexture = 0;
+    m_fontTexture = 0;
+    m_paletteTexture = 0;
+    m_stagedMode = Monitor::Mode::TEXT;
+    m_stagedPixels.assign(PIXEL_MODE_BUFFER_SIZE, 0x00);
+    m_stagedText.assign(TEXT_MODE_BUFFER_SIZE, CharData{ 0x00, 0x00 });
 
     m_pixelBuffer = new uint32_t[PIXEL_MODE_BUFFER_SIZE];
     for (unsigned int x(0); x < WIDTH; x++)
@@ -181,33 +822,10 @@ MonitorWidget::MonitorWidget(HbcMonitor *hbcMonitor, Console *consoleOutput) : Q
         }
     }
 
-    m_font.load(":/font/res/charMap.png");
-
-    m_charMap.clear();
-    if (!m_font.isNull())
+    if (!m_rasterizer.isFontLoaded())
     {
-        if (m_font.width() == (DISPLAYABLE_CHARS * CHARACTER_WIDTH) && m_font.height() == CHARACTER_HEIGHT)
-        {
-            for (unsigned int i(0); i < DISPLAYABLE_CHARS; i++)
-            {
-                bool *newChar(new bool[CHARACTER_WIDTH * CHARACTER_HEIGHT]);
-
-                for (unsigned int x(0); x < CHARACTER_WIDTH; x++)
-                {
-                    for (unsigned int y(0); y < CHARACTER_HEIGHT; y++)
-                    {
-                        newChar[x + y * CHARACTER_WIDTH] = m_font.pixel(x + i * CHARACTER_WIDTH, y) == Monitor::colorArray[(int)Monitor::Color::WHITE];
-                    }
-                }
-
-                m_charMap.push_back(newChar);
-            }
-        }
-        else
-        {
-            consoleOutput->log("Couldn't load character map for the emulator");
-            consoleOutput->returnLine();
-        }
+        consoleOutput->log("Couldn't load character map for the emulator");
+        consoleOutput->returnLine();
     }
 
     setSize(WIDTH, HEIGHT);
@@ -220,21 +838,62 @@ MonitorWidget::MonitorWidget(HbcMonitor *hbcMonitor, Console *consoleOutput) : Q
 MonitorWidget::~MonitorWidget()
 {
     delete m_thread;
+
+    makeCurrent();
+
+    delete m_shaderProgram;
+
+    GLuint textures[] = { m_texture, m_indexTexture, m_textTexture, m_fontTexture, m_paletteTexture };
+    glDeleteTextures(5, textures); // Names never created are 0, silently ignored
+
+    doneCurrent();
 }
 
-void MonitorWidget::updateBuffer()
+bool MonitorWidget::updateBuffer()
 {
-    if (m_hbcMonitor->getMode() == Monitor::Mode::TEXT)
+    bool freshFrame = m_hbcMonitor->acquireFrame();
+
+    if (!freshFrame && !m_fullRedraw)
+        return false; // Static screen, nothing to convert nor to upload
+
+    const Monitor::Frame &frame = m_hbcMonitor->getFrontFrame(); // Complete and stable until the next acquireFrame()
+    Monitor::DirtyMap dirtyMap = frame.dirtyMap;
+
+    if (m_fullRedraw)
+        dirtyMap.markAll();
+
+    m_fullRedraw = false;
+
+    Monitor::Renderer renderer = (Monitor::Renderer)m_renderer.load();
+
+    // Until OpenGL is initialized, both renderers are kept up to date
+    if (renderer != Monitor::Renderer::LEGACY)
     {
-        convertToPixelBuffer(m_hbcMonitor->getTextBuffer());
+        stageFrame(frame, dirtyMap);
     }
-    else // PIXELS
+
+    if (renderer != Monitor::Renderer::SHADER)
     {
-        convertToPixelBuffer(m_hbcMonitor->getPixelBuffer());
+        convertToPixelBuffer(frame, dirtyMap);
     }
 
     setBuffer(m_pixelBuffer);
     update();
+
+    return true;
+}
+
+bool MonitorWidget::waitForFrame(unsigned long timeoutMs)
+{
+    if (m_fullRedraw)
+        return true;
+
+    return m_hbcMonitor->waitForFrame(timeoutMs);
+}
+
+void MonitorWidget::wakeUp()
+{
+    m_hbcMonitor->wakeRenderer();
 }
 
 int MonitorWidget::getFPS()
@@ -286,14 +945,90 @@ void MonitorWidget::initializeGL()
 {
     initializeOpenGLFunctions();
 
-    glDisable(GL_ALPHA_TEST);
     glDisable(GL_BLEND);
     glDisable(GL_CULL_FACE);
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_DITHER);
-    glDisable(GL_POLYGON_SMOOTH);
     glDisable(GL_STENCIL_TEST);
 
+    if (initializeShaders())
+    {
+        m_renderer = (int)Monitor::Renderer::SHADER;
+    }
+    else
+    {
+        initializeLegacy();
+
+        m_renderer = (int)Monitor::Renderer::LEGACY;
+        m_consoleOutput->log("Shaders unsupported by the OpenGL context, the monitor uses the legacy renderer");
+    }
+}
+
+bool MonitorWidget::initializeShaders()
+{
+    m_shaderProgram = new QOpenGLShaderProgram;
+
+    bool compiled = m_shaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER_SOURCE)
+                 && m_shaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER_SOURCE);
+
+    m_shaderProgram->bindAttributeLocation("vertex", 0);
+
+    if (!compiled || !m_shaderProgram->link())
+    {
+        m_consoleOutput->log("Monitor shaders not compiled: " + m_shaderProgram->log());
+
+        delete m_shaderProgram;
+        m_shaderProgram = nullptr;
+
+        return false;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // Glyph atlas and palette never change (the atlas is CHARACTER_HEIGHT texels wide, 1 line per glyph)
+    m_fontTexture = createTexture();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, CHARACTER_HEIGHT, GLYPHS_NB, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, m_rasterizer.getGlyphAtlas().data());
+
+    Byte palette[COLORS_NB * 3];
+    for (int i(0); i < COLORS_NB; i++)
+    {
+        palette[i * 3] = qRed(Monitor::colorArray[i]);
+        palette[i * 3 + 1] = qGreen(Monitor::colorArray[i]);
+        palette[i * 3 + 2] = qBlue(Monitor::colorArray[i]);
+    }
+
+    m_paletteTexture = createTexture();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, COLORS_NB, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, palette);
+
+    // Video memory, uploaded again on each modification
+    m_uploadMutex.lock();
+
+    m_indexTexture = createTexture();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, WIDTH, HEIGHT, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, m_stagedPixels.data());
+
+    m_textTexture = createTexture();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, TEXT_MODE_COLUMNS, TEXT_MODE_ROWS, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, m_stagedText.data());
+
+    m_uploadMutex.unlock();
+
+    m_shaderProgram->bind();
+    m_shaderProgram->setUniformValue("indexTexture", 0);
+    m_shaderProgram->setUniformValue("textTexture", 1);
+    m_shaderProgram->setUniformValue("fontTexture", 2);
+    m_shaderProgram->setUniformValue("paletteTexture", 3);
+    m_shaderProgram->setUniformValue("screenSize", (GLfloat)WIDTH, (GLfloat)HEIGHT);
+    m_shaderProgram->setUniformValue("characterSize", (GLfloat)CHARACTER_WIDTH, (GLfloat)CHARACTER_HEIGHT);
+    m_shaderProgram->setUniformValue("textSize", (GLfloat)TEXT_MODE_COLUMNS, (GLfloat)TEXT_MODE_ROWS);
+    m_shaderProgram->release();
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+void MonitorWidget::initializeLegacy()
+{
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_POLYGON_SMOOTH);
+
     glEnable(GL_TEXTURE_2D);
     glGenTextures(1, &m_texture);
     glBindTexture(GL_TEXTURE_2D, m_texture);
@@ -305,7 +1040,24 @@ void MonitorWidget::initializeGL()
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
+    m_uploadMutex.lock();
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_width, m_height, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, m_pixelBuffer);
+    m_uploadMutex.unlock();
+}
+
+GLuint MonitorWidget::createTexture()
+{
+    GLuint texture;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    return texture;
 }
 
 void MonitorWidget::resizeGL(int w, int h)
@@ -316,9 +1068,70 @@ void MonitorWidget::resizeGL(int w, int h)
 }
 
 void MonitorWidget::paintGL()
+{
+    int firstRow, lastRow;
+
+    m_uploadMutex.lock();
+    firstRow = m_uploadFirstRow;
+    lastRow = m_uploadLastRow;
+    m_uploadFirstRow = HEIGHT;
+    m_uploadLastRow = -1;
+
+    // Both renderers read a buffer the MonitorThread writes, it waits until the upload is done
+    if ((Monitor::Renderer)m_renderer.load() == Monitor::Renderer::SHADER)
+        paintShaders(firstRow, lastRow); // Reads the staged video memory
+    else
+        paintLegacy(firstRow, lastRow); // Reads m_pixelBuffer
+
+    m_uploadMutex.unlock();
+}
+
+void MonitorWidget::paintShaders(int firstRow, int lastRow)
+{
+    static const GLfloat vertices[] = { -1.0f, -1.0f,   1.0f, -1.0f,   -1.0f, 1.0f,   1.0f, 1.0f };
+
+    // Only the modified video memory is uploaded, 1 byte per pixel or 2 bytes per character
+    if (lastRow >= firstRow)
+    {
+        if (m_stagedMode == Monitor::Mode::TEXT)
+        {
+            glBindTexture(GL_TEXTURE_2D, m_textTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TEXT_MODE_COLUMNS, TEXT_MODE_ROWS, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, m_stagedText.data());
+        }
+        else
+        {
+            glBindTexture(GL_TEXTURE_2D, m_indexTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, WIDTH, lastRow - firstRow + 1, GL_LUMINANCE, GL_UNSIGNED_BYTE, m_stagedPixels.data() + firstRow * WIDTH);
+        }
+    }
+
+    GLuint textures[] = { m_indexTexture, m_textTexture, m_fontTexture, m_paletteTexture };
+    for (int i(0); i < 4; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    m_shaderProgram->bind();
+    m_shaderProgram->setUniformValue("textMode", (GLint)(m_stagedMode == Monitor::Mode::TEXT));
+    m_shaderProgram->enableAttributeArray(0);
+    m_shaderProgram->setAttributeArray(0, GL_FLOAT, vertices, 2);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    m_shaderProgram->disableAttributeArray(0);
+    m_shaderProgram->release();
+}
+
+void MonitorWidget::paintLegacy(int firstRow, int lastRow)
 {
     glBindTexture(GL_TEXTURE_2D, m_texture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, m_pixelBuffer);
+
+    if (lastRow >= firstRow) // Only the modified rows are uploaded
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_width, lastRow - firstRow + 1, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, m_pixelBuffer + firstRow * m_width);
+    }
 
     glBegin(GL_QUADS);
 
@@ -337,68 +1150,61 @@ void MonitorWidget::paintGL()
     glEnd();
 }
 
-void MonitorWidget::convertToPixelBuffer(Monitor::CharData *textBuffer)
+void MonitorWidget::convertToPixelBuffer(const Monitor::Frame &frame, const Monitor::DirtyMap &dirtyMap)
 {
-    Byte asciiCode, colors;
-    int index;
+    int firstRow(HEIGHT), lastRow(-1);
+
+    m_uploadMutex.lock(); // paintLegacy() may be uploading m_pixelBuffer
 
-    for (unsigned int column(0); column < TEXT_MODE_COLUMNS; column++)
+    if (frame.mode == Monitor::Mode::TEXT)
     {
-        for (unsigned int row(0); row < TEXT_MODE_ROWS; row++)
-        {
-            asciiCode = textBuffer[column + row * TEXT_MODE_COLUMNS].ascii;
-            colors = textBuffer[column + row * TEXT_MODE_COLUMNS].colors;
+        m_rasterizer.render(frame.textBuffer, dirtyMap, m_pixelBuffer, firstRow, lastRow);
+    }
+    else // PIXELS
+    {
+        m_rasterizer.render(frame.pixelBuffer, dirtyMap, m_pixelBuffer, firstRow, lastRow);
+    }
 
-            if (asciiCode >= 32 && asciiCode <= 126)
-            {
-                for (unsigned int x(0); x < CHARACTER_WIDTH; x++)
-                {
-                    for (unsigned int y(0); y < CHARACTER_HEIGHT; y++)
-                    {
-                        index = (column * CHARACTER_WIDTH + x) + (row * CHARACTER_HEIGHT + y) * WIDTH;
-
-                        if (m_charMap[asciiCode - 32][x + y * CHARACTER_WIDTH])
-                        {
-                            m_pixelBuffer[index] = Monitor::colorArray[colors & 0x0F];
-                        }
-                        else
-                        {
-                            m_pixelBuffer[index] = Monitor::colorArray[(colors & 0xF0) >> 4];
-                        }
-                    }
-                }
-            }
-            else
-            {
-                for (unsigned int x(0); x < CHARACTER_WIDTH; x++)
-                {
-                    for (unsigned int y(0); y < CHARACTER_HEIGHT; y++)
-                    {
-                        index = (column * CHARACTER_WIDTH + x) + (row * CHARACTER_HEIGHT + y) * WIDTH;
+    m_uploadFirstRow = std::min(m_uploadFirstRow, firstRow);
+    m_uploadLastRow = std::max(m_uploadLastRow, lastRow);
 
-                        m_pixelBuffer[index] = Monitor::colorArray[colors & 0x0F];
-                    }
-                }
-            }
-        }
-    }
+    m_uploadMutex.unlock();
 }
 
-void MonitorWidget::convertToPixelBuffer(Byte *pixelBuffer)
+void MonitorWidget::stageFrame(const Monitor::Frame &frame, const Monitor::DirtyMap &dirtyMap)
 {
-    int index;
+    int firstRow(HEIGHT), lastRow(-1);
 
-    for (unsigned int x(0); x < WIDTH; x++)
+    m_uploadMutex.lock();
+
+    bool full = dirtyMap.full || frame.mode != m_stagedMode;
+    m_stagedMode = frame.mode;
+
+    if (frame.mode == Monitor::Mode::TEXT)
     {
-        for (unsigned int y(0); y < HEIGHT; y++)
+        std::memcpy(m_stagedText.data(), frame.textBuffer, sizeof(frame.textBuffer)); // 2 KiB, always uploaded at once
+        firstRow = 0;
+        lastRow = HEIGHT - 1;
+    }
+    else
+    {
+        for (int y(0); y < HEIGHT; y++)
         {
-            index = x + y * WIDTH;
+            if (!full && !(dirtyMap.pixelRows[y / DIRTY_WORD_BITS] & ((uint64_t)1 << (y % DIRTY_WORD_BITS))))
+                continue;
+
+            std::memcpy(m_stagedPixels.data() + y * WIDTH, frame.pixelBuffer + y * WIDTH, WIDTH);
 
-            m_pixelBuffer[index] = Monitor::colorArray[pixelBuffer[index] & 0x0F];
+            firstRow = std::min(firstRow, y);
+            lastRow = std::max(lastRow, y);
         }
     }
-}
 
+    m_uploadFirstRow = std::min(m_uploadFirstRow, firstRow);
+    m_uploadLastRow = std::max(m_uploadLastRow, lastRow);
+
+    m_uploadMutex.unlock();
+}
 
 // ===== MonitorThread class =====
 MonitorThread::MonitorThread(MonitorWidget *monitor)
@@ -414,6 +1220,8 @@ MonitorThread::~MonitorThread()
     m_status.stopCmd = true;
     m_status.mutex.unlock();
 
+    m_monitor->wakeUp();
+
     wait();
 }
 
@@ -421,24 +1229,34 @@ void MonitorThread::run()
 {
     bool stop(false);
 
-    QElapsedTimer fpsTargetTimer;
+    QElapsedTimer frameTimer;
 
-    fpsTargetTimer.start();
+    frameTimer.start();
     m_status.fpsCountTimer.start();
     while (!stop)
     {
-        if (fpsTargetTimer.elapsed() >= 1000.f / FPS_TARGET) // in ms
+        // Sleeps while the screen does not change (woken as soon as the emulator publishes a frame)
+        if (m_monitor->waitForFrame(IDLE_WAIT_MS))
         {
-            fpsTargetTimer.restart();
+            // Never more than FPS_TARGET frames per second
+            qint64 remainingUs = FRAME_DURATION_US - frameTimer.nsecsElapsed() / 1000;
 
-            m_monitor->updateBuffer();
+            if (remainingUs > 0)
+                usleep(remainingUs);
 
-            m_status.mutex.lock();
-            stop = m_status.stopCmd;
-            m_status.mutex.unlock();
+            frameTimer.restart();
 
-            m_status.fpsCount++;
+            if (m_monitor->updateBuffer())
+            {
+                m_status.mutex.lock();
+                m_status.fpsCount++;
+                m_status.mutex.unlock();
+            }
         }
+
+        m_status.mutex.lock();
+        stop = m_status.stopCmd;
+        m_status.mutex.unlock();
     }
 }
 
@@ -541,13 +1359,13 @@ void MonitorDialog::keyPressEvent(QKeyEvent *event)
     }
     else
     {
-        m_hbcKeyboard->sendKeyCode((Qt::Key)event->nativeScanCode(), false);
+        m_hbcKeyboard->sendKeyCode((Qt::Key)event->nativeScanCode(), false, event->isAutoRepeat());
     }
 }
 
 void MonitorDialog::keyReleaseEvent(QKeyEvent *event)
 {
-    m_hbcKeyboard->sendKeyCode((Qt::Key)event->nativeScanCode(), true);
+    m_hbcKeyboard->sendKeyCode((Qt::Key)event->nativeScanCode(), true, event->isAutoRepeat());
 }
 
 void MonitorDialog::closeEvent(QCloseEvent *event)
@@ -8,13 +8,22 @@
  * \version 0.1
  * \date 27/08/2023
  */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <cstdint>
 #include <QDialog>
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
 #include "keyboard.h"
+#include "ram.h"
 #include "config.h"
+#include "monitorCapture.h"
 
 /*!
  * \namespace Monitor
@@ -23,6 +32,7 @@
 namespace Monitor
 {
     constexpr Byte DEVICE_ID = 0x4A; //!< Random to "look" nice
+    constexpr Byte EXTENSION_DEVICE_ID = 0x4B; //!< Next to DEVICE_ID, see HbcMonitorExtension
 
     constexpr int WIDTH = 256;
     constexpr int HEIGHT = 192;
@@ -35,17 +45,30 @@ namespace Monitor
     constexpr int TEXT_MODE_ROWS = 24;
 
     constexpr int PORTS_NB = 5;
+    constexpr int EXTENSION_PORTS_NB = 5;
     constexpr int PIXEL_MODE_BUFFER_SIZE = (WIDTH * HEIGHT); //!< The HBC-2 documentation specifies 2 pixels per byte (4-bit colors), <b>dropped here</b>
     constexpr int TEXT_MODE_BUFFER_SIZE = (TEXT_MODE_COLUMNS * TEXT_MODE_ROWS);
 
     constexpr int DISPLAYABLE_CHARS = 95;
+    constexpr int GLYPHS_NB = 256; //!< One glyph per byte value, so any ASCII code indexes the glyph atlas directly
+    constexpr Byte SOLID_GLYPH_ROW = (1 << CHARACTER_WIDTH) - 1; //!< Non displayable characters are filled with the font color
+
+    constexpr int DIRTY_WORD_BITS = 64;
+    constexpr int TEXT_DIRTY_WORDS = (TEXT_MODE_BUFFER_SIZE + DIRTY_WORD_BITS - 1) / DIRTY_WORD_BITS; //!< 1 bit per character cell
+    constexpr int PIXEL_DIRTY_WORDS = (HEIGHT + DIRTY_WORD_BITS - 1) / DIRTY_WORD_BITS; //!< 1 bit per row of pixels
 
     constexpr int FPS_TARGET = 60;
+    constexpr int FRAME_DURATION_US = 1000000 / FPS_TARGET;
+    constexpr int IDLE_WAIT_MS = 100; //!< Longest sleep of the monitor thread when the screen does not change
     constexpr int COLORS_NB = 16; //!< 4-bit colors
 
     enum class Port { DATA_0 = 0, DATA_1 = 1, POS_X = 2, POS_Y = 3, CMD = 4 }; //!< Lists the ports used by the Monitor device
-    enum class Command { NOP = 0, WRITE = 1, READ = 2, SWITCH_TO_PIXEL_MODE = 3, SWITCH_TO_TEXT_MODE = 4 }; //!< Lists the commands for the Monitor device
+    enum class ExtensionPort { SIZE_X = 0, SIZE_Y = 1, COUNT = 2, ADDR_0 = 3, ADDR_1 = 4 }; //!< Lists the ports used by the Monitor extension device
+    enum class Command { NOP = 0, WRITE = 1, READ = 2, SWITCH_TO_PIXEL_MODE = 3, SWITCH_TO_TEXT_MODE = 4,
+                         WRITE_NEXT = 5, READ_NEXT = 6, FILL_RECT = 7, SCROLL_UP = 8, SCROLL_DOWN = 9, BLIT_FROM_RAM = 10,
+                         MAP_VIDEO_MEMORY = 11, UNMAP_VIDEO_MEMORY = 12 }; //!< Lists the commands for the Monitor device
     enum class Mode { PIXEL = 0, TEXT = 1 }; //!< Lists the commands for the Monitor device
+    enum class Renderer { UNKNOWN = 0, LEGACY = 1, SHADER = 2 }; //!< Lists the ways MonitorWidget draws frames, UNKNOWN until OpenGL is initialized
 
     enum class Color { BLACK = 0,    BLUE,           GREEN,         CYAN,
                        RED,          MAGENTA,        BROWN_COLOR,   LIGHT_GRAY,
@@ -66,18 +89,83 @@ namespace Monitor
         Byte colors; //!< 4 most significant bits coding the background color, the 4 others coding the font color
         Byte ascii; //!< See the displayable characters in HbcMonitor
     };
+    static_assert(sizeof(CharData) == 2, "CharData is uploaded as a 2-channel texture");
 
     /*!
-     * \struct VideoData
-     * \brief Stores buffers for all video modes
+     * \struct DirtyMap
+     * \brief Stores the regions of the video memory modified since the last frame
      */
-    struct VideoData
+    struct DirtyMap
     {
-        QMutex mutex;
+        bool any; //!< Set if anything must be redrawn
+        bool full; //!< Everything must be redrawn (reset, mode switch)
+        uint64_t textCells[TEXT_DIRTY_WORDS]; //!< Bit <i>n</i> of word <i>n / 64</i> set if the character cell <i>n</i> was written
+        uint64_t pixelRows[PIXEL_DIRTY_WORDS]; //!< Bit <i>y</i> of word <i>y / 64</i> set if a pixel of the row <i>y</i> was written
+
+        void clear()
+        {
+            any = false;
+            full = false;
+            std::fill(std::begin(textCells), std::end(textCells), 0);
+            std::fill(std::begin(pixelRows), std::end(pixelRows), 0);
+        }
+
+        void markAll()
+        {
+            any = true;
+            full = true;
+        }
+
+        void markTextCell(int index)
+        {
+            any = true;
+            textCells[index / DIRTY_WORD_BITS] |= (uint64_t)1 << (index % DIRTY_WORD_BITS);
+        }
+
+        void markPixelRow(int row)
+        {
+            any = true;
+            pixelRows[row / DIRTY_WORD_BITS] |= (uint64_t)1 << (row % DIRTY_WORD_BITS);
+        }
+
+        void merge(const DirtyMap &other)
+        {
+            any = any || other.any;
+            full = full || other.full;
+
+            for (int i(0); i < TEXT_DIRTY_WORDS; i++)
+            {
+                textCells[i] |= other.textCells[i];
+            }
+
+            for (int i(0); i < PIXEL_DIRTY_WORDS; i++)
+            {
+                pixelRows[i] |= other.pixelRows[i];
+            }
+        }
+
+        bool empty() const
+        {
+            return !any;
+        }
+    };
+
+    /*!
+     * \struct Frame
+     * \brief Stores the video memory for all video modes
+     */
+    struct Frame
+    {
+        Mode mode;
         CharData textBuffer[TEXT_MODE_BUFFER_SIZE];
         Byte pixelBuffer[PIXEL_MODE_BUFFER_SIZE];
+        DirtyMap dirtyMap; //!< Regions modified since the previous frame
     };
 
+    constexpr int FRAMES_NB = 3; //!< Back (written by the emulator), middle (last published) and front (read by the renderer)
+    constexpr int FRAME_INDEX_MASK = 0x03;
+    constexpr int FRESH_FRAME_FLAG = 0x04; //!< Set in the middle frame index when the renderer has not taken it yet
+
     /*!
      * \struct Status
      * \brief Contains thread safe data to control the monitor
@@ -92,6 +180,45 @@ namespace Monitor
     };
 }
 
+/*!
+ * \class MonitorRasterizer
+ * \brief Converts the video memory to ARGB pixels on the CPU
+ *
+ * Used by MonitorWidget when shaders are not available, and by MonitorCapture.<br>
+ * The font is stored as a glyph atlas of 1 byte per glyph row, expanded to pixels without branching.
+ */
+class MonitorRasterizer
+{
+    public:
+        MonitorRasterizer(); //!< Loads the glyph atlas from the font resource
+
+        bool isFontLoaded();
+
+        /*!
+         * \return Bit <i>x</i> of [code * CHARACTER_HEIGHT + <i>y</i>] set if the pixel (<i>x</i>, <i>y</i>) of the glyph uses the font color
+         */
+        const std::array<Byte, Monitor::GLYPHS_NB * Monitor::CHARACTER_HEIGHT>& getGlyphAtlas();
+
+        /*!
+         * \brief Only redraws the regions of <i>dirtyMap</i>, in memory order
+         * \param destination WIDTH * HEIGHT ARGB pixels
+         * \param firstRow Lowered to the first row of pixels redrawn
+         * \param lastRow Raised to the last row of pixels redrawn
+         */
+        void render(const Monitor::CharData *textBuffer, const Monitor::DirtyMap &dirtyMap, uint32_t *destination, int &firstRow, int &lastRow);
+        void render(const Byte *pixelBuffer, const Monitor::DirtyMap &dirtyMap, uint32_t *destination, int &firstRow, int &lastRow);
+
+    private:
+        /*!
+         * \brief Expands a row of glyph (1 bit per pixel) to CHARACTER_WIDTH pixels, without branching
+         */
+        void blitGlyphRow(uint32_t *destination, Byte glyphRow, uint32_t fontColor, uint32_t backgroundColor);
+
+        bool m_fontLoaded;
+        std::array<Byte, Monitor::GLYPHS_NB * Monitor::CHARACTER_HEIGHT> m_glyphAtlas;
+        std::array<std::array<uint32_t, Monitor::CHARACTER_WIDTH>, 1 << Monitor::CHARACTER_WIDTH> m_glyphRowMasks; //!< Pixel masks (0x00000000 or 0xFFFFFFFF) of every possible glyph row
+};
+
 /*!
  * \class HbcMonitor
  * \brief Derived from HbcPeripheral, represents the Monitor device
@@ -99,6 +226,9 @@ namespace Monitor
  * This class is responsible for emulating the HBC-2 monitor. It uses a separate thread to increase performance.<br>
  * It uses a thread safe struct (Monitor::Status) to be controlled by the main thread.
  *
+ * The video memory is only accessed by the emulator thread. At the monitor frame rate, it is copied to a triple buffer (Monitor::Frame)
+ * from which the renderer always reads a complete frame, without any lock shared with the emulator.
+ *
  * <b>Device ID:</b> 0x4A
  *
  * <h2>Color palette</h2>
@@ -204,27 +334,234 @@ namespace Monitor
  *   <td>SWITCH_TO_TEXT_MODE</td>
  *   <td>Switches to <b>colored text mode</b><br><b>WARNING:</b> Does not flush the pixel buffer</td>
  *  </tr>
+ *  <tr>
+ *   <td>5</td>
+ *   <td>WRITE_NEXT</td>
+ *   <td>Same as WRITE, then moves POS_X and POS_Y to the next pixel or character</td>
+ *  </tr>
+ *  <tr>
+ *   <td>6</td>
+ *   <td>READ_NEXT</td>
+ *   <td>Same as READ, then moves POS_X and POS_Y to the next pixel or character</td>
+ *  </tr>
+ *  <tr>
+ *   <td>7</td>
+ *   <td>FILL_RECT</td>
+ *   <td>Fills the rectangle (POS_X, POS_Y, SIZE_X, SIZE_Y) with DATA_0 (and DATA_1 in colored text mode)</td>
+ *  </tr>
+ *  <tr>
+ *   <td>8</td>
+ *   <td>SCROLL_UP</td>
+ *   <td>Moves the content of the rectangle up by COUNT rows, the freed rows are filled like FILL_RECT</td>
+ *  </tr>
+ *  <tr>
+ *   <td>9</td>
+ *   <td>SCROLL_DOWN</td>
+ *   <td>Moves the content of the rectangle down by COUNT rows, the freed rows are filled like FILL_RECT</td>
+ *  </tr>
+ *  <tr>
+ *   <td>10</td>
+ *   <td>BLIT_FROM_RAM</td>
+ *   <td>Copies the rectangle from RAM at ADDR_0:ADDR_1, row after row <i>(1 byte per pixel, or 2 bytes per character: colors then ASCII code)</i></td>
+ *  </tr>
+ *  <tr>
+ *   <td>11</td>
+ *   <td>MAP_VIDEO_MEMORY</td>
+ *   <td>Maps the video memory of the current mode at the address ADDR_0:ADDR_1 (see below)</td>
+ *  </tr>
+ *  <tr>
+ *   <td>12</td>
+ *   <td>UNMAP_VIDEO_MEMORY</td>
+ *   <td>Gives the RAM hidden by the window back to HbcCpu</td>
+ *  </tr>
  * </table>
  *
+ * Commands 7 to 11 read their parameters from the ports of HbcMonitorExtension, they are ignored if it is not plugged.
+ *
+ * Commands 1 to 4 are executed on every tick until CMD is changed by HbcCpu, switching to the current mode does nothing.<br>
+ * Commands 5 to 12 are executed once, then the CMD port is set back to <b>NOP</b>: writing a pixel only takes 2 <b>OUT</b> (DATA_0 and CMD) with WRITE_NEXT.
+ *
+ * The cursor of WRITE_NEXT and READ_NEXT goes to the next row after the last column, and back to (0, 0) after the last row.<br>
+ * Rectangles are clipped to the screen, in pixels or in characters depending on the video mode.
+ *
  * Any invalid command will result in <b>NOP</b>.
+ *
+ * <h2>Memory-mapped video memory</h2>
+ * After MAP_VIDEO_MEMORY, the reads and writes of HbcCpu in a window of the address space access the video memory instead of the RAM,
+ * so a character is drawn with a single <b>STR</b>.<br>
+ * The window has the layout of the video memory of the current mode, and follows its mode switches:
+ * - colored text mode: 2,016 bytes, 2 bytes per character (colors, then ASCII code), row after row,
+ * - pixel mode: 49,152 bytes, 1 byte per pixel, row after row <i>(the window is truncated at the end of the address space)</i>.
+ *
+ * The window is removed when the emulator is reset.
+ *
+ * The frames can also be written to files with a MonitorCapture, without opening MonitorDialog.
  */
-class HbcMonitor : public HbcPeripheral
+class HbcMonitorExtension;
+
+class HbcMonitor final : public HbcPeripheral, public HbcMemoryMappedDevice
 {
     public:
-        HbcMonitor(HbcIod *iod, Console *consoleOutput);
+        HbcMonitor(HbcRam *ram, HbcIod *iod, Console *consoleOutput);
         ~HbcMonitor();
 
         void init() override; //!< See HbcPeripheral for the overriden method
         void tick(bool step) override;
 
-        Monitor::CharData* getTextBuffer();
-        Byte* getPixelBuffer();
-        Monitor::Mode getMode();
+        /*!
+         * \brief Writes a block of bytes in the video memory of the current mode
+         *
+         * In text mode, the video memory is seen as TEXT_MODE_BUFFER_SIZE pairs of bytes (colors, then ASCII code).
+         *
+         * \param index Index of the first byte written
+         * \return the number of bytes written <i>(the copy stops at the end of the video memory)</i>
+         */
+        int writeVideoMemory(int index, const Byte *data, int size);
+
+        /*!
+         * \brief <b>Emulator thread</b>, makes the video memory visible to the renderer if it was modified
+         *
+         * Called by HbcEmulator at the monitor frame rate.
+         */
+        void publishFrame();
+
+        /*!
+         * \brief <b>Renderer thread</b>, takes the last published frame if it was not already taken
+         * \return <b>false</b> if nothing was published since the last call
+         */
+        bool acquireFrame();
+
+        /*!
+         * \brief <b>Renderer thread</b>, the returned frame is not modified until the next acquireFrame()
+         */
+        const Monitor::Frame& getFrontFrame();
+
+        /*!
+         * \brief <b>Renderer thread</b>, sleeps until a frame is published
+         * \param timeoutMs Longest sleep
+         * \return <b>true</b> if a frame can be acquired
+         */
+        bool waitForFrame(unsigned long timeoutMs);
+        void wakeRenderer(); //!< Ends waitForFrame() immediately
+
+        /*!
+         * \brief <b>Emulator thread</b>, renders the current video memory without OpenGL
+         * \param destination WIDTH * HEIGHT ARGB pixels
+         */
+        void renderFrame(uint32_t *destination);
+
+        /*!
+         * \brief Captures a frame every MonitorCapture::getInterval() ticks, the monitor takes ownership of <i>capture</i>
+         */
+        void setCapture(MonitorCapture *capture);
+
+        /*!
+         * \brief Gives the ports used by the bulk commands, the extension is not owned by the monitor
+         */
+        void setExtension(HbcMonitorExtension *extension);
+
+        Byte readMapped(int offset) override; //!< See HbcMemoryMappedDevice for the overriden methods
+        void writeMapped(int offset, Byte data) override;
 
     private:
-        Monitor::VideoData m_videoData;
+        void writeCell(int index, Byte data0, Byte data1);
+        void readCell(int index);
+        void advanceCursor();
+
+        /*!
+         * \brief Clips the rectangle given by the ports to the screen of the current mode
+         * \return <b>false</b> if the clipped rectangle is empty
+         */
+        bool getRectangle(int &x, int &y, int &width, int &height);
+
+        void fillRectangle(int x, int y, int width, int height, Byte data0, Byte data1);
+        void scrollRectangle(bool up);
+        void blitFromRam();
+        void markRectangle(int x, int y, int width, int height);
+        void updateVideoMapping(); //!< Resizes the window to the video memory of the current mode
 
+        HbcRam *m_ram;
+        HbcMonitorExtension *m_extension; //!< <b>nullptr</b> if not plugged
+        bool m_videoMapped;
+        Word m_videoMappedAddress;
+
+        // Video memory, only accessed by the emulator thread
         Monitor::Mode m_mode;
+        Monitor::CharData m_textBuffer[Monitor::TEXT_MODE_BUFFER_SIZE];
+        Byte m_pixelBuffer[Monitor::PIXEL_MODE_BUFFER_SIZE];
+        Monitor::DirtyMap m_dirtyMap; //!< Regions modified since the last publication
+        Monitor::DirtyMap m_lastPublishedDirtyMap; //!< Kept in case the renderer skips the last published frame
+
+        // Triple buffering
+        Monitor::Frame m_frames[Monitor::FRAMES_NB];
+        int m_backFrameIndex; //!< Owned by the emulator thread
+        std::atomic<int> m_middleFrameIndex; //!< Exchanged by both threads, with FRESH_FRAME_FLAG
+        int m_frontFrameIndex; //!< Owned by the renderer thread
+
+        QMutex m_frameMutex; //!< Only protects the sleep of the renderer
+        QWaitCondition m_frameReady;
+
+        // Headless capture
+        MonitorCapture *m_capture;
+        MonitorRasterizer *m_captureRasterizer; //!< Only created if a capture is set
+        std::vector<uint32_t> m_captureBuffer;
+        quint64 m_ticksNb; //!< Since the last init()
+};
+
+/*!
+ * \class HbcMonitorExtension
+ * \brief Derived from HbcPeripheral, holds the parameters of the bulk commands of HbcMonitor
+ *
+ * <b>Device ID:</b> 0x4B
+ *
+ * Plugged after every other built-in device, so the ports of HbcMonitor and of the devices plugged after it
+ * are the same as before the bulk commands existed.<br>
+ * The extension executes nothing: HbcMonitor reads its ports when HbcCpu sends a command needing them.
+ *
+ * <table>
+ *  <caption>List of available ports</caption>
+ *  <tr>
+ *   <th>ID</th>
+ *   <th>Port</th>
+ *   <th>Description</th>
+ *  </tr>
+ *  <tr>
+ *   <td>0</td>
+ *   <td>SIZE_X</td>
+ *   <td>Width of the rectangle used by FILL_RECT, SCROLL_UP, SCROLL_DOWN and BLIT_FROM_RAM <i>(0 means 256)</i></td>
+ *  </tr>
+ *  <tr>
+ *   <td>1</td>
+ *   <td>SIZE_Y</td>
+ *   <td>Height of the rectangle <i>(0 means 256)</i></td>
+ *  </tr>
+ *  <tr>
+ *   <td>2</td>
+ *   <td>COUNT</td>
+ *   <td>Number of pixel rows or character rows scrolled by SCROLL_UP and SCROLL_DOWN</td>
+ *  </tr>
+ *  <tr>
+ *   <td>3</td>
+ *   <td>ADDR_0</td>
+ *   <td>Most significant byte of the RAM address read by BLIT_FROM_RAM, or of the window set by MAP_VIDEO_MEMORY</td>
+ *  </tr>
+ *  <tr>
+ *   <td>4</td>
+ *   <td>ADDR_1</td>
+ *   <td>Least significant byte of the RAM address</td>
+ *  </tr>
+ * </table>
+ */
+class HbcMonitorExtension final : public HbcPeripheral
+{
+    public:
+        HbcMonitorExtension(HbcIod *iod, Console *consoleOutput);
+
+        void init() override;
+        void tick(bool step) override; //!< No operation, see class description
+
+        bool isPlugged() const; //!< <b>false</b> if HbcIod had not enough ports
+        Byte read(Monitor::ExtensionPort port) const;
 };
 
 class MainWindow;
@@ -238,7 +575,13 @@ class MonitorWidget : public QOpenGLWidget, protected QOpenGLFunctions
         MonitorWidget(HbcMonitor *hbcMonitor, Console *consoleOutput); //!< Creates the monitor widget and runs the HbcMonitor thread
         ~MonitorWidget();
 
-        void updateBuffer(); //!< Updates the pixel buffer
+        /*!
+         * \brief Updates the pixel buffer
+         * \return <b>false</b> if the frame was skipped because nothing changed
+         */
+        bool updateBuffer();
+        bool waitForFrame(unsigned long timeoutMs); //!< See HbcMonitor::waitForFrame()
+        void wakeUp(); //!< Ends waitForFrame() immediately
         int getFPS();
 
     private:
@@ -250,12 +593,29 @@ class MonitorWidget : public QOpenGLWidget, protected QOpenGLFunctions
         void resizeGL(int w, int h) override;
         void paintGL() override;
 
-        void convertToPixelBuffer(Monitor::CharData *textBuffer);
-        void convertToPixelBuffer(Byte *pixelBuffer);
+        /*!
+         * \brief Only redraws the regions of <i>dirtyMap</i> and extends the rows waiting to be uploaded
+         */
+        void convertToPixelBuffer(const Monitor::Frame &frame, const Monitor::DirtyMap &dirtyMap);
+
+        /*!
+         * \brief Copies the modified video memory of <i>frame</i> for the shader renderer, which expands it on the GPU
+         */
+        void stageFrame(const Monitor::Frame &frame, const Monitor::DirtyMap &dirtyMap);
+
+        /*!
+         * \brief Compiles the shaders and creates their textures
+         * \return <b>false</b> if the OpenGL context does not support them <i>(the legacy renderer is used instead)</i>
+         */
+        bool initializeShaders();
+        void initializeLegacy();
+        void paintShaders(int firstRow, int lastRow);
+        void paintLegacy(int firstRow, int lastRow);
+        GLuint createTexture();
 
         HbcMonitor *m_hbcMonitor;
-        QImage m_font;
-        std::vector<bool*> m_charMap;
+        Console *m_consoleOutput;
+        MonitorRasterizer m_rasterizer;
         MonitorThread *m_thread;
 
         unsigned int m_width;
@@ -264,6 +624,22 @@ class MonitorWidget : public QOpenGLWidget, protected QOpenGLFunctions
         GLuint m_texture;
 
         uint32_t *m_pixelBuffer;
+
+        // Shader renderer
+        std::atomic<int> m_renderer; //!< Monitor::Renderer, chosen when OpenGL is initialized
+        QOpenGLShaderProgram *m_shaderProgram;
+        GLuint m_indexTexture; //!< Pixel mode video memory, 1 byte per pixel
+        GLuint m_textTexture; //!< Text mode video memory, 1 texel (colors, ASCII code) per character
+        GLuint m_fontTexture; //!< Glyph atlas, 1 texel per glyph row
+        GLuint m_paletteTexture; //!< Monitor::colorArray
+        Monitor::Mode m_stagedMode;
+        std::vector<Byte> m_stagedPixels;
+        std::vector<Monitor::CharData> m_stagedText;
+
+        bool m_fullRedraw; //!< Set until the first frame is drawn, the video memory may have been modified before the widget existed
+        QMutex m_uploadMutex;
+        int m_uploadFirstRow; //!< First row of pixels to upload in the texture
+        int m_uploadLastRow; //!< Last row of m_pixelBuffer to upload in the texture <i>(smaller than m_uploadFirstRow if nothing changed)</i>
 };
 
 class MonitorThread : public QThread
@@ -0,0 +1,213 @@
+#include "monitorCapture.h"
+
+#include <QImage>
+#include <QDataStream>
+#include <QTextStream>
+#include <algorithm>
+
+// CaptureWorker PUBLIC
+CaptureWorker::CaptureWorker(MonitorCapture *capture)
+{
+    m_capture = capture;
+}
+
+CaptureWorker::~CaptureWorker()
+{
+    requestInterruption();
+    wait();
+}
+
+// CaptureWorker PROTECTED
+void CaptureWorker::run()
+{
+    while (!isInterruptionRequested())
+    {
+        writeFrames();
+
+        msleep(POLL_INTERVAL_MS);
+    }
+
+    writeFrames(); // Frames captured just before the capture was stopped
+}
+
+// CaptureWorker PRIVATE
+void CaptureWorker::writeFrames()
+{
+    while (m_capture->m_frames.pop(m_frame))
+    {
+        m_capture->writeFrame(m_frame);
+    }
+}
+
+// MonitorCapture PUBLIC
+MonitorCapture::MonitorCapture(QString projectDirPath, Emulator::CaptureFormat format, unsigned int intervalTicks, int width, int height, Console *consoleOutput)
+{
+    m_directory.setPath(QDir(projectDirPath).filePath(DIRECTORY_NAME));
+    m_format = format;
+    m_interval = std::max(intervalTicks, 1u);
+    m_width = width;
+    m_height = height;
+    m_consoleOutput = consoleOutput;
+
+    m_started = false;
+    m_framesNb = 0;
+    m_worker = nullptr;
+}
+
+MonitorCapture::~MonitorCapture()
+{
+    stop();
+}
+
+bool MonitorCapture::start()
+{
+    stop();
+
+    m_framesNb = 0;
+    m_previousFrame.assign(m_width * m_height, 0x00000000);
+
+    if (!m_directory.mkpath("."))
+    {
+        m_consoleOutput->log("Cannot create the monitor capture directory: " + m_directory.path());
+        m_consoleOutput->returnLine();
+        return false;
+    }
+
+    // Images of a longer previous run would be mixed with the new ones
+    QStringList oldFrames = m_directory.entryList({ "frame_*.raw", "frame_*.png" }, QDir::Files);
+
+    for (int i(0); i < oldFrames.size(); i++)
+    {
+        m_directory.remove(oldFrames[i]);
+    }
+
+    m_directory.remove(STREAM_FILE_NAME);
+
+    m_framesFile.setFileName(m_directory.filePath(FRAMES_FILE_NAME));
+
+    if (!m_framesFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        m_consoleOutput->log("Cannot write the monitor capture file: " + m_framesFile.fileName());
+        m_consoleOutput->returnLine();
+        return false;
+    }
+
+    if (m_format == Emulator::CaptureFormat::STREAM)
+    {
+        m_streamFile.setFileName(m_directory.filePath(STREAM_FILE_NAME));
+
+        if (!m_streamFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            m_consoleOutput->log("Cannot write the monitor capture file: " + m_streamFile.fileName());
+            m_consoleOutput->returnLine();
+            m_framesFile.close();
+            return false;
+        }
+
+        QDataStream stream(&m_streamFile);
+        stream.writeRawData("HBCV", 4);
+        stream << (quint32)m_width << (quint32)m_height;
+    }
+
+    m_started = true;
+
+    m_worker = new CaptureWorker(this);
+    m_worker->start(QThread::LowPriority);
+
+    return true;
+}
+
+unsigned int MonitorCapture::getInterval()
+{
+    return m_interval;
+}
+
+void MonitorCapture::write(const uint32_t *argb, quint64 tick)
+{
+    if (!m_started)
+        return;
+
+    int pixelsNb = m_width * m_height;
+
+    m_frame.tick = tick;
+    m_frame.hash = hash(argb, pixelsNb);
+    m_frame.argb.assign(argb, argb + pixelsNb);
+
+    // A regression test needs every frame, the emulator waits rather than dropping one
+    while (!m_frames.push(m_frame))
+    {
+        QThread::usleep(100);
+    }
+}
+
+quint64 MonitorCapture::hash(const uint32_t *argb, int pixelsNb)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(argb);
+    quint64 result = 0xCBF29CE484222325;
+
+    for (std::size_t i(0); i < pixelsNb * sizeof(uint32_t); i++)
+    {
+        result ^= bytes[i];
+        result *= 0x100000001B3;
+    }
+
+    return result;
+}
+
+// MonitorCapture PRIVATE
+void MonitorCapture::writeFrame(const CapturedFrame &frame)
+{
+    const uint32_t *argb = frame.argb.data();
+    int pixelsNb = m_width * m_height;
+
+    QTextStream(&m_framesFile) << m_framesNb << " " << frame.tick << " " << QString::number(frame.hash, 16).rightJustified(16, '0') << "\n";
+    m_framesFile.flush(); // Kept readable if the IDE is killed by a test timeout
+
+    if (m_format == Emulator::CaptureFormat::RAW)
+    {
+        QFile rawFile(getFramePath("raw"));
+
+        if (rawFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            rawFile.write(reinterpret_cast<const char*>(argb), pixelsNb * sizeof(uint32_t));
+    }
+    else if (m_format == Emulator::CaptureFormat::PNG)
+    {
+        QImage image(reinterpret_cast<const uchar*>(argb), m_width, m_height, m_width * sizeof(uint32_t), QImage::Format_RGB32);
+        image.save(getFramePath("png"), "PNG");
+    }
+    else if (m_format == Emulator::CaptureFormat::STREAM)
+    {
+        // Unchanged pixels become zeros, which compress very well
+        QByteArray difference(pixelsNb * sizeof(uint32_t), Qt::Uninitialized);
+        uint32_t *differencePixels = reinterpret_cast<uint32_t*>(difference.data());
+
+        for (int i(0); i < pixelsNb; i++)
+        {
+            differencePixels[i] = argb[i] ^ m_previousFrame[i];
+        }
+
+        std::copy(argb, argb + pixelsNb, m_previousFrame.begin());
+
+        QDataStream stream(&m_streamFile);
+        stream << (quint64)frame.tick << frame.hash << qCompress(difference);
+        m_streamFile.flush();
+    }
+
+    m_framesNb++;
+}
+
+void MonitorCapture::stop()
+{
+    delete m_worker; // Writes the queued frames before the files are closed
+    m_worker = nullptr;
+
+    m_framesFile.close();
+    m_streamFile.close();
+
+    m_started = false;
+}
+
+QString MonitorCapture::getFramePath(QString extension)
+{
+    return m_directory.filePath(QString("frame_%1.%2").arg(m_framesNb, 6, 10, QChar('0')).arg(extension));
+}
@@ -0,0 +1,148 @@
+#ifndef MONITORCAPTURE_H
+#define MONITORCAPTURE_H
+
+/*!
+ * \file monitorCapture.h
+ * \brief Dumps the frames of HbcMonitor to files, without displaying them
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <vector>
+#include <QFile>
+#include <QDir>
+#include <QThread>
+#include "computerDetails.h"
+#include "console.h"
+#include "spscRing.h"
+
+class MonitorCapture;
+
+/*!
+ * \struct CapturedFrame
+ * \brief Copy of a frame waiting to be written by a CaptureWorker
+ */
+struct CapturedFrame
+{
+    quint64 tick = 0;
+    quint64 hash = 0;
+    std::vector<uint32_t> argb;
+};
+
+/*!
+ * \class CaptureWorker
+ * \brief Encodes and writes the captured frames of a MonitorCapture in its own thread
+ *
+ * It is the consumer of the frame ring of the capture, the emulator thread being the producer.
+ */
+class CaptureWorker : public QThread
+{
+    public:
+        static constexpr int POLL_INTERVAL_MS = 10;
+
+        CaptureWorker(MonitorCapture *capture);
+        ~CaptureWorker(); //!< Stops the thread after writing the remaining frames
+
+    protected:
+        void run() override;
+
+    private:
+        void writeFrames();
+
+        MonitorCapture *m_capture;
+        CapturedFrame m_frame; //!< Popped frame, its buffer is reused
+};
+
+/*!
+ * \class MonitorCapture
+ * \brief Writes frames rendered on the CPU to the <b>capture</b> directory of the project
+ *
+ * Frames are captured every <i>n</i> CPU ticks rather than every <i>n</i> milliseconds, so a run gives the same frames at any frequency target.<br>
+ * This allows screen-based regression tests to run at FASTEST speed on machines without display.
+ *
+ * Every captured frame adds a line <b>"frame tick hash"</b> to FRAMES_FILE_NAME, <i>hash</i> being the FNV-1a 64 bits hash of its ARGB pixels.<br>
+ * Comparing this file with a reference one is enough to check a run, the images being only needed to see the differences.
+ *
+ * The emulator thread only hashes and copies the frames: a CaptureWorker encodes and writes them.
+ * If FRAME_BUFFER_SIZE frames are already waiting, the emulator thread waits for the worker, so no frame is ever lost.
+ *
+ * <table>
+ *  <caption>Capture formats</caption>
+ *  <tr>
+ *   <th>Format</th>
+ *   <th>Files</th>
+ *  </tr>
+ *  <tr>
+ *   <td>RAW</td>
+ *   <td>frame_NNNNNN.raw, WIDTH * HEIGHT ARGB pixels <i>(32 bits, host endianness)</i></td>
+ *  </tr>
+ *  <tr>
+ *   <td>PNG</td>
+ *   <td>frame_NNNNNN.png</td>
+ *  </tr>
+ *  <tr>
+ *   <td>STREAM</td>
+ *   <td>STREAM_FILE_NAME: "HBCV", width and height <i>(quint32)</i>, then for each frame its tick <i>(quint64)</i>, its hash <i>(quint64)</i>
+ *   and its pixels XORed with the previous frame, compressed with qCompress() <i>(QByteArray)</i>. Everything is written by QDataStream.</td>
+ *  </tr>
+ * </table>
+ */
+class MonitorCapture
+{
+    public:
+        static constexpr char DIRECTORY_NAME[] = "capture"; //!< Subdirectory of the project
+        static constexpr char FRAMES_FILE_NAME[] = "frames.txt";
+        static constexpr char STREAM_FILE_NAME[] = "frames.hbcv";
+        static constexpr std::size_t FRAME_BUFFER_SIZE = 8; //!< Frames waiting to be written
+
+        /*!
+         * \param projectDirPath Directory containing the DIRECTORY_NAME subdirectory
+         * \param intervalTicks Number of CPU ticks between two captured frames
+         */
+        MonitorCapture(QString projectDirPath, Emulator::CaptureFormat format, unsigned int intervalTicks, int width, int height, Console *consoleOutput);
+        ~MonitorCapture();
+
+        /*!
+         * \brief Creates the capture directory and truncates the files of the last run
+         * \return <b>false</b> if the files cannot be written, the capture is then disabled
+         */
+        bool start();
+
+        unsigned int getInterval();
+
+        /*!
+         * \brief Queues a frame, the worker writes it in the selected format and adds its hash to FRAMES_FILE_NAME
+         * \param argb width * height pixels, copied
+         * \param tick CPU tick of the capture
+         */
+        void write(const uint32_t *argb, quint64 tick);
+
+        static quint64 hash(const uint32_t *argb, int pixelsNb); //!< FNV-1a 64 bits, on the bytes of the pixels
+
+    private:
+        friend class CaptureWorker;
+
+        void writeFrame(const CapturedFrame &frame); //!< Called by the worker
+        void stop();
+        QString getFramePath(QString extension);
+
+        QDir m_directory;
+        Emulator::CaptureFormat m_format;
+        unsigned int m_interval;
+        int m_width;
+        int m_height;
+        Console *m_consoleOutput;
+
+        bool m_started;
+        unsigned int m_framesNb;
+        QFile m_framesFile;
+        QFile m_streamFile;
+        std::vector<uint32_t> m_previousFrame; //!< Reference of the XOR in STREAM format
+
+        SpscRing<CapturedFrame, FRAME_BUFFER_SIZE> m_frames;
+        CapturedFrame m_frame; //!< Frame being queued, its buffer is reused
+        CaptureWorker *m_worker;
+};
+
+#endif // MONITORCAPTURE_H
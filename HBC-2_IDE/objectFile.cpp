@@ -0,0 +1,215 @@
+#include "objectFile.h"
+
+#include <cstring>
+#include "computerDetails.h"
+
+using namespace Assembly;
+
+// PUBLIC
+void ObjectFile::clear()
+{
+    name.clear();
+    targetEeprom = false;
+    names.clear();
+    filesPaths.clear();
+    sections.clear();
+    imports.clear();
+
+    m_namesIds.clear();
+    m_filesIds.clear();
+}
+
+uint32_t ObjectFile::addName(const std::string &symbolName)
+{
+    auto inserted = m_namesIds.emplace(symbolName, (uint32_t)names.size());
+
+    if (inserted.second) // New name
+        names.push_back(symbolName);
+
+    return inserted.first->second;
+}
+
+uint32_t ObjectFile::addFile(const QString &filePath)
+{
+    auto inserted = m_filesIds.emplace(filePath, (uint32_t)filesPaths.size());
+
+    if (inserted.second) // New file
+        filesPaths.push_back(filePath);
+
+    return inserted.first->second;
+}
+
+void ObjectFile::listImports()
+{
+    std::vector<bool> defined(names.size(), false), imported(names.size(), false);
+
+    imports.clear();
+
+    for (const Section &section : sections)
+        defined[section.name] = true;
+
+    for (const Section &section : sections)
+    {
+        for (const Relocation &relocation : section.relocations)
+        {
+            if (!defined[relocation.symbol] && !imported[relocation.symbol])
+            {
+                imported[relocation.symbol] = true;
+                imports.push_back(relocation.symbol);
+            }
+        }
+    }
+}
+
+void ObjectFile::write(QDataStream &stream) const
+{
+    stream.writeRawData("HBCO", 4);
+    stream << FORMAT_VERSION << name << targetEeprom << (quint32)names.size();
+
+    for (const std::string &symbolName : names)
+        stream << QByteArray::fromStdString(symbolName);
+
+    stream << (quint32)filesPaths.size();
+
+    for (const QString &filePath : filesPaths)
+        stream << filePath;
+
+    stream << (quint32)sections.size();
+
+    for (const Section &section : sections)
+    {
+        stream << (quint8)section.type << (quint32)section.name << section.fixedAddress << (quint32)section.address
+               << (quint32)section.originFileId << (quint32)section.originLineNb << section.content;
+
+        stream << (quint32)section.relocations.size();
+
+        for (const Relocation &relocation : section.relocations)
+            stream << (quint32)relocation.offset << (quint8)relocation.type << (quint32)relocation.symbol;
+
+        stream << (quint32)section.lines.size();
+
+        for (const SectionLine &line : section.lines)
+            stream << (quint32)line.offset << (quint32)line.fileId << (quint32)line.lineNb;
+    }
+
+    stream << (quint32)imports.size();
+
+    for (uint32_t import : imports)
+        stream << (quint32)import;
+}
+
+bool ObjectFile::read(QDataStream &stream)
+{
+    char magic[4];
+    quint32 version, namesNb, filesNb, sectionsNb, importsNb;
+
+    clear();
+
+    if (stream.readRawData(magic, 4) != 4 || memcmp(magic, "HBCO", 4) != 0)
+        return false;
+
+    stream >> version;
+
+    if (version != FORMAT_VERSION)
+        return false;
+
+    stream >> name >> targetEeprom >> namesNb;
+
+    for (quint32 n(0); n < namesNb && stream.status() == QDataStream::Ok; n++)
+    {
+        QByteArray symbolName;
+
+        stream >> symbolName;
+        addName(symbolName.toStdString());
+    }
+
+    stream >> filesNb;
+
+    for (quint32 f(0); f < filesNb && stream.status() == QDataStream::Ok; f++)
+    {
+        QString filePath;
+
+        stream >> filePath;
+        addFile(filePath);
+    }
+
+    // Indexes, fixed addresses and line offsets are checked here, so the Linker can trust them
+    bool valid(names.size() == namesNb && filesPaths.size() == filesNb);
+    quint32 memorySize(targetEeprom ? Eeprom::MEMORY_SIZE : Ram::MEMORY_SIZE);
+
+    stream >> sectionsNb;
+
+    for (quint32 s(0); s < sectionsNb && valid && stream.status() == QDataStream::Ok; s++)
+    {
+        Section section;
+        quint8 type;
+        quint32 sectionName, address, originFileId, originLineNb, relocationsNb, linesNb;
+
+        stream >> type >> sectionName >> section.fixedAddress >> address >> originFileId >> originLineNb >> section.content;
+
+        section.type = (SectionType)type;
+        section.name = sectionName;
+        section.address = address;
+        section.originFileId = originFileId;
+        section.originLineNb = originLineNb;
+
+        valid = (type <= (quint8)SectionType::DATA && sectionName < names.size() && originFileId < filesPaths.size()
+                 && (section.type == SectionType::DATA || section.content.size() % Cpu::INSTRUCTION_SIZE == 0)
+                 && (!section.fixedAddress || (address < memorySize && (quint32)section.content.size() <= memorySize - address))); // Without overflow
+
+        stream >> relocationsNb;
+
+        for (quint32 r(0); r < relocationsNb && valid && stream.status() == QDataStream::Ok; r++)
+        {
+            quint32 offset, symbol;
+            quint8 relocationType;
+
+            stream >> offset >> relocationType >> symbol;
+
+            valid = (section.type == SectionType::ROUTINE && relocationType <= (quint8)RelocationType::ADDRESS_LSB
+                     && symbol < names.size() && offset % Cpu::INSTRUCTION_SIZE == 0 && offset < (quint32)section.content.size());
+
+            section.relocations.push_back({ offset, (RelocationType)relocationType, symbol });
+        }
+
+        if (!valid)
+            break;
+
+        stream >> linesNb;
+
+        for (quint32 l(0); l < linesNb && valid && stream.status() == QDataStream::Ok; l++)
+        {
+            quint32 offset, fileId, lineNb;
+
+            stream >> offset >> fileId >> lineNb;
+
+            // Sorted by offset, the Linker searches them by dichotomy
+            valid = (fileId < filesPaths.size() && offset < (quint32)section.content.size() && (section.lines.empty() || offset >= section.lines.back().offset));
+
+            section.lines.push_back({ offset, fileId, lineNb });
+        }
+
+        sections.push_back(std::move(section));
+    }
+
+    stream >> importsNb;
+
+    for (quint32 i(0); i < importsNb && valid && stream.status() == QDataStream::Ok; i++)
+    {
+        quint32 import;
+
+        stream >> import;
+
+        valid = (import < names.size());
+
+        imports.push_back(import);
+    }
+
+    if (!valid || stream.status() != QDataStream::Ok)
+    {
+        clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,117 @@
+#ifndef OBJECTFILE_H
+#define OBJECTFILE_H
+
+/*!
+ * \file objectFile.h
+ * \brief Relocatable object produced by the Assembler from a project, placed and linked into an image by the Linker
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+namespace Assembly
+{
+    /*!
+     * \enum SectionType
+     * \brief A routine block or a variable
+     */
+    enum class SectionType : uint8_t { ROUTINE, DATA };
+
+    /*!
+     * \enum RelocationType
+     * \brief Field of the instruction receiving the address of a symbol
+     */
+    enum class RelocationType : uint8_t {
+        ADDRESS,     //!< Variable or label, in the 16 bits of Cpu::VX_MASK
+        ADDRESS_MSB, //!< label.msb, in the 8 bits of Cpu::V1_MASK
+        ADDRESS_LSB  //!< label.lsb, in the 8 bits of Cpu::V1_MASK
+    };
+
+    /*!
+     * \struct Relocation
+     * \brief Instruction of a routine section using the address of a symbol
+     */
+    struct Relocation
+    {
+        uint32_t offset; //!< First byte of the instruction in the section
+        RelocationType type;
+        uint32_t symbol; //!< Index in ObjectFile::names
+    };
+
+    /*!
+     * \struct SectionLine
+     * \brief Row of the line table of a section: source of the instruction starting at <i>offset</i>
+     */
+    struct SectionLine
+    {
+        uint32_t offset;
+        uint32_t fileId; //!< Index in ObjectFile::filesPaths
+        uint32_t lineNb;
+    };
+
+    /*!
+     * \struct Section
+     * \brief Content of a routine block or of a variable, with the relocations left to the Linker
+     *
+     * Variables only hold values and strings, so only routine sections have relocations and lines.
+     */
+    struct Section
+    {
+        SectionType type;
+        uint32_t name; //!< Index in ObjectFile::names, exported to the other objects
+        bool fixedAddress; //!< <b>false</b> if the Linker places the section
+        uint32_t address; //!< Only used if fixedAddress is set
+        QByteArray content; //!< Instructions are encoded with 0 in their relocated field
+        std::vector<Relocation> relocations; //!< By offset
+        std::vector<SectionLine> lines; //!< By offset, one per instruction
+
+        uint32_t originFileId; //!< Index in ObjectFile::filesPaths
+        unsigned int originLineNb;
+    };
+
+    /*!
+     * \struct ObjectFile
+     * \brief Sections of a project with their symbols and their line table
+     *
+     * Routine blocks come first in the order of the final file, then the variables with an address, then the others.<br>
+     * Every section exports its name. The names used by relocations and defined by no section are the imports,
+     * they must be exported by another object of the link.<br>
+     * Like in a single project, a variable and a routine may have the same name: the variable is used.
+     *
+     * Serialized by write() as "HBCO", the format version, the target, the names, the files paths, the sections,
+     * then the imports <i>(QDataStream, big endian)</i>.
+     */
+    struct ObjectFile
+    {
+        QString name; //!< Project the object was assembled from
+        bool targetEeprom = false; //!< Fixed addresses were checked for that memory
+        std::vector<std::string> names; //!< Names of the sections and of the relocated symbols, stored once
+        std::vector<QString> filesPaths;
+        std::vector<Section> sections;
+        std::vector<uint32_t> imports; //!< Indexes in names, set by listImports()
+
+        void clear();
+        uint32_t addName(const std::string &symbolName); //!< Returns the index of the name, added if new
+        uint32_t addFile(const QString &filePath); //!< Returns the index of the file path, added if new
+        void listImports(); //!< Call once all sections are added
+
+        void write(QDataStream &stream) const;
+        bool read(QDataStream &stream); //!< Returns <b>false</b> if the data is not a valid object of this version
+
+        static constexpr quint32 FORMAT_VERSION = 1;
+
+    private:
+        std::unordered_map<std::string, uint32_t> m_namesIds; //!< Only used to add names
+        std::map<QString, uint32_t> m_filesIds; //!< Only used to add files
+    };
+}
+
+#endif // OBJECTFILE_H
@@ -0,0 +1,92 @@
+#ifndef PERIPHERALPACK_H
+#define PERIPHERALPACK_H
+
+/*!
+ * \file peripheralPack.h
+ * \brief Compile-time configured set of peripherals
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <tuple>
+#include <type_traits>
+#include "peripheral.h"
+
+/*!
+ * \class PeripheralPack
+ * \brief Stores one peripheral of each given type and dispatches calls to them without virtual calls
+ *
+ * Peripheral types must be derived from HbcPeripheral and declared <b>final</b>, so calls made through their exact
+ * type are resolved at compile time (and can be inlined) instead of going through the HbcPeripheral vtable.
+ *
+ * Each peripheral can be unplugged (<b>nullptr</b>). Peripherals are initialized and ticked in the order of the template
+ * arguments, which defines the HbcIod ports they are plugged into.
+ *
+ * Peripherals only known at runtime (see HbcPluginPeripheral) are not stored here.
+ */
+template<typename... Peripherals>
+class PeripheralPack
+{
+    static_assert((std::is_base_of_v<HbcPeripheral, Peripherals> && ...), "Peripherals must be derived from HbcPeripheral");
+    static_assert((std::is_final_v<Peripherals> && ...), "Peripherals must be final to be statically dispatched");
+
+    public:
+        /*!
+         * \return a reference to the pointer of the peripheral of the given type <i>(<b>nullptr</b> if unplugged)</i>
+         */
+        template<typename Peripheral>
+        Peripheral*& get()
+        {
+            return std::get<Peripheral*>(m_peripherals);
+        }
+
+        template<typename Peripheral>
+        Peripheral* get() const
+        {
+            return std::get<Peripheral*>(m_peripherals);
+        }
+
+        /*!
+         * \brief Deletes the plugged peripherals and unplugs them
+         */
+        void clear()
+        {
+            (deletePeripheral(std::get<Peripherals*>(m_peripherals)), ...);
+        }
+
+        void init()
+        {
+            (initPeripheral(std::get<Peripherals*>(m_peripherals)), ...);
+        }
+
+        void tick(bool step)
+        {
+            (tickPeripheral(std::get<Peripherals*>(m_peripherals), step), ...);
+        }
+
+    private:
+        template<typename Peripheral>
+        static void deletePeripheral(Peripheral *&peripheral)
+        {
+            delete peripheral;
+            peripheral = nullptr;
+        }
+
+        template<typename Peripheral>
+        static void initPeripheral(Peripheral *peripheral)
+        {
+            if (peripheral != nullptr)
+                peripheral->init();
+        }
+
+        template<typename Peripheral>
+        static void tickPeripheral(Peripheral *peripheral, bool step)
+        {
+            if (peripheral != nullptr)
+                peripheral->tick(step);
+        }
+
+        std::tuple<Peripherals*...> m_peripherals{};
+};
+
+#endif // PERIPHERALPACK_H
@@ -0,0 +1,96 @@
+#ifndef PLUGINAPI_H
+#define PLUGINAPI_H
+
+/*!
+ * \file pluginApi.h
+ * \brief C interface implemented by out-of-tree HBC-2 peripherals (shared libraries)
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ *
+ * This header only depends on the C standard library so it can be copied as is into a plugin project.
+ *
+ * A plugin exports a single symbol, <b>hbcPluginDescriptor</b>, returning a static HbcPluginDescriptor.<br>
+ * The emulator never ticks a plugin on every instruction: a plugin only runs when HbcCpu writes to one of
+ * its ports (<i>onPortWrite</i>) or when a deadline it scheduled is reached (<i>onDeadline</i>).
+ *
+ * Port indexes given to or received from the host are <b>relative</b> to the plugin
+ * (0 to <i>portsNb - 1</i>), the actual HbcIod ports are assigned by Iod::requestPortsConnexions().
+ */
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HBC_PLUGIN_ABI_VERSION 1 /*!< Incremented on any incompatible change of the structures below */
+
+#if defined(_WIN32)
+#define HBC_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define HBC_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define HBC_PLUGIN_DESCRIPTOR_SYMBOL "hbcPluginDescriptor" /*!< Name of the symbol resolved by the emulator */
+
+/*!
+ * \brief Services provided by the emulator to a plugin instance
+ *
+ * Every function takes back <i>hostContext</i> as first argument.<br>
+ * Functions are only valid during a call made by the emulator (create, init, onPortWrite, onDeadline).
+ */
+typedef struct HbcPluginHost
+{
+    uint32_t abiVersion; /*!< HBC_PLUGIN_ABI_VERSION of the emulator */
+    void *hostContext;
+
+    uint8_t (*readPort)(void *hostContext, uint8_t portIndex);
+    void (*writePort)(void *hostContext, uint8_t portIndex, uint8_t data); /*!< Does not raise onPortWrite */
+
+    /*! Copies <i>count</i> consecutive ports starting at <i>firstPortIndex</i> (out of range ports are ignored) */
+    void (*readPorts)(void *hostContext, uint8_t firstPortIndex, uint8_t *buffer, uint8_t count);
+    void (*writePorts)(void *hostContext, uint8_t firstPortIndex, const uint8_t *buffer, uint8_t count);
+
+    /*! Interrupt data is the content of the given port (see Iod::triggerInterrupt()) */
+    void (*triggerInterrupt)(void *hostContext, uint8_t portIndex);
+
+    /*! Bulk RAM access, HbcRam is locked once per call and the copy stops at the end of the address space */
+    uint32_t (*readRam)(void *hostContext, uint16_t address, uint8_t *buffer, uint32_t size);
+    uint32_t (*writeRam)(void *hostContext, uint16_t address, const uint8_t *buffer, uint32_t size);
+
+    uint64_t (*currentTick)(void *hostContext); /*!< Number of clock cycles executed since the computer was initialized */
+
+    /*! Requests an onDeadline call <i>ticks</i> clock cycles from now (replaces the previous deadline, 0 cancels it) */
+    void (*scheduleDeadline)(void *hostContext, uint64_t ticks);
+
+    void (*log)(void *hostContext, const char *message); /*!< Prints a line in the IDE console */
+} HbcPluginHost;
+
+/*!
+ * \brief Describes a plugin peripheral and its entry points
+ *
+ * <i>onPortWrite</i> and <i>onDeadline</i> can be NULL if unused.
+ */
+typedef struct HbcPluginDescriptor
+{
+    uint32_t abiVersion; /*!< Must be HBC_PLUGIN_ABI_VERSION */
+    const char *name;
+
+    uint8_t deviceId; /*!< Sent to HbcCpu when plugged (must not be 0x00) */
+    uint8_t portsNb; /*!< Number of HbcIod ports requested */
+
+    void *(*create)(const HbcPluginHost *host); /*!< Returns the plugin instance (NULL on failure) */
+    void (*destroy)(void *instance);
+
+    void (*init)(void *instance); /*!< Called when the computer is (re)initialized, after the ports were assigned */
+    void (*onPortWrite)(void *instance, uint8_t portIndex, uint8_t data);
+    void (*onDeadline)(void *instance, uint64_t tick);
+} HbcPluginDescriptor;
+
+typedef const HbcPluginDescriptor *(*HbcPluginDescriptorFunction)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLUGINAPI_H
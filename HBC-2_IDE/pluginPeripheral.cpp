@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstring>
+#include "pluginPeripheral.h"
+
+using namespace Plugin;
+
+// PUBLIC
+HbcPluginPeripheral::HbcPluginPeripheral(QString libraryPath, const quint64 *tickCounter, HbcRam *ram, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+{
+    m_descriptor = nullptr;
+    m_instance = nullptr;
+
+    m_tickCounter = tickCounter;
+    m_deadline = NO_DEADLINE;
+
+    m_ram = ram;
+
+    m_host.abiVersion = HBC_PLUGIN_ABI_VERSION;
+    m_host.hostContext = this;
+    m_host.readPort = &HbcPluginPeripheral::hostReadPort;
+    m_host.writePort = &HbcPluginPeripheral::hostWritePort;
+    m_host.readPorts = &HbcPluginPeripheral::hostReadPorts;
+    m_host.writePorts = &HbcPluginPeripheral::hostWritePorts;
+    m_host.triggerInterrupt = &HbcPluginPeripheral::hostTriggerInterrupt;
+    m_host.readRam = &HbcPluginPeripheral::hostReadRam;
+    m_host.writeRam = &HbcPluginPeripheral::hostWriteRam;
+    m_host.currentTick = &HbcPluginPeripheral::hostCurrentTick;
+    m_host.scheduleDeadline = &HbcPluginPeripheral::hostScheduleDeadline;
+    m_host.log = &HbcPluginPeripheral::hostLog;
+
+    if (!load(libraryPath))
+    {
+        m_descriptor = nullptr;
+        m_library.unload();
+    }
+}
+
+HbcPluginPeripheral::~HbcPluginPeripheral()
+{
+    if (m_instance != nullptr)
+        m_descriptor->destroy(m_instance);
+
+    m_library.unload();
+}
+
+bool HbcPluginPeripheral::isLoaded() const
+{
+    return m_instance != nullptr;
+}
+
+QString HbcPluginPeripheral::getName() const
+{
+    if (m_descriptor == nullptr || m_descriptor->name == nullptr)
+        return m_library.fileName();
+
+    return QString::fromUtf8(m_descriptor->name);
+}
+
+void HbcPluginPeripheral::init()
+{
+    if (!isLoaded())
+        return;
+
+    m_deadline = NO_DEADLINE;
+    m_sockets = Iod::requestPortsConnexions(*m_iod, m_descriptor->deviceId, m_descriptor->portsNb);
+
+    if (m_sockets.size() < m_descriptor->portsNb)
+    {
+        m_consoleOutput->log("Cannot plug the " + getName() + " plugin, not enough available ports");
+        return;
+    }
+
+    for (unsigned int i(0); i < m_sockets.size(); i++)
+    {
+        Iod::watchPort(*m_iod, m_sockets[i].portId, true);
+    }
+
+    if (m_descriptor->init != nullptr)
+        m_descriptor->init(m_instance);
+}
+
+void HbcPluginPeripheral::tick(bool step)
+{ }
+
+bool HbcPluginPeripheral::ownsPort(Byte portId) const
+{
+    // HbcIod always assigns consecutive ports
+    return !m_sockets.empty() && portId >= m_sockets[0].portId && (unsigned int)(portId - m_sockets[0].portId) < m_sockets.size();
+}
+
+void HbcPluginPeripheral::portWritten(Byte portId)
+{
+    if (m_descriptor->onPortWrite != nullptr)
+    {
+        Byte portIndex = portId - m_sockets[0].portId;
+        m_descriptor->onPortWrite(m_instance, portIndex, *m_sockets[portIndex].portDataPointer);
+    }
+}
+
+quint64 HbcPluginPeripheral::getDeadline() const
+{
+    return m_deadline;
+}
+
+void HbcPluginPeripheral::deadlineReached()
+{
+    m_deadline = NO_DEADLINE;
+
+    if (m_descriptor->onDeadline != nullptr)
+        m_descriptor->onDeadline(m_instance, *m_tickCounter);
+}
+
+// PRIVATE
+bool HbcPluginPeripheral::load(QString libraryPath)
+{
+    m_library.setFileName(libraryPath);
+
+    if (!m_library.load())
+    {
+        m_consoleOutput->log("Unable to load the plugin " + libraryPath + " (" + m_library.errorString() + ")");
+        return false;
+    }
+
+    HbcPluginDescriptorFunction descriptorFunction = reinterpret_cast<HbcPluginDescriptorFunction>(m_library.resolve(HBC_PLUGIN_DESCRIPTOR_SYMBOL));
+    if (descriptorFunction == nullptr)
+    {
+        m_consoleOutput->log("Invalid plugin " + libraryPath + " (missing " + HBC_PLUGIN_DESCRIPTOR_SYMBOL + ")");
+        return false;
+    }
+
+    m_descriptor = descriptorFunction();
+    if (m_descriptor == nullptr || m_descriptor->abiVersion != HBC_PLUGIN_ABI_VERSION)
+    {
+        m_consoleOutput->log("Invalid plugin " + libraryPath + " (ABI version " + QString::number(HBC_PLUGIN_ABI_VERSION) + " expected)");
+        return false;
+    }
+
+    if (m_descriptor->deviceId == 0x00 || m_descriptor->portsNb == 0 || m_descriptor->create == nullptr || m_descriptor->destroy == nullptr)
+    {
+        m_consoleOutput->log("Invalid plugin " + libraryPath + " (incomplete descriptor)");
+        return false;
+    }
+
+    m_instance = m_descriptor->create(&m_host);
+    if (m_instance == nullptr)
+    {
+        m_consoleOutput->log("The plugin " + getName() + " failed to initialize");
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t HbcPluginPeripheral::hostReadPort(void *hostContext, uint8_t portIndex)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    if (portIndex >= plugin->m_sockets.size())
+        return 0x00;
+
+    return *plugin->m_sockets[portIndex].portDataPointer;
+}
+
+void HbcPluginPeripheral::hostWritePort(void *hostContext, uint8_t portIndex, uint8_t data)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    if (portIndex < plugin->m_sockets.size())
+        *plugin->m_sockets[portIndex].portDataPointer = data;
+}
+
+void HbcPluginPeripheral::hostReadPorts(void *hostContext, uint8_t firstPortIndex, uint8_t *buffer, uint8_t count)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    for (unsigned int i(0); i < count && firstPortIndex + i < plugin->m_sockets.size(); i++)
+    {
+        buffer[i] = *plugin->m_sockets[firstPortIndex + i].portDataPointer;
+    }
+}
+
+void HbcPluginPeripheral::hostWritePorts(void *hostContext, uint8_t firstPortIndex, const uint8_t *buffer, uint8_t count)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    for (unsigned int i(0); i < count && firstPortIndex + i < plugin->m_sockets.size(); i++)
+    {
+        *plugin->m_sockets[firstPortIndex + i].portDataPointer = buffer[i];
+    }
+}
+
+void HbcPluginPeripheral::hostTriggerInterrupt(void *hostContext, uint8_t portIndex)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    if (portIndex < plugin->m_sockets.size())
+        Iod::triggerInterrupt(*plugin->m_iod, plugin->m_sockets[portIndex].portId);
+}
+
+uint32_t HbcPluginPeripheral::hostReadRam(void *hostContext, uint16_t address, uint8_t *buffer, uint32_t size)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+    uint32_t copySize = std::min<uint32_t>(size, Ram::MEMORY_SIZE - address);
+
+    plugin->m_ram->mutex.lock();
+    std::memcpy(buffer, plugin->m_ram->memory + address, copySize);
+    plugin->m_ram->mutex.unlock();
+
+    return copySize;
+}
+
+uint32_t HbcPluginPeripheral::hostWriteRam(void *hostContext, uint16_t address, const uint8_t *buffer, uint32_t size)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+    uint32_t copySize = std::min<uint32_t>(size, Ram::MEMORY_SIZE - address);
+
+    plugin->m_ram->mutex.lock();
+    std::memcpy(plugin->m_ram->memory + address, buffer, copySize);
+    plugin->m_ram->mutex.unlock();
+
+    return copySize;
+}
+
+uint64_t HbcPluginPeripheral::hostCurrentTick(void *hostContext)
+{
+    return *static_cast<HbcPluginPeripheral*>(hostContext)->m_tickCounter;
+}
+
+void HbcPluginPeripheral::hostScheduleDeadline(void *hostContext, uint64_t ticks)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    plugin->m_deadline = (ticks == 0) ? NO_DEADLINE : *plugin->m_tickCounter + ticks;
+}
+
+void HbcPluginPeripheral::hostLog(void *hostContext, const char *message)
+{
+    HbcPluginPeripheral *plugin = static_cast<HbcPluginPeripheral*>(hostContext);
+
+    plugin->m_consoleOutput->log("[" + plugin->getName() + "] " + QString::fromUtf8(message));
+}
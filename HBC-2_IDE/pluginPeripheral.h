@@ -0,0 +1,106 @@
+#ifndef PLUGINPERIPHERAL_H
+#define PLUGINPERIPHERAL_H
+
+/*!
+ * \file pluginPeripheral.h
+ * \brief Peripheral loaded from a shared library, derived from HbcPeripheral
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <QLibrary>
+#include "peripheral.h"
+#include "ram.h"
+#include "pluginApi.h"
+
+/*!
+ * \namespace Plugin
+ * \brief See HbcPluginPeripheral for detailed specifications.
+ */
+namespace Plugin
+{
+    const QString DIRECTORY_NAME = "plugins"; //!< Subdirectory of a project scanned for plugins
+
+    constexpr quint64 NO_DEADLINE = UINT64_MAX;
+
+    /*!
+     * \class HbcPluginPeripheral
+     * \brief Derived from HbcPeripheral, wraps a peripheral implemented in a shared library (see pluginApi.h)
+     *
+     * The library must export <b>hbcPluginDescriptor</b> with a matching HBC_PLUGIN_ABI_VERSION, otherwise it is not loaded.
+     *
+     * Unlike built-in peripherals, a plugin is <b>not ticked</b> on every clock cycle.<br>
+     * Its ports are watched by HbcIod (Iod::watchPort()) and HbcEmulator only calls it:
+     * 1. when HbcCpu writes one of its ports (portWritten()),
+     * 2. when the deadline it scheduled is reached (deadlineReached()).
+     */
+    class HbcPluginPeripheral : public HbcPeripheral
+    {
+        public:
+            /*!
+             * \param libraryPath Path to the shared library
+             * \param tickCounter Clock cycles counter of HbcEmulator, used for deadlines
+             * \param ram Pointer to HbcRam for bulk accesses
+             */
+            HbcPluginPeripheral(QString libraryPath, const quint64 *tickCounter, HbcRam *ram, HbcIod *iod, Console *consoleOutput);
+            ~HbcPluginPeripheral();
+
+            /*!
+             * \return <b>false</b> if the library could not be loaded or rejected the instance creation
+             */
+            bool isLoaded() const;
+
+            QString getName() const;
+
+            void init() override;
+            void tick(bool step) override; //!< No operation, see class description
+
+            /*!
+             * \return <b>true</b> if the given HbcIod port was assigned to this plugin
+             */
+            bool ownsPort(Byte portId) const;
+
+            /*!
+             * \brief Forwards a write made by HbcCpu on one of the plugin ports
+             * \param portId HbcIod port ID (converted to a relative port index for the plugin)
+             */
+            void portWritten(Byte portId);
+
+            /*!
+             * \return the absolute tick of the next deadline <i>(Plugin::NO_DEADLINE if none)</i>
+             */
+            quint64 getDeadline() const;
+
+            /*!
+             * \brief Clears the current deadline and calls the plugin (which may schedule a new one)
+             */
+            void deadlineReached();
+
+        private:
+            bool load(QString libraryPath);
+
+            // Callbacks given to the plugin through HbcPluginHost
+            static uint8_t hostReadPort(void *hostContext, uint8_t portIndex);
+            static void hostWritePort(void *hostContext, uint8_t portIndex, uint8_t data);
+            static void hostReadPorts(void *hostContext, uint8_t firstPortIndex, uint8_t *buffer, uint8_t count);
+            static void hostWritePorts(void *hostContext, uint8_t firstPortIndex, const uint8_t *buffer, uint8_t count);
+            static void hostTriggerInterrupt(void *hostContext, uint8_t portIndex);
+            static uint32_t hostReadRam(void *hostContext, uint16_t address, uint8_t *buffer, uint32_t size);
+            static uint32_t hostWriteRam(void *hostContext, uint16_t address, const uint8_t *buffer, uint32_t size);
+            static uint64_t hostCurrentTick(void *hostContext);
+            static void hostScheduleDeadline(void *hostContext, uint64_t ticks);
+            static void hostLog(void *hostContext, const char *message);
+
+            QLibrary m_library;
+            const HbcPluginDescriptor *m_descriptor;
+            HbcPluginHost m_host;
+            void *m_instance;
+
+            const quint64 *m_tickCounter;
+            quint64 m_deadline;
+
+            HbcRam *m_ram;
+    };
+}
+
+#endif // PLUGINPERIPHERAL_H
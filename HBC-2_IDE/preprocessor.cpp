@@ -0,0 +1,855 @@
+#include "preprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+#include "assembler.h"
+
+using namespace Assembly;
+
+// PUBLIC
+Preprocessor::Preprocessor(const SymbolTable &symbols, const std::vector<Define> &defines, const std::vector<Macro> &macros, const std::string &localLabelsTag)
+    : m_symbols(symbols), m_defines(defines), m_macros(macros), m_localLabelsTag(localLabelsTag)
+{
+
+}
+
+bool Preprocessor::listMacros(Token::TokenFile &f, std::vector<Macro> &fileMacros, std::vector<unsigned int> &sites, Error &error)
+{
+    std::vector<std::pair<const Token::TokenLine*, bool>> fileBlocks, macroBlocks; // Opening lines of the conditional blocks, and if ".else" was found
+    const Token::TokenLine *macroLine(nullptr); // Set while in a macro definition
+
+    for (unsigned int i(0); i < f.m_lines.size(); i++)
+    {
+        Token::TokenLine &line = f.m_lines[i];
+        Token::TokenItem &first = line.m_tokens[0];
+        std::vector<std::pair<const Token::TokenLine*, bool>> &blocks = (macroLine != nullptr) ? macroBlocks : fileBlocks;
+
+        if (first.getType() == Token::TokenType::DIRECTIVE)
+        {
+            switch (first.getDirective())
+            {
+                case Token::Directive::MACRO:
+                {
+                    if (macroLine != nullptr || !fileBlocks.empty())
+                        return lineError(line, Token::ErrorType::MACRO_NESTED, "", error);
+
+                    if (line.m_tokens.size() < 2 || line.m_tokens[1].getType() != Token::TokenType::VAR)
+                        return lineError(line, Token::ErrorType::MACRO_INVAL, "", error);
+
+                    Macro macro;
+
+                    macro.name = line.m_tokens[1].getVariableName();
+                    macro.fileWhereDefined = line.m_originFilePath;
+                    macro.lineNbWhereDefined = line.m_originLineNb;
+
+                    for (unsigned int t(2); t < line.m_tokens.size(); t++)
+                    {
+                        std::string parameter = line.m_tokens[t].getVariableName();
+
+                        if (line.m_tokens[t].getType() != Token::TokenType::VAR
+                         || std::find(macro.parameters.begin(), macro.parameters.end(), parameter) != macro.parameters.end())
+                            return lineError(line, Token::ErrorType::MACRO_INVAL, "", error);
+
+                        macro.parameters.push_back(parameter);
+                    }
+
+                    fileMacros.push_back(macro);
+                    macroLine = &line;
+                    sites.push_back(i);
+                    continue;
+                }
+
+                case Token::Directive::END_MACRO:
+                    if (macroLine == nullptr || line.m_tokens.size() != 1)
+                        return lineError(line, Token::ErrorType::MACRO_INVAL, "", error);
+
+                    if (!macroBlocks.empty())
+                        return lineError(*macroBlocks.back().first, Token::ErrorType::COND_UNBALANCED, "", error);
+
+                    macroLine = nullptr;
+                    sites.push_back(i);
+                    continue;
+
+                case Token::Directive::IF:
+                case Token::Directive::IFDEF:
+                case Token::Directive::IFNDEF:
+                    if (line.m_tokens.size() != 2 || (first.getDirective() != Token::Directive::IF && line.m_tokens[1].getType() != Token::TokenType::VAR))
+                        return lineError(line, Token::ErrorType::COND_ARG_INVAL, "", error);
+
+                    blocks.push_back({ &line, false });
+                    break;
+
+                case Token::Directive::ELSE:
+                case Token::Directive::END_IF:
+                    if (line.m_tokens.size() != 1)
+                        return lineError(line, Token::ErrorType::COND_ARG_INVAL, "", error);
+
+                    if (blocks.empty() || (first.getDirective() == Token::Directive::ELSE && blocks.back().second))
+                        return lineError(line, Token::ErrorType::COND_UNBALANCED, "", error);
+
+                    if (first.getDirective() == Token::Directive::ELSE)
+                        blocks.back().second = true;
+                    else
+                        blocks.pop_back();
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (macroLine == nullptr)
+                sites.push_back(i);
+        }
+        else if (macroLine == nullptr)
+        {
+            // Any line starting with a name may use a macro, macros are only known once all files are listed
+            bool site(first.getType() == Token::TokenType::VAR);
+
+            for (unsigned int t(1); t < line.m_tokens.size() && !site; t++)
+                site = line.m_tokens[t].getType() == Token::TokenType::EXPRESSION;
+
+            if (site)
+                sites.push_back(i);
+        }
+
+        if (macroLine != nullptr)
+            fileMacros.back().body.push_back(line);
+    }
+
+    if (macroLine != nullptr)
+        return lineError(*macroLine, Token::ErrorType::MACRO_END_MISSING, "", error);
+
+    if (!fileBlocks.empty())
+        return lineError(*fileBlocks.back().first, Token::ErrorType::COND_UNBALANCED, "", error);
+
+    return true;
+}
+
+bool Preprocessor::processFile(Token::TokenFile &f, const std::vector<unsigned int> &sites, Error &error)
+{
+    Expansion result;
+
+    result.lines.reserve(f.m_lines.size());
+
+    if (!processLines(f.m_lines, &sites, nullptr, 0, result, error))
+        return false;
+
+    f.m_lines = std::move(result.lines);
+
+    return true;
+}
+
+
+// PRIVATE
+bool Preprocessor::processLines(std::vector<Token::TokenLine> &lines, const std::vector<unsigned int> *sites, const Invocation *invocation,
+                                unsigned int depth, Expansion &result, Error &error)
+{
+    std::vector<Conditional> conditionals;
+    bool active(true); // All conditions of the blocks the line is in are true
+    bool inDefinition(false);
+    unsigned int nextSite(0);
+
+    for (unsigned int i(0); i < lines.size(); i++)
+    {
+        // The lines until the next site are moved as they are
+        if (sites != nullptr && (nextSite == sites->size() || (*sites)[nextSite] != i))
+        {
+            unsigned int end = (nextSite == sites->size()) ? (unsigned int)lines.size() : (*sites)[nextSite];
+
+            if (active && !inDefinition)
+                std::move(lines.begin() + i, lines.begin() + end, std::back_inserter(result.lines));
+
+            i = end - 1;
+            continue;
+        }
+
+        nextSite++;
+
+        Token::TokenLine &line = lines[i];
+        Expansion lineSites; // Tokens of the line to rename at each use of the macro, the line index is not set
+
+        if (line.m_tokens[0].getType() == Token::TokenType::DIRECTIVE)
+        {
+            switch (line.m_tokens[0].getDirective())
+            {
+                case Token::Directive::MACRO:
+                    inDefinition = true;
+                    break;
+
+                case Token::Directive::END_MACRO:
+                    inDefinition = false;
+                    break;
+
+                case Token::Directive::IF:
+                case Token::Directive::IFDEF:
+                case Token::Directive::IFNDEF:
+                {
+                    Conditional conditional = { active, false, false };
+
+                    // Conditions of blocks already removed are not evaluated
+                    if (active)
+                    {
+                        if (invocation != nullptr && !substitute(line, *invocation, lineSites, error))
+                            return false;
+
+                        if (!evaluateCondition(line, conditional.condition, error))
+                            return false;
+                    }
+
+                    conditionals.push_back(conditional);
+                    active = active && conditional.condition;
+                    break;
+                }
+
+                case Token::Directive::ELSE:
+                    if (!conditionals.empty()) // Balance checked by listMacros()
+                    {
+                        conditionals.back().elseFound = true;
+                        active = conditionals.back().parentActive && !conditionals.back().condition;
+                    }
+                    break;
+
+                case Token::Directive::END_IF:
+                    if (!conditionals.empty())
+                    {
+                        active = conditionals.back().parentActive;
+                        conditionals.pop_back();
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            continue;
+        }
+
+        if (!active || inDefinition)
+            continue;
+
+        if (invocation != nullptr && !substitute(line, *invocation, lineSites, error))
+            return false;
+
+        if (line.m_tokens[0].getType() == Token::TokenType::VAR)
+        {
+            int macroIndex = m_symbols.getBinding(m_symbols.find(line.m_tokens[0].getVariableName()), SymbolKind::MACRO);
+
+            if (macroIndex != NO_BINDING)
+            {
+                if (!expand(line, macroIndex, lineSites, invocation, depth, result, error))
+                    return false;
+
+                continue;
+            }
+        }
+
+        if (!computeExpressions(line, error))
+            return false;
+
+        uint32_t lineIndex = (uint32_t)result.lines.size();
+
+        for (const Site &site : lineSites.localLabels)
+            result.localLabels.push_back({ lineIndex, site.token });
+
+        for (const ParameterSite &parameterSite : lineSites.parameters)
+            result.parameters.push_back({ { lineIndex, parameterSite.site.token }, parameterSite.parameter });
+
+        result.lines.push_back(std::move(line));
+    }
+
+    return true;
+}
+
+bool Preprocessor::expand(Token::TokenLine &line, int macroIndex, const Expansion &lineSites, const Invocation *invocation,
+                          unsigned int depth, Expansion &result, Error &error)
+{
+    const Macro &macro = m_macros[macroIndex];
+    std::string key(std::to_string(macroIndex));
+
+    if (line.m_tokens.size() - 1 != macro.parameters.size())
+        return lineError(line, Token::ErrorType::MACRO_ARG_NB, "\"" + macro.name + "\"", error);
+
+    if (depth >= MAX_EXPANSION_DEPTH)
+        return lineError(line, Token::ErrorType::MACRO_RECURSION, "\"" + macro.name + "\"", error);
+
+    for (unsigned int t(1); t < line.m_tokens.size(); t++)
+    {
+        key.push_back('\0');
+        key += line.m_tokens[t].getSourceStr();
+    }
+
+    auto it = m_expansions.find(key);
+
+    // First use with these arguments
+    if (it == m_expansions.end())
+    {
+        Invocation macroInvocation = { &macro, {} };
+        std::vector<Token::TokenLine> body(macro.body);
+        Expansion expansion;
+
+        for (unsigned int t(1); t < line.m_tokens.size(); t++)
+            macroInvocation.arguments.push_back(line.m_tokens[t].getSourceStr());
+
+        if (!processLines(body, nullptr, &macroInvocation, depth + 1, expansion, error))
+            return false;
+
+        it = m_expansions.emplace(key, std::move(expansion)).first;
+    }
+
+    const Expansion &expansion = it->second;
+    std::string suffix("_" + ((invocation == nullptr) ? m_localLabelsTag + "_" : "") + std::to_string(++m_usesNb));
+    uint32_t offset = (uint32_t)result.lines.size();
+
+    for (const Token::TokenLine &expandedLine : expansion.lines)
+    {
+        result.lines.push_back(expandedLine);
+        result.lines.back().m_originFilePath = line.m_originFilePath;
+        result.lines.back().m_originLineNb = line.m_originLineNb;
+    }
+
+    for (const Site &site : expansion.localLabels)
+    {
+        addSuffix(result.lines[offset + site.line].m_tokens[site.token], suffix);
+
+        if (invocation != nullptr) // Renamed again at each use of the calling macro
+            result.localLabels.push_back({ offset + site.line, site.token });
+    }
+
+    if (invocation == nullptr)
+        return true;
+
+    // The arguments may be local labels or parameters of the calling macro
+    for (const ParameterSite &parameterSite : expansion.parameters)
+    {
+        Site site = { offset + parameterSite.site.line, parameterSite.site.token };
+        uint32_t argumentToken(parameterSite.parameter + 1);
+
+        for (const Site &localLabel : lineSites.localLabels)
+        {
+            if (localLabel.token == argumentToken)
+                result.localLabels.push_back(site);
+        }
+
+        for (const ParameterSite &parameter : lineSites.parameters)
+        {
+            if (parameter.site.token == argumentToken)
+                result.parameters.push_back({ site, parameter.parameter });
+        }
+    }
+
+    return true;
+}
+
+bool Preprocessor::substitute(Token::TokenLine &line, const Invocation &invocation, Expansion &lineSites, Error &error)
+{
+    const std::vector<std::string> &parameters = invocation.macro->parameters;
+
+    for (uint32_t t(0); t < line.m_tokens.size(); t++)
+    {
+        Token::TokenItem &token = line.m_tokens[t];
+        std::string name, prefix, suffix;
+
+        switch (token.getType())
+        {
+            case Token::TokenType::VAR:
+                name = token.getVariableName();
+                break;
+
+            case Token::TokenType::LABEL:
+                name = token.getLabelName();
+                prefix = ":";
+                break;
+
+            case Token::TokenType::ADDR_MSB:
+                name = token.getLabelName();
+                suffix = ".msb";
+                break;
+
+            case Token::TokenType::ADDR_LSB:
+                name = token.getLabelName();
+                suffix = ".lsb";
+                break;
+
+            case Token::TokenType::EXPRESSION:
+                token.setStr(substituteInExpression(token.getStr(), invocation));
+                continue;
+
+            default:
+                continue;
+        }
+
+        auto parameter = std::find(parameters.begin(), parameters.end(), name);
+
+        if (parameter != parameters.end())
+        {
+            uint32_t parameterIndex = (uint32_t)(parameter - parameters.begin());
+
+            token.setStr(prefix + invocation.arguments[parameterIndex] + suffix);
+
+            if (token.getErr() != Token::ErrorType::NONE)
+                return lineError(line, token.getErr(), "", error);
+
+            lineSites.parameters.push_back({ { 0, t }, parameterIndex });
+        }
+        else if (!name.empty() && name[0] == '@')
+        {
+            lineSites.localLabels.push_back({ 0, t });
+        }
+    }
+
+    return true;
+}
+
+std::string Preprocessor::substituteInExpression(const std::string &expression, const Invocation &invocation)
+{
+    const std::vector<std::string> &parameters = invocation.macro->parameters;
+    std::string result;
+    std::size_t i(0), end;
+
+    while (i < expression.size())
+    {
+        if (!isNameChar(expression[i], true))
+        {
+            // Numbers are copied whole, so the 'x' of "0x" is not read as a name
+            end = i + 1;
+
+            if (std::isdigit((unsigned char)expression[i]))
+            {
+                while (end < expression.size() && std::isalnum((unsigned char)expression[end]))
+                    end++;
+            }
+
+            result += expression.substr(i, end - i);
+            i = end;
+            continue;
+        }
+
+        for (end = i + 1; end < expression.size() && isNameChar(expression[end], false); end++);
+
+        std::string name(expression.substr(i, end - i)), suffix;
+
+        if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".msb") == 0 || name.compare(name.size() - 4, 4, ".lsb") == 0))
+        {
+            suffix = name.substr(name.size() - 4);
+            name.resize(name.size() - 4);
+        }
+
+        auto parameter = std::find(parameters.begin(), parameters.end(), name);
+
+        result += (parameter != parameters.end()) ? invocation.arguments[parameter - parameters.begin()] + suffix : name + suffix;
+        i = end;
+    }
+
+    return result;
+}
+
+bool Preprocessor::evaluateCondition(Token::TokenLine &line, bool &condition, Error &error)
+{
+    Token::TokenItem &argument = line.m_tokens[1];
+    Token::Directive directive = line.m_tokens[0].getDirective();
+    Token::ErrorType errorType;
+    std::string errorInfo;
+    Value value;
+
+    if (directive == Token::Directive::IFDEF || directive == Token::Directive::IFNDEF)
+    {
+        if (argument.getType() != Token::TokenType::VAR) // The name may come from an argument
+            return lineError(line, Token::ErrorType::COND_ARG_INVAL, "", error);
+
+        condition = isDefined(argument.getVariableName()) == (directive == Token::Directive::IFDEF);
+        return true;
+    }
+
+    if (argument.getType() == Token::TokenType::STRING)
+        return lineError(line, Token::ErrorType::COND_ARG_INVAL, "", error);
+
+    if (!evaluate(argument.getStr(), 0, value, errorType, errorInfo))
+        return lineError(line, errorType, errorInfo, error);
+
+    condition = value.number != 0;
+
+    return true;
+}
+
+bool Preprocessor::computeExpressions(Token::TokenLine &line, Error &error)
+{
+    Token::ErrorType errorType;
+    std::string errorInfo;
+    Value value;
+
+    for (unsigned int t(1); t < line.m_tokens.size(); t++)
+    {
+        Token::TokenItem &token = line.m_tokens[t];
+
+        if (token.getType() != Token::TokenType::EXPRESSION)
+            continue;
+
+        if (!evaluate(token.getStr(), 0, value, errorType, errorInfo))
+            return lineError(line, errorType, errorInfo, error);
+
+        // A value is an 8-bit operand, an address is a RAM or EEPROM address
+        if (value.number < 0 || value.number >= (value.address ? 0x100000 : 0x100))
+            return lineError(line, Token::ErrorType::CONST_EXPR_RANGE, token.getStr() + " = " + std::to_string(value.number), error);
+
+        if (value.address)
+        {
+            char address[16];
+
+            snprintf(address, sizeof(address), "$0x%04X", (unsigned int)value.number);
+            token.setStr(address);
+        }
+        else
+        {
+            token.setStr(std::to_string(value.number));
+        }
+    }
+
+    return true;
+}
+
+void Preprocessor::addSuffix(Token::TokenItem &token, const std::string &suffix)
+{
+    switch (token.getType())
+    {
+        case Token::TokenType::LABEL:
+            token.setStr(":" + token.getLabelName() + suffix);
+            break;
+
+        case Token::TokenType::ADDR_MSB:
+            token.setStr(token.getLabelName() + suffix + ".msb");
+            break;
+
+        case Token::TokenType::ADDR_LSB:
+            token.setStr(token.getLabelName() + suffix + ".lsb");
+            break;
+
+        default:
+            token.setStr(token.getStr() + suffix);
+            break;
+    }
+}
+
+bool Preprocessor::lineError(const Token::TokenLine &line, Token::ErrorType type, const std::string &additionalInfo, Error &error)
+{
+    error.originFilePath = line.m_originFilePath;
+    error.originLineNb = line.m_originLineNb;
+    error.originColumnNb = 0;
+    error.type = type;
+    error.additionalInfo = additionalInfo;
+
+    return false;
+}
+
+bool Preprocessor::evaluate(const std::string &expression, unsigned int defineDepth, Value &value, Token::ErrorType &errorType, std::string &errorInfo)
+{
+    // A define is evaluated while parsing the expression using it
+    std::string previousExpression(std::move(m_expression));
+    std::size_t previousPosition(m_position);
+    unsigned int previousDefineDepth(m_defineDepth);
+    bool valid;
+
+    m_expression = expression;
+    m_position = 0;
+    m_defineDepth = defineDepth;
+
+    valid = parseBinary(0, value);
+    skipSpaces();
+
+    if (valid && m_position != m_expression.size())
+        valid = parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + expression + "\"");
+
+    errorType = m_parseErrorType;
+    errorInfo = m_parseErrorInfo;
+
+    m_expression = std::move(previousExpression);
+    m_position = previousPosition;
+    m_defineDepth = previousDefineDepth;
+
+    return valid;
+}
+
+bool Preprocessor::parseBinary(unsigned int level, Value &value)
+{
+    // By increasing precedence, as in C
+    static const std::vector<std::vector<std::string>> OPERATORS = { { "||" }, { "&&" }, { "|" }, { "^" }, { "&" }, { "==", "!=" },
+                                                                     { "<", "<=", ">", ">=" }, { "<<", ">>" }, { "+", "-" }, { "*", "/", "%" } };
+
+    if (level == OPERATORS.size())
+        return parseUnary(value);
+
+    if (!parseBinary(level + 1, value))
+        return false;
+
+    while (true)
+    {
+        std::size_t position(m_position);
+        std::string op(readOperator());
+        Value right;
+
+        if (std::find(OPERATORS[level].begin(), OPERATORS[level].end(), op) == OPERATORS[level].end())
+        {
+            m_position = position; // Operator of a lower precedence, or end of the expression
+            return true;
+        }
+
+        if (!parseBinary(level + 1, right) || !applyOperator(op, value, right))
+            return false;
+    }
+}
+
+bool Preprocessor::parseUnary(Value &value)
+{
+    std::size_t position(m_position);
+    std::string op(readOperator());
+
+    if (op != "-" && op != "!" && op != "~")
+    {
+        m_position = position;
+        return parsePrimary(value);
+    }
+
+    if (m_nestingDepth >= MAX_NESTING_DEPTH)
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (too many nested operators)");
+
+    m_nestingDepth++;
+    bool valid = parseUnary(value);
+    m_nestingDepth--;
+
+    if (!valid)
+        return false;
+
+    if (op == "-")
+        value.number = -value.number;
+    else if (op == "!")
+        value.number = !value.number;
+    else
+        value.number = ~value.number;
+
+    value.address = false;
+
+    return checkValue(value);
+}
+
+bool Preprocessor::parsePrimary(Value &value)
+{
+    skipSpaces();
+
+    if (m_position == m_expression.size())
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+    char c(m_expression[m_position]);
+
+    if (c == '(')
+    {
+        m_position++;
+
+        if (m_nestingDepth >= MAX_NESTING_DEPTH)
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (too many nested parentheses)");
+
+        m_nestingDepth++;
+        bool valid = parseBinary(0, value);
+        m_nestingDepth--;
+
+        if (!valid)
+            return false;
+
+        if (readOperator() != ")")
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+        return true;
+    }
+
+    if (c == '$' || std::isdigit((unsigned char)c))
+    {
+        // "$0x" address, "0x" hexadecimal value or decimal value
+        bool address(c == '$');
+        int base(10);
+
+        if (address)
+            m_position++;
+
+        if (m_expression.compare(m_position, 2, "0x") == 0)
+        {
+            base = 16;
+            m_position += 2;
+        }
+        else if (address)
+        {
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+        }
+
+        const char *begin = m_expression.data() + m_position;
+        std::from_chars_result result = std::from_chars(begin, m_expression.data() + m_expression.size(), value.number, base);
+
+        if (result.ec != std::errc() || *begin == '-' || (result.ptr != m_expression.data() + m_expression.size() && std::isalnum((unsigned char)*result.ptr)))
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+        m_position += result.ptr - begin;
+        value.address = address;
+
+        return checkValue(value);
+    }
+
+    if (!isNameChar(c, true))
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+    std::string name(readName());
+
+    if (name == "defined")
+    {
+        if (readOperator() != "(")
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+        skipSpaces();
+        name = readName();
+
+        if (name.empty() || readOperator() != ")")
+            return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\"");
+
+        value = { isDefined(name) ? 1 : 0, false };
+        return true;
+    }
+
+    // Most or least significant byte of a define
+    std::string byte;
+
+    if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".msb") == 0 || name.compare(name.size() - 4, 4, ".lsb") == 0))
+    {
+        byte = name.substr(name.size() - 4);
+        name.resize(name.size() - 4);
+    }
+
+    int defineIndex = m_symbols.getBinding(m_symbols.find(name), SymbolKind::DEFINE);
+    Token::ErrorType errorType;
+    std::string errorInfo;
+
+    if (defineIndex == NO_BINDING)
+        return parseError(Token::ErrorType::CONST_EXPR_UNKNOWN, "\"" + name + "\"");
+
+    if (m_defineDepth >= MAX_DEFINE_DEPTH)
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " (too many defines replaced by defines from \"" + name + "\")");
+
+    if (!evaluate(m_defines[defineIndex].replacementStr, m_defineDepth + 1, value, errorType, errorInfo))
+        return parseError(errorType, errorInfo);
+
+    if (byte == ".msb")
+        value = { (value.number >> 8) & 0xFF, false };
+    else if (byte == ".lsb")
+        value = { value.number & 0xFF, false };
+
+    return true;
+}
+
+bool Preprocessor::applyOperator(const std::string &op, Value &left, Value right)
+{
+    int64_t a(left.number), b(right.number);
+
+    if ((op == "/" || op == "%") && b == 0)
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (division by zero)");
+
+    if ((op == "<<" || op == ">>") && (b < 0 || b > 32))
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (shift by more than 32 bits)");
+
+    if (op == "<<" && a < 0)
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (shift of a negative value)");
+
+    // Operands are within MAX_EXPRESSION_VALUE: only a product or a left shift can exceed the 64-bit range
+    if ((op == "*" && a != 0 && (b > MAX_EXPRESSION_VALUE / (a < 0 ? -a : a) || b < -MAX_EXPRESSION_VALUE / (a < 0 ? -a : a)))
+     || (op == "<<" && a > (MAX_EXPRESSION_VALUE >> b)))
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (value out of the 32-bit range)");
+
+    // Only an address plus or minus an offset is still an address
+    left.address = (op == "+" && (left.address || right.address)) || (op == "-" && left.address && !right.address);
+
+    if (op == "||")      left.number = a || b;
+    else if (op == "&&") left.number = a && b;
+    else if (op == "|")  left.number = a | b;
+    else if (op == "^")  left.number = a ^ b;
+    else if (op == "&")  left.number = a & b;
+    else if (op == "==") left.number = a == b;
+    else if (op == "!=") left.number = a != b;
+    else if (op == "<")  left.number = a < b;
+    else if (op == "<=") left.number = a <= b;
+    else if (op == ">")  left.number = a > b;
+    else if (op == ">=") left.number = a >= b;
+    else if (op == "<<") left.number = a << b;
+    else if (op == ">>") left.number = a >> b;
+    else if (op == "+")  left.number = a + b;
+    else if (op == "-")  left.number = a - b;
+    else if (op == "*")  left.number = a * b;
+    else if (op == "/")  left.number = a / b;
+    else                 left.number = a % b;
+
+    return checkValue(left);
+}
+
+bool Preprocessor::checkValue(const Value &value)
+{
+    if (value.number > MAX_EXPRESSION_VALUE || value.number < -MAX_EXPRESSION_VALUE)
+        return parseError(Token::ErrorType::CONST_EXPR_INVAL, " \"" + m_expression + "\" (value out of the 32-bit range)");
+
+    return true;
+}
+
+std::string Preprocessor::readOperator()
+{
+    static const std::string TWO_CHARS_OPERATORS[] = { "||", "&&", "==", "!=", "<=", ">=", "<<", ">>" };
+
+    skipSpaces();
+
+    for (const std::string &op : TWO_CHARS_OPERATORS)
+    {
+        if (m_expression.compare(m_position, 2, op) == 0)
+        {
+            m_position += 2;
+            return op;
+        }
+    }
+
+    if (m_position < m_expression.size() && std::string("|^&<>+-*/%!~()").find(m_expression[m_position]) != std::string::npos)
+        return std::string(1, m_expression[m_position++]);
+
+    return "";
+}
+
+std::string Preprocessor::readName()
+{
+    std::size_t begin(m_position);
+
+    if (m_position < m_expression.size() && isNameChar(m_expression[m_position], true))
+    {
+        while (m_position < m_expression.size() && isNameChar(m_expression[m_position], false))
+            m_position++;
+    }
+
+    return m_expression.substr(begin, m_position - begin);
+}
+
+void Preprocessor::skipSpaces()
+{
+    while (m_position < m_expression.size() && m_expression[m_position] == ' ')
+        m_position++;
+}
+
+bool Preprocessor::isDefined(const std::string &name) const
+{
+    SymbolId symbol(m_symbols.find(name));
+
+    return m_symbols.getBinding(symbol, SymbolKind::DEFINE) != NO_BINDING || m_symbols.getBinding(symbol, SymbolKind::MACRO) != NO_BINDING;
+}
+
+bool Preprocessor::isNameChar(char c, bool first)
+{
+    return std::isalpha((unsigned char)c) || c == '_' || c == '@' || (!first && (std::isdigit((unsigned char)c) || c == '.'));
+}
+
+bool Preprocessor::parseError(Token::ErrorType type, const std::string &info)
+{
+    m_parseErrorType = type;
+    m_parseErrorInfo = info;
+
+    return false;
+}
@@ -0,0 +1,170 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+/*!
+ * \file preprocessor.h
+ * \brief Macros with parameters, conditional blocks and constant expressions of the assembly language
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "symbolTable.h"
+#include "token.h"
+
+namespace Assembly
+{
+    struct Define;
+    struct Error;
+
+    /*!
+     * \struct Macro
+     * \brief Stores informations describing a macro: its parameters and the tokens of its body.
+     */
+    struct Macro
+    {
+        std::string name;
+        std::vector<std::string> parameters;
+        std::vector<Token::TokenLine> body; //!< Lines between ".macro" and ".endm", defines not replaced
+        QString fileWhereDefined;
+        unsigned int lineNbWhereDefined;
+    };
+
+    /*!
+     * \class Preprocessor
+     * \brief Expands the macros, removes the false conditional blocks and computes the constant expressions of a file
+     *
+     * <i>.macro name [parameters] / lines / .endm</i> defines a macro, a line starting with its name uses it.
+     * Each parameter written as a whole token of the body <i>(or before ".msb" and ".lsb", or in an expression)</i> is replaced by its argument.<br>
+     * Names starting with '@' are local labels: they get a new suffix at each use of the macro.<br>
+     * <i>.if expression</i>, <i>.ifdef name</i> and <i>.ifndef name</i> keep the lines up to <i>.else</i> or <i>.endif</i> if true.<br>
+     * A constant expression is written in parentheses, with C operators, values, addresses, defines and <i>defined(name)</i>.
+     *
+     * Only the lines found by listMacros() are looked at, the others are moved as they are.
+     * The expansion of a macro is computed once for each list of arguments, then copied at each use.
+     */
+    class Preprocessor
+    {
+        public:
+            /*!
+             * \param symbols Names of the defines and macros of all files, bound by the Assembler
+             * \param localLabelsTag Added to the local labels expanded in the file, so they cannot match the ones of another file
+             */
+            Preprocessor(const SymbolTable &symbols, const std::vector<Define> &defines, const std::vector<Macro> &macros, const std::string &localLabelsTag);
+
+            /*!
+             * \brief Checks the directives of a file, and copies its macros to <i>fileMacros</i>
+             *
+             * \param sites Receives the lines the preprocessor must look at: directives, possible macro uses and constant expressions
+             */
+            static bool listMacros(Token::TokenFile &f, std::vector<Macro> &fileMacros, std::vector<unsigned int> &sites, Error &error);
+
+            /*!
+             * \brief Replaces the macro definitions, macro uses and conditional blocks of the file by the lines they produce
+             *
+             * Lines coming from a macro are located at the line using it.
+             */
+            bool processFile(Token::TokenFile &f, const std::vector<unsigned int> &sites, Error &error);
+
+            static constexpr unsigned int MAX_EXPANSION_DEPTH = 32; //!< Nested macro uses
+            static constexpr unsigned int MAX_DEFINE_DEPTH = 16; //!< Defines replaced by defines in an expression
+            static constexpr unsigned int MAX_NESTING_DEPTH = 64; //!< Parentheses and unary operators in an expression
+            static constexpr int64_t MAX_EXPRESSION_VALUE = 0xFFFFFFFF; //!< Bound of the absolute value of every operand and result
+
+        private:
+            struct Site
+            {
+                uint32_t line;
+                uint32_t token;
+            };
+
+            struct ParameterSite
+            {
+                Site site;
+                uint32_t parameter;
+            };
+
+            /*!
+             * \brief Lines produced by a macro for a list of arguments
+             *
+             * The sites are the tokens to rename at each use: the local labels of the macro and of the macros it uses,
+             * and the arguments given to the macros it uses <i>(they may be local labels of the calling macro)</i>.
+             */
+            struct Expansion
+            {
+                std::vector<Token::TokenLine> lines;
+                std::vector<Site> localLabels;
+                std::vector<ParameterSite> parameters;
+            };
+
+            struct Invocation
+            {
+                const Macro *macro;
+                std::vector<std::string> arguments; //!< As written in the code
+            };
+
+            struct Value
+            {
+                int64_t number;
+                bool address; //!< Offsets of an address stay addresses
+            };
+
+            struct Conditional
+            {
+                bool parentActive;
+                bool condition;
+                bool elseFound;
+            };
+
+            /*!
+             * \param sites nullptr to look at every line <i>(body of a macro)</i>
+             * \param invocation nullptr for the lines of the file
+             */
+            bool processLines(std::vector<Token::TokenLine> &lines, const std::vector<unsigned int> *sites, const Invocation *invocation,
+                              unsigned int depth, Expansion &result, Error &error);
+            bool expand(Token::TokenLine &line, int macroIndex, const Expansion &lineSites, const Invocation *invocation,
+                        unsigned int depth, Expansion &result, Error &error);
+            bool substitute(Token::TokenLine &line, const Invocation &invocation, Expansion &lineSites, Error &error);
+            std::string substituteInExpression(const std::string &expression, const Invocation &invocation);
+            bool evaluateCondition(Token::TokenLine &line, bool &condition, Error &error);
+            bool computeExpressions(Token::TokenLine &line, Error &error);
+            static void addSuffix(Token::TokenItem &token, const std::string &suffix);
+            static bool lineError(const Token::TokenLine &line, Token::ErrorType type, const std::string &additionalInfo, Error &error); //!< Always returns <b>false</b>
+
+            // Constant expressions: recursive descent, from the lowest precedence
+            bool evaluate(const std::string &expression, unsigned int defineDepth, Value &value, Token::ErrorType &errorType, std::string &errorInfo);
+            bool parseBinary(unsigned int level, Value &value);
+            bool parseUnary(Value &value);
+            bool parsePrimary(Value &value);
+            bool applyOperator(const std::string &op, Value &left, Value right);
+            bool checkValue(const Value &value); //!< <b>false</b> if out of the 32-bit range
+            std::string readOperator();
+            std::string readName();
+            void skipSpaces();
+            bool isDefined(const std::string &name) const;
+            static bool isNameChar(char c, bool first);
+            bool parseError(Token::ErrorType type, const std::string &info); //!< Always returns <b>false</b>
+
+            // Attributes
+            const SymbolTable &m_symbols;
+            const std::vector<Define> &m_defines;
+            const std::vector<Macro> &m_macros;
+            std::string m_localLabelsTag;
+            unsigned int m_usesNb = 0;
+
+            std::unordered_map<std::string, Expansion> m_expansions; //!< By macro index and arguments, references never move
+
+            // State of the expression being parsed
+            std::string m_expression;
+            std::size_t m_position = 0;
+            unsigned int m_defineDepth = 0;
+            unsigned int m_nestingDepth = 0;
+            Token::ErrorType m_parseErrorType = Token::ErrorType::NONE;
+            std::string m_parseErrorInfo;
+    };
+}
+
+#endif // PREPROCESSOR_H
@@ -1,7 +1,15 @@
 #include "ram.h"
 
+#include <algorithm>
+
 void Ram::write(HbcRam &ram, Word address, Byte data)
 {
+    if (address >= ram.mappedAddress && address < ram.mappedAddress + ram.mappedSize) // Always false if nothing is mapped
+    {
+        ram.mappedDevice->writeMapped(address - ram.mappedAddress, data);
+        return;
+    }
+
     ram.mutex.lock();
     ram.memory[address] = data;
     ram.mutex.unlock();
@@ -11,6 +19,9 @@ Byte Ram::read(HbcRam &ram, Word address)
 {
     Byte valueRead;
 
+    if (address >= ram.mappedAddress && address < ram.mappedAddress + ram.mappedSize) // Always false if nothing is mapped
+        return ram.mappedDevice->readMapped(address - ram.mappedAddress);
+
     ram.mutex.lock();
     valueRead = ram.memory[address];
     ram.mutex.unlock();
@@ -46,3 +57,20 @@ void Ram::fillNull(HbcRam &ram)
     }
     ram.mutex.unlock();
 }
+
+void Ram::mapDevice(HbcRam &ram, HbcMemoryMappedDevice *device, Word address, int size)
+{
+    ram.mappedDevice = device;
+    ram.mappedAddress = address;
+    ram.mappedSize = std::max(0, std::min(size, MEMORY_SIZE - address));
+}
+
+void Ram::unmapDevice(HbcRam &ram, HbcMemoryMappedDevice *device)
+{
+    if (ram.mappedDevice != device)
+        return;
+
+    ram.mappedDevice = nullptr;
+    ram.mappedAddress = 0;
+    ram.mappedSize = 0;
+}
@@ -14,6 +14,21 @@
 #include <QMutex>
 #include "computerDetails.h"
 
+/*!
+ * \class HbcMemoryMappedDevice
+ * \brief Device whose memory can alias a window of the HBC-2 address space
+ *
+ * Accesses to the window made through Ram::read() and Ram::write() are redirected to the device, in the emulator thread.
+ */
+class HbcMemoryMappedDevice
+{
+    public:
+        virtual ~HbcMemoryMappedDevice() {}
+
+        virtual Byte readMapped(int offset) = 0; //!< <i>offset</i> is relative to the start of the window
+        virtual void writeMapped(int offset, Byte data) = 0;
+};
+
 /*!
  * \struct HbcRam
  * \brief Stores the Ram state
@@ -22,6 +37,10 @@ struct HbcRam
 {
     QMutex mutex;
     Byte memory[Ram::MEMORY_SIZE]; //!< 65,536 bytes
+
+    HbcMemoryMappedDevice *mappedDevice = nullptr; //!< Device aliasing the window <i>(nullptr = none)</i>
+    int mappedAddress = 0; //!< First address of the window
+    int mappedSize = 0; //!< Size of the window, truncated at the end of the address space
 };
 
 // Already documented in computerDetails.h
@@ -53,6 +72,22 @@ namespace Ram
      * \brief Fills the memory with value <b>0x00</b>
      */
     void fillNull(HbcRam &ram);
+
+    /*!
+     * \brief Redirects the accesses to a window of the address space to a device
+     *
+     * Replaces the previous mapping. The bytes of the RAM hidden by the window are kept, and seen again when it is unmapped.<br>
+     * <b>WARNING:</b> Only accesses through read() and write() are redirected, not direct accesses to HbcRam::memory (HbcDma, HbcStorage)
+     *
+     * \param address First address of the window
+     * \param size Size of the window
+     */
+    void mapDevice(HbcRam &ram, HbcMemoryMappedDevice *device, Word address, int size);
+
+    /*!
+     * \brief Removes the window of <i>device</i>, if it is the mapped one
+     */
+    void unmapDevice(HbcRam &ram, HbcMemoryMappedDevice *device);
 }
 
 #endif // RAM_H
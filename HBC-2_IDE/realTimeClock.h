@@ -106,7 +106,7 @@ namespace RealTimeClock
      *
      * Any invalid command will result in <b>NOP</b>.
      */
-    class HbcRealTimeClock : public HbcPeripheral
+    class HbcRealTimeClock final : public HbcPeripheral
     {
         public:
             /*!
@@ -0,0 +1,166 @@
+#include "serial.h"
+
+#include <QDir>
+
+using namespace Serial;
+
+// SerialWorker PUBLIC
+SerialWorker::SerialWorker(OutputRing *output, InputRing *input, std::atomic<quint64> *droppedBytesNb, QString projectDirPath, int sinks)
+{
+    m_output = output;
+    m_input = input;
+    m_droppedBytesNb = droppedBytesNb;
+    m_sinks = sinks;
+
+    if (!projectDirPath.isEmpty())
+    {
+        QDir projectDir(projectDirPath);
+
+        if (m_sinks & SINK_FILE)
+        {
+            m_outputFile.setFileName(projectDir.filePath(OUTPUT_FILE_NAME));
+            m_outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        }
+
+        m_inputFile.setFileName(projectDir.filePath(INPUT_FILE_NAME));
+
+        if (m_inputFile.exists())
+            m_inputFile.open(QIODevice::ReadOnly);
+    }
+}
+
+SerialWorker::~SerialWorker()
+{
+    requestInterruption();
+    wait();
+
+    m_outputFile.close();
+    m_inputFile.close();
+}
+
+// SerialWorker PROTECTED
+void SerialWorker::run()
+{
+    while (!isInterruptionRequested())
+    {
+        flushOutput();
+        fillInput();
+
+        msleep(FLUSH_INTERVAL_MS);
+    }
+
+    flushOutput(); // Bytes sent just before the device was unplugged
+}
+
+// SerialWorker PRIVATE
+void SerialWorker::flushOutput()
+{
+    Byte batch[FLUSH_BATCH_SIZE];
+    std::size_t batchSize;
+
+    while ((batchSize = m_output->popBatch(batch, FLUSH_BATCH_SIZE)) > 0)
+    {
+        QByteArray data(reinterpret_cast<const char*>(batch), (int)batchSize);
+
+        if (m_outputFile.isOpen())
+            m_outputFile.write(data);
+
+        if (m_sinks & SINK_PANE)
+            emit outputReady(data);
+    }
+
+    if (m_outputFile.isOpen())
+        m_outputFile.flush();
+
+    quint64 droppedBytesNb = m_droppedBytesNb->exchange(0, std::memory_order_relaxed);
+
+    if (droppedBytesNb > 0)
+        emit bytesDropped(droppedBytesNb);
+}
+
+void SerialWorker::fillInput()
+{
+    if (!m_inputFile.isOpen())
+        return;
+
+    std::size_t space = m_input->available();
+
+    if (space == 0)
+        return;
+
+    QByteArray data = m_inputFile.read((qint64)space);
+
+    for (int i(0); i < data.size(); i++)
+    {
+        m_input->push((Byte)data[i]);
+    }
+
+    if (m_inputFile.atEnd())
+        m_inputFile.close();
+}
+
+// HbcSerial PUBLIC
+HbcSerial::HbcSerial(QString projectDirPath, int sinks, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput), m_droppedBytesNb(0)
+{
+    m_worker = new SerialWorker(&m_output, &m_input, &m_droppedBytesNb, projectDirPath, sinks);
+    m_worker->start(QThread::LowPriority);
+}
+
+HbcSerial::~HbcSerial()
+{
+    delete m_worker; // Stops the thread after a last flush, before the rings are destroyed
+}
+
+void HbcSerial::init()
+{
+    m_sockets = Iod::requestPortsConnexions(*m_iod, DEVICE_ID, PORTS_NB);
+
+    if (m_sockets.size() < PORTS_NB)
+    {
+        m_consoleOutput->log("Cannot plug the serial port, not enough available ports");
+    }
+}
+
+void HbcSerial::tick(bool step)
+{
+    if (m_sockets.size() < PORTS_NB)
+        return;
+
+    Command command = (Command)*m_sockets[(int)Port::CMD].portDataPointer;
+
+    if (command == Command::NOP)
+        return;
+
+    Byte status(0x00);
+
+    if (command == Command::SEND)
+    {
+        if (!m_output.push(*m_sockets[(int)Port::DATA].portDataPointer))
+        {
+            m_droppedBytesNb.fetch_add(1, std::memory_order_relaxed);
+            status |= OUTPUT_OVERRUN;
+        }
+    }
+    else if (command == Command::RECEIVE)
+    {
+        Byte data(0x00);
+        m_input.pop(data);
+
+        *m_sockets[(int)Port::DATA].portDataPointer = data;
+    }
+    else
+    {
+        status |= INVALID_COMMAND;
+    }
+
+    if (!m_input.empty())
+        status |= INPUT_AVAILABLE;
+
+    *m_sockets[(int)Port::CMD].portDataPointer = (int)Command::NOP;
+    *m_sockets[(int)Port::STATUS].portDataPointer = status;
+}
+
+SerialWorker* HbcSerial::getWorker()
+{
+    return m_worker;
+}
@@ -0,0 +1,189 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+/*!
+ * \file serial.h
+ * \brief Serial port device derived from HbcPeripheral
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <atomic>
+#include <QThread>
+#include <QFile>
+#include "peripheral.h"
+#include "spscRing.h"
+
+/*!
+ * \namespace Serial
+ * \brief See HbcSerial for detailed specifications.
+ */
+namespace Serial
+{
+    constexpr Byte DEVICE_ID = 0x3C; //!< Random to "look" nice
+
+    constexpr int OUTPUT_BUFFER_SIZE = 65536; //!< Bytes waiting to be flushed, the guest program never waits for the host
+    constexpr int INPUT_BUFFER_SIZE = 4096; //!< Bytes read in advance from the input file
+    constexpr int FLUSH_BATCH_SIZE = 8192; //!< Maximum size of a single write to the outputs
+    constexpr int FLUSH_INTERVAL_MS = 20; //!< The outputs are updated at most 50 times per second
+
+    const QString OUTPUT_FILE_NAME = "serial_output.txt"; //!< Output file, in the project directory
+    const QString INPUT_FILE_NAME = "serial_input.txt"; //!< Input file, in the project directory
+
+    constexpr int PORTS_NB = 3;
+    enum class Port { STATUS = 0, CMD = 1, DATA = 2 }; //!< Lists the ports used by the serial port
+    enum class Command { NOP = 0, SEND = 1, RECEIVE = 2 }; //!< Lists the commands used by the serial port
+
+    /*!
+     * \brief Bits of the STATUS port
+     */
+    enum StatusFlag : Byte
+    {
+        INPUT_AVAILABLE = 0x01, //!< At least one byte can be received
+        OUTPUT_OVERRUN = 0x02, //!< The last sent byte was dropped because the host could not keep up
+        INVALID_COMMAND = 0x80
+    };
+
+    /*!
+     * \brief Host outputs receiving the sent bytes
+     */
+    enum Sink
+    {
+        SINK_PANE = 0x01, //!< SerialWorker::outputReady() signal, displayed by the IDE
+        SINK_FILE = 0x02 //!< OUTPUT_FILE_NAME in the project directory
+    };
+
+    using OutputRing = SpscRing<Byte, OUTPUT_BUFFER_SIZE>;
+    using InputRing = SpscRing<Byte, INPUT_BUFFER_SIZE>;
+
+    /*!
+     * \class SerialWorker
+     * \brief Host side of the serial port, flushes the output buffer and fills the input buffer in its own thread
+     *
+     * It is the consumer of the output ring and the producer of the input ring, the emulator thread being the other side of both.
+     */
+    class SerialWorker : public QThread
+    {
+        Q_OBJECT
+
+        public:
+            SerialWorker(OutputRing *output, InputRing *input, std::atomic<quint64> *droppedBytesNb, QString projectDirPath, int sinks);
+            ~SerialWorker();
+
+        signals:
+            void outputReady(QByteArray data); //!< Sent with each flushed batch if SINK_PANE is enabled
+            void bytesDropped(quint64 count); //!< Sent when output bytes were lost since the last flush
+
+        protected:
+            void run() override;
+
+        private:
+            void flushOutput();
+            void fillInput();
+
+            OutputRing *m_output;
+            InputRing *m_input;
+            std::atomic<quint64> *m_droppedBytesNb;
+
+            int m_sinks;
+            QFile m_outputFile;
+            QFile m_inputFile;
+    };
+
+    /*!
+     * \class HbcSerial
+     * \brief Derived from HbcPeripheral, represents a serial port used for program output and debugging
+     *
+     * This class is responsible for emulating a serial port exchanging bytes with the host.
+     *
+     * <b>Device ID:</b> 0x3C
+     *
+     * Sent bytes are stored in a lock-free buffer of OUTPUT_BUFFER_SIZE bytes, which a SerialWorker thread flushes every FLUSH_INTERVAL_MS
+     * to the IDE serial pane and to the Serial::OUTPUT_FILE_NAME file of the project directory.<br>
+     * The emulator never waits for the outputs: if the buffer is full, the sent byte is dropped and the OUTPUT_OVERRUN flag is set.
+     *
+     * Received bytes are read from the Serial::INPUT_FILE_NAME file of the project directory, if it exists.<br>
+     * It is read once per project loading, so rerunning the program does not replay it.
+     *
+     * After every command:
+     * 1. the CMD port is set back to <b>NOP</b>,
+     * 2. the STATUS port is updated.
+     *
+     * No interrupt is triggered, the serial port is polled.
+     *
+     * <h2>Control</h2>
+     * Like every HbcPeripheral, HbcSerial uses sockets connecting it to HbcIod ports to communicate with HbcCpu.
+     *
+     * <table>
+     *  <caption>List of available ports</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Port</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>STATUS</td>
+     *   <td>Bit 0: INPUT_AVAILABLE, bit 1: OUTPUT_OVERRUN, bit 7: INVALID_COMMAND</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>CMD</td>
+     *   <td>Command sent by HbcCpu</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>DATA</td>
+     *   <td>Byte sent or received</td>
+     *  </tr>
+     * </table>
+     *
+     * <table>
+     *  <caption>List of available commands</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Command</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>NOP</td>
+     *   <td>No operation</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>SEND</td>
+     *   <td>Sends the DATA byte</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>RECEIVE</td>
+     *   <td>Writes the next received byte to DATA <i>(0x00 if INPUT_AVAILABLE was not set)</i></td>
+     *  </tr>
+     * </table>
+     */
+    class HbcSerial final : public HbcPeripheral
+    {
+        public:
+            /*!
+             * \param projectDirPath Directory of the input and output files <i>(empty to disable them)</i>
+             * \param sinks Combination of Serial::Sink values
+             */
+            HbcSerial(QString projectDirPath, int sinks, HbcIod *iod, Console *consoleOutput);
+            ~HbcSerial();
+
+            void init() override;
+            void tick(bool step) override;
+
+            SerialWorker* getWorker();
+
+        private:
+            OutputRing m_output;
+            InputRing m_input;
+            std::atomic<quint64> m_droppedBytesNb; //!< Written by the emulator thread, reset by the worker
+
+            SerialWorker *m_worker;
+    };
+}
+
+#endif // SERIAL_H
@@ -0,0 +1,126 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+/*!
+ * \file spscRing.h
+ * \brief Lock-free single producer / single consumer ring buffer
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*!
+ * \class SpscRing
+ * \brief Fixed size FIFO shared by exactly one producer thread and one consumer thread, without locks
+ *
+ * Neither side ever waits: push() fails when the ring is full and pop() fails when it is empty.<br>
+ * <i>CAPACITY</i> must be a power of 2.
+ */
+template<typename T, std::size_t CAPACITY>
+class SpscRing
+{
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of 2");
+
+    public:
+        /*!
+         * \brief <b>Producer only</b>
+         * \return <b>false</b> if the ring is full (the element is not stored)
+         */
+        bool push(const T &element)
+        {
+            std::size_t head = m_head.load(std::memory_order_relaxed);
+
+            if (head - m_tail.load(std::memory_order_acquire) == CAPACITY)
+                return false;
+
+            m_buffer[head & (CAPACITY - 1)] = element;
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /*!
+         * \brief <b>Consumer only</b>
+         * \return <b>false</b> if the ring is empty
+         */
+        bool pop(T &element)
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail == m_head.load(std::memory_order_acquire))
+                return false;
+
+            element = m_buffer[tail & (CAPACITY - 1)];
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /*!
+         * \brief <b>Consumer only</b>, pops up to <i>maxCount</i> elements at once
+         * \return the number of elements popped
+         */
+        std::size_t popBatch(T *elements, std::size_t maxCount)
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            std::size_t count = m_head.load(std::memory_order_acquire) - tail;
+
+            if (count > maxCount)
+                count = maxCount;
+
+            for (std::size_t i(0); i < count; i++)
+            {
+                elements[i] = m_buffer[(tail + i) & (CAPACITY - 1)];
+            }
+
+            m_tail.store(tail + count, std::memory_order_release);
+
+            return count;
+        }
+
+        /*!
+         * \brief <b>Consumer only</b>, gives access to the oldest element without popping it
+         * \return <b>nullptr</b> if the ring is empty
+         */
+        T* front()
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail == m_head.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &m_buffer[tail & (CAPACITY - 1)];
+        }
+
+        /*!
+         * \return the number of stored elements <i>(only exact when called by the producer or the consumer)</i>
+         */
+        std::size_t size() const
+        {
+            return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /*!
+         * \return free space <i>(only exact when called by the producer)</i>
+         */
+        std::size_t available() const
+        {
+            return CAPACITY - size();
+        }
+
+    private:
+        std::array<T, CAPACITY> m_buffer{};
+
+        alignas(64) std::atomic<std::size_t> m_head{0}; //!< Next element written (producer)
+        alignas(64) std::atomic<std::size_t> m_tail{0}; //!< Next element read (consumer)
+};
+
+#endif // SPSCRING_H
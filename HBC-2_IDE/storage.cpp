@@ -0,0 +1,306 @@
+#include "storage.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Storage;
+
+// PUBLIC
+HbcStorage::HbcStorage(QString sandboxDirPath, HbcRam *ram, HbcIod *iod, Console *consoleOutput) : HbcPeripheral(iod, consoleOutput)
+{
+    m_ram = ram;
+    m_sectorsNb = 0;
+
+    if (openImage(sandboxDirPath))
+    {
+        m_consoleOutput->log("Storage image loaded (" + QString::number(m_sectorsNb) + " sectors)");
+    }
+}
+
+HbcStorage::~HbcStorage()
+{
+    flush();
+    m_image.close();
+}
+
+void HbcStorage::init()
+{
+    m_sockets = Iod::requestPortsConnexions(*m_iod, DEVICE_ID, PORTS_NB);
+
+    if (m_sockets.size() < PORTS_NB)
+    {
+        m_consoleOutput->log("Cannot plug the storage device, not enough available ports");
+    }
+
+    flush(); // Nothing written by a previous run is lost
+}
+
+void HbcStorage::tick(bool step)
+{
+    if (m_sockets.size() < PORTS_NB)
+        return;
+
+    Command command = (Command)*m_sockets[(int)Port::CMD].portDataPointer;
+
+    if (command == Command::NOP)
+        return;
+
+    Dword lba = 0x00000000;
+    lba += *m_sockets[(int)Port::LBA_2].portDataPointer;
+    lba += ((int)*m_sockets[(int)Port::LBA_1].portDataPointer) << 8;
+    lba += ((int)*m_sockets[(int)Port::LBA_0].portDataPointer) << 16;
+
+    Word address = (*m_sockets[(int)Port::ADDR_0].portDataPointer << 8) + *m_sockets[(int)Port::ADDR_1].portDataPointer;
+    int count = *m_sockets[(int)Port::COUNT].portDataPointer;
+
+    bool success(false);
+
+    if (m_image.isOpen())
+    {
+        if (command == Command::READ)
+        {
+            success = readSectors(lba, address, count);
+        }
+        else if (command == Command::WRITE)
+        {
+            success = writeSectors(lba, address, count);
+        }
+        else if (command == Command::FLUSH)
+        {
+            success = flush();
+        }
+    }
+
+    *m_sockets[(int)Port::CMD].portDataPointer = (int)Command::NOP;
+    *m_sockets[(int)Port::STATUS].portDataPointer = (int)(success ? Status::DONE : Status::ERROR);
+
+    Iod::triggerInterrupt(*m_iod, m_sockets[(int)Port::STATUS].portId);
+}
+
+// PRIVATE
+bool HbcStorage::openImage(QString sandboxDirPath)
+{
+    if (sandboxDirPath.isEmpty())
+    {
+        m_consoleOutput->log("No project directory for the storage image");
+        return false;
+    }
+
+    QDir sandboxDir(sandboxDirPath);
+    QFileInfo imageInfo(sandboxDir.filePath(IMAGE_FILE_NAME));
+
+    if (!imageInfo.exists())
+    {
+        m_consoleOutput->log("The storage image " + imageInfo.absoluteFilePath() + " does not exist");
+        return false;
+    }
+
+    // Canonical paths resolve symbolic links, so the image cannot lead outside of the project directory
+    QString canonicalSandboxPath = sandboxDir.canonicalPath();
+    QString canonicalImagePath = imageInfo.canonicalFilePath();
+
+    if (canonicalSandboxPath.isEmpty() || !canonicalImagePath.startsWith(canonicalSandboxPath + "/"))
+    {
+        m_consoleOutput->log("The storage image must be located in the project directory");
+        return false;
+    }
+
+    m_image.setFileName(canonicalImagePath);
+
+    if (!m_image.open(QIODevice::ReadWrite))
+    {
+        m_consoleOutput->log("The storage image could not be opened");
+        return false;
+    }
+
+    m_sectorsNb = std::min<qint64>(m_image.size() / SECTOR_SIZE, 0x1000000); // 24-bit sector numbers
+
+    return true;
+}
+
+bool HbcStorage::readSectors(Dword lba, Word address, int count)
+{
+    if (lba + count > m_sectorsNb || address + count * SECTOR_SIZE > Ram::MEMORY_SIZE)
+        return false;
+
+    bool success(true);
+
+    m_ram->mutex.lock();
+    for (int i(0); i < count; i++)
+    {
+        CachedSector *sector = getSector(lba + i);
+
+        if (sector == nullptr)
+        {
+            success = false;
+            break;
+        }
+
+        std::memcpy(m_ram->memory + address + i * SECTOR_SIZE, sector->data.data(), SECTOR_SIZE);
+    }
+    m_ram->mutex.unlock();
+
+    return success;
+}
+
+bool HbcStorage::writeSectors(Dword lba, Word address, int count)
+{
+    if (lba + count > m_sectorsNb || address + count * SECTOR_SIZE > Ram::MEMORY_SIZE)
+        return false;
+
+    m_ram->mutex.lock();
+    for (int i(0); i < count; i++)
+    {
+        CachedSector *sector;
+        auto cacheEntry = m_cacheIndex.find(lba + i);
+
+        if (cacheEntry != m_cacheIndex.end())
+        {
+            m_cache.splice(m_cache.begin(), m_cache, cacheEntry->second);
+            sector = &m_cache.front();
+        }
+        else
+        {
+            sector = insertSector(lba + i); // The whole sector is overwritten, no need to read it
+        }
+
+        std::memcpy(sector->data.data(), m_ram->memory + address + i * SECTOR_SIZE, SECTOR_SIZE);
+        sector->dirty = true;
+    }
+    m_ram->mutex.unlock();
+
+    return true;
+}
+
+bool HbcStorage::flush()
+{
+    if (!m_image.isOpen())
+        return false;
+
+    std::vector<CachedSector*> dirtySectors;
+
+    for (CachedSector &sector : m_cache)
+    {
+        if (sector.dirty)
+            dirtySectors.push_back(&sector);
+    }
+
+    if (dirtySectors.empty())
+        return true;
+
+    std::sort(dirtySectors.begin(), dirtySectors.end(), [](const CachedSector *a, const CachedSector *b) { return a->lba < b->lba; });
+
+    // Consecutive sectors are written with a single file access
+    bool success(true);
+    unsigned int runStart(0);
+
+    while (runStart < dirtySectors.size())
+    {
+        unsigned int runEnd(runStart + 1);
+
+        while (runEnd < dirtySectors.size() && dirtySectors[runEnd]->lba == dirtySectors[runEnd - 1]->lba + 1)
+            runEnd++;
+
+        QByteArray run;
+        run.reserve((runEnd - runStart) * SECTOR_SIZE);
+
+        for (unsigned int i(runStart); i < runEnd; i++)
+        {
+            run.append(reinterpret_cast<const char*>(dirtySectors[i]->data.data()), SECTOR_SIZE);
+        }
+
+        if (m_image.seek((qint64)dirtySectors[runStart]->lba * SECTOR_SIZE) && m_image.write(run) == run.size())
+        {
+            for (unsigned int i(runStart); i < runEnd; i++)
+            {
+                dirtySectors[i]->dirty = false;
+            }
+        }
+        else
+        {
+            success = false;
+        }
+
+        runStart = runEnd;
+    }
+
+    if (!m_image.flush() || !success)
+    {
+        m_consoleOutput->log("Unable to write to the storage image");
+        return false;
+    }
+
+    return true;
+}
+
+CachedSector* HbcStorage::getSector(Dword lba)
+{
+    auto cacheEntry = m_cacheIndex.find(lba);
+
+    if (cacheEntry != m_cacheIndex.end())
+    {
+        m_cache.splice(m_cache.begin(), m_cache, cacheEntry->second); // Most recently used
+        return &m_cache.front();
+    }
+
+    // Cache miss: the following sectors are read at the same time
+    Dword readCount = std::min<Dword>(READ_AHEAD_SECTORS_NB, m_sectorsNb - lba);
+
+    if (!m_image.seek((qint64)lba * SECTOR_SIZE))
+        return nullptr;
+
+    QByteArray data = m_image.read((qint64)readCount * SECTOR_SIZE);
+    readCount = data.size() / SECTOR_SIZE;
+
+    if (readCount == 0)
+        return nullptr;
+
+    // Inserted backwards so the requested sector is the most recently used
+    for (Dword i(readCount - 1); i > 0; i--)
+    {
+        if (m_cacheIndex.find(lba + i) == m_cacheIndex.end())
+        {
+            CachedSector *sector = insertSector(lba + i);
+            std::memcpy(sector->data.data(), data.constData() + i * SECTOR_SIZE, SECTOR_SIZE);
+        }
+    }
+
+    CachedSector *sector = insertSector(lba);
+    std::memcpy(sector->data.data(), data.constData(), SECTOR_SIZE);
+
+    return sector;
+}
+
+CachedSector* HbcStorage::insertSector(Dword lba)
+{
+    if (m_cache.size() >= CACHE_SECTORS_NB)
+    {
+        CachedSector &leastRecentlyUsed = m_cache.back();
+
+        if (leastRecentlyUsed.dirty && !writeBack(leastRecentlyUsed))
+        {
+            m_consoleOutput->log("Unable to write to the storage image, sector " + QString::number(leastRecentlyUsed.lba) + " lost");
+        }
+
+        m_cacheIndex.erase(leastRecentlyUsed.lba);
+        m_cache.pop_back();
+    }
+
+    m_cache.emplace_front();
+    m_cache.front().lba = lba;
+    m_cache.front().dirty = false;
+    m_cacheIndex[lba] = m_cache.begin();
+
+    return &m_cache.front();
+}
+
+bool HbcStorage::writeBack(const CachedSector &sector)
+{
+    if (!m_image.seek((qint64)sector.lba * SECTOR_SIZE))
+        return false;
+
+    return m_image.write(reinterpret_cast<const char*>(sector.data.data()), SECTOR_SIZE) == SECTOR_SIZE;
+}
@@ -0,0 +1,196 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+/*!
+ * \file storage.h
+ * \brief Block storage device derived from HbcPeripheral
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <list>
+#include <unordered_map>
+#include <array>
+#include <QFile>
+#include "peripheral.h"
+#include "ram.h"
+
+/*!
+ * \namespace Storage
+ * \brief See HbcStorage for detailed specifications.
+ */
+namespace Storage
+{
+    constexpr Byte DEVICE_ID = 0x5D; //!< Random to "look" nice
+
+    constexpr int SECTOR_SIZE = 512; //!< In bytes
+    constexpr int CACHE_SECTORS_NB = 256; //!< 128 KiB of cached sectors
+    constexpr int READ_AHEAD_SECTORS_NB = 16; //!< Sectors read from the image file on a cache miss
+
+    const QString IMAGE_FILE_NAME = "storage.img"; //!< Image file, in the project directory
+
+    constexpr int PORTS_NB = 8;
+    enum class Port { STATUS = 0, CMD = 1, LBA_0 = 2, LBA_1 = 3, LBA_2 = 4, ADDR_0 = 5, ADDR_1 = 6, COUNT = 7 }; //!< Lists the ports used by the storage device
+    enum class Command { NOP = 0, READ = 1, WRITE = 2, FLUSH = 3 }; //!< Lists the commands used by the storage device
+    enum class Status { IDLE = 0, DONE = 1, ERROR = 2 }; //!< Lists the values of the STATUS port
+
+    /*!
+     * \struct CachedSector
+     * \brief Stores a sector of the image file in the cache
+     */
+    struct CachedSector
+    {
+        Dword lba;
+        bool dirty; //!< <b>true</b> if modified since it was read from or written to the image file
+        std::array<Byte, SECTOR_SIZE> data;
+    };
+
+    /*!
+     * \class HbcStorage
+     * \brief Derived from HbcPeripheral, represents a block storage device backed by an image file
+     *
+     * This class is responsible for emulating a storage device reading and writing <b>512-byte sectors</b> directly from/to HbcRam.
+     *
+     * <b>Device ID:</b> 0x5D
+     *
+     * The image file (Storage::IMAGE_FILE_NAME) must be located in the project directory, any path leading outside of it is refused.<br>
+     * Its size defines the number of available sectors (a partial sector at the end of the file is ignored).
+     *
+     * On the host side, sectors are kept in a LRU cache of CACHE_SECTORS_NB sectors:
+     * - a missing sector is read with the READ_AHEAD_SECTORS_NB following ones,
+     * - written sectors are only written to the image file on FLUSH, when evicted from the cache, or when the device is reinitialized or destroyed.
+     *
+     * A command is executed entirely on the tick it is received, then:
+     * 1. the CMD port is set back to <b>NOP</b>,
+     * 2. the STATUS port is set to <b>DONE</b> (or <b>ERROR</b>),
+     * 3. an interrupt is triggered with the STATUS port as data.
+     *
+     * A transfer going past the end of the RAM or of the image is refused (<b>ERROR</b>) and nothing is transferred.
+     *
+     * <h2>Control</h2>
+     * Like every HbcPeripheral, HbcStorage uses sockets connecting it to HbcIod ports to communicate with HbcCpu.
+     *
+     * <table>
+     *  <caption>List of available ports</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Port</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>STATUS</td>
+     *   <td>Result of the last command (0: IDLE, 1: DONE, 2: ERROR)</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>CMD</td>
+     *   <td>Command sent by HbcCpu</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>LBA_0</td>
+     *   <td>Most significant byte of the 24-bit sector number</td>
+     *  </tr>
+     *  <tr>
+     *   <td>3</td>
+     *   <td>LBA_1</td>
+     *   <td>Middle byte of the 24-bit sector number</td>
+     *  </tr>
+     *  <tr>
+     *   <td>4</td>
+     *   <td>LBA_2</td>
+     *   <td>Least significant byte of the 24-bit sector number</td>
+     *  </tr>
+     *  <tr>
+     *   <td>5</td>
+     *   <td>ADDR_0</td>
+     *   <td>Most significant byte of the RAM address</td>
+     *  </tr>
+     *  <tr>
+     *   <td>6</td>
+     *   <td>ADDR_1</td>
+     *   <td>Least significant byte of the RAM address</td>
+     *  </tr>
+     *  <tr>
+     *   <td>7</td>
+     *   <td>COUNT</td>
+     *   <td>Number of sectors transferred</td>
+     *  </tr>
+     * </table>
+     *
+     * <table>
+     *  <caption>List of available commands</caption>
+     *  <tr>
+     *   <th>ID</th>
+     *   <th>Command</th>
+     *   <th>Description</th>
+     *  </tr>
+     *  <tr>
+     *   <td>0</td>
+     *   <td>NOP</td>
+     *   <td>No operation</td>
+     *  </tr>
+     *  <tr>
+     *   <td>1</td>
+     *   <td>READ</td>
+     *   <td>Copies COUNT sectors starting at LBA to the RAM at ADDR</td>
+     *  </tr>
+     *  <tr>
+     *   <td>2</td>
+     *   <td>WRITE</td>
+     *   <td>Copies COUNT sectors from the RAM at ADDR to the image starting at LBA</td>
+     *  </tr>
+     *  <tr>
+     *   <td>3</td>
+     *   <td>FLUSH</td>
+     *   <td>Writes the modified sectors to the image file</td>
+     *  </tr>
+     * </table>
+     *
+     * Any invalid command will result in <b>ERROR</b>.
+     */
+    class HbcStorage final : public HbcPeripheral
+    {
+        public:
+            /*!
+             * \param sandboxDirPath Directory the image file must be located in (the project directory)
+             * \param ram Pointer to HbcRam for the transfers
+             */
+            HbcStorage(QString sandboxDirPath, HbcRam *ram, HbcIod *iod, Console *consoleOutput);
+            ~HbcStorage();
+
+            void init() override;
+            void tick(bool step) override;
+
+            /*!
+             * \brief Writes the modified sectors to the image file, called by the emulator when it stops or closes
+             * \return <b>false</b> if a sector could not be written
+             */
+            bool flush();
+
+        private:
+            bool openImage(QString sandboxDirPath);
+
+            bool readSectors(Dword lba, Word address, int count);
+            bool writeSectors(Dword lba, Word address, int count);
+
+            /*!
+             * \brief Returns the cached sector, reading it (and the following ones) from the image file if needed
+             * \return <b>nullptr</b> if the sector could not be read
+             */
+            CachedSector* getSector(Dword lba);
+            CachedSector* insertSector(Dword lba); //!< Makes room in the cache (evicting the least recently used sector) and returns a new entry
+            bool writeBack(const CachedSector &sector);
+
+            QFile m_image;
+            Dword m_sectorsNb; //!< Number of sectors in the image file
+
+            std::list<CachedSector> m_cache; //!< Most recently used sector first
+            std::unordered_map<Dword, std::list<CachedSector>::iterator> m_cacheIndex; //!< Sector number to cache entry
+
+            HbcRam *m_ram;
+    };
+}
+
+#endif // STORAGE_H
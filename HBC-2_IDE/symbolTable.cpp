@@ -0,0 +1,61 @@
+#include "symbolTable.h"
+
+using namespace Assembly;
+
+// PUBLIC
+void SymbolTable::clear()
+{
+    m_ids.clear();
+    m_symbols.clear();
+}
+
+SymbolId SymbolTable::intern(const std::string &name)
+{
+    auto inserted = m_ids.emplace(name, (SymbolId)m_symbols.size());
+
+    if (inserted.second) // New name
+    {
+        Symbol symbol;
+        symbol.name = &(inserted.first->first);
+
+        for (int k(0); k < (int)SymbolKind::KINDS_NB; k++)
+            symbol.bindings[k] = NO_BINDING;
+
+        m_symbols.push_back(symbol);
+    }
+
+    return inserted.first->second;
+}
+
+SymbolId SymbolTable::find(const std::string &name) const
+{
+    auto it = m_ids.find(name);
+
+    return (it == m_ids.end()) ? NO_SYMBOL : it->second;
+}
+
+const std::string& SymbolTable::getName(SymbolId id) const
+{
+    return *(m_symbols[id].name);
+}
+
+void SymbolTable::bind(SymbolId id, SymbolKind kind, int index)
+{
+    m_symbols[id].bindings[(int)kind] = index;
+}
+
+int SymbolTable::getBinding(SymbolId id, SymbolKind kind) const
+{
+    if (id == NO_SYMBOL)
+        return NO_BINDING;
+
+    return m_symbols[id].bindings[(int)kind];
+}
+
+void SymbolTable::clearBindings(SymbolKind kind)
+{
+    for (unsigned int i(0); i < m_symbols.size(); i++)
+    {
+        m_symbols[i].bindings[(int)kind] = NO_BINDING;
+    }
+}
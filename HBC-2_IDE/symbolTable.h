@@ -0,0 +1,62 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+/*!
+ * \file symbolTable.h
+ * \brief Interned names of the defines, macros, variables and labels of an assembly
+ * \author Gianni Leclercq
+ * \version 0.1
+ * \date 19/10/2026
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Assembly
+{
+    using SymbolId = uint32_t;
+
+    constexpr SymbolId NO_SYMBOL = UINT32_MAX; //!< Returned for a name never interned
+    constexpr int NO_BINDING = -1; //!< Returned for a symbol not bound to an entity of the asked kind
+
+    /*!
+     * \enum SymbolKind
+     * \brief The same name can be bound to one entity of each kind
+     */
+    enum class SymbolKind { DEFINE, VARIABLE, ROUTINE, MACRO, KINDS_NB };
+
+    /*!
+     * \class SymbolTable
+     * \brief Gives each name a SymbolId, and binds it to indexes in the lists of the Assembler or the Linker
+     *
+     * Names are hashed once when interned, lookups then cost the same whatever the number of symbols.<br>
+     * Bindings are indexes in lists owned by the Assembler <i>(defines, defined variables, routine blocks, macros)</i>,
+     * they must be cleared with clearBindings() when a list is sorted.
+     */
+    class SymbolTable
+    {
+        public:
+            void clear();
+
+            SymbolId intern(const std::string &name); //!< Returns the existing ID of the name, or creates it
+            SymbolId find(const std::string &name) const; //!< Returns NO_SYMBOL if the name was never interned
+            const std::string& getName(SymbolId id) const;
+
+            void bind(SymbolId id, SymbolKind kind, int index);
+            int getBinding(SymbolId id, SymbolKind kind) const; //!< Returns NO_BINDING if <i>id</i> is NO_SYMBOL or is not bound
+            void clearBindings(SymbolKind kind);
+
+        private:
+            struct Symbol
+            {
+                const std::string *name; //!< Key of m_ids, which never moves
+                int bindings[(int)SymbolKind::KINDS_NB];
+            };
+
+            std::unordered_map<std::string, SymbolId> m_ids;
+            std::vector<Symbol> m_symbols; //!< Indexed by SymbolId
+    };
+}
+
+#endif // SYMBOLTABLE_H
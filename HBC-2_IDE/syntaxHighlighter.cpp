@@ -1,4 +1,5 @@
 #include "syntaxHighlighter.h"
+#include "computerDetails.h"
 
 // SYNTAX HIGHLIGHTER CLASS
 SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent)
@@ -10,152 +11,19 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter
     instrFormat.setForeground(QColor(128, 255, 0));
     rule.format = instrFormat;
 
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)nop(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)adc(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)add(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)and(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cal(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)clc(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cle(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cli(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cln(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cls(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)clz(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)clf(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)cmp(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)dec(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)hlt(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)in(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)out(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)inc(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)int(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)irt(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jmc(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jme(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jmn(?!\\S)"));
-    highlightingRules.append(rule);
+    // One alternation for every mnemonic of the CPU, instead of one expression per instruction
+    QStringList mnemonics;
 
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jmp(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jms(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jmz(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)jmf(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)str(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)lod(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)mov(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)not(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)or(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)pop(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)psh(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)ret(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)shl(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)asr(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)shr(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)stc(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)ste(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)sti(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)stn(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)sts(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)stz(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)stf(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)sub(?!\\S)"));
-    highlightingRules.append(rule);
-
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)sbb(?!\\S)"));
-    highlightingRules.append(rule);
+    for (unsigned int i(0); i < Cpu::INSTRUCTIONS_NB; i++)
+    {
+        mnemonics.append(QString::fromLatin1(Cpu::instrNames[i].data(), Cpu::instrNames[i].size()));
+    }
 
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)xor(?!\\S)"));
+    rule.pattern = QRegularExpression("(?<=\\s|^)(" + mnemonics.join("|") + ")(?!\\S)");
     highlightingRules.append(rule);
 
 
-    // Define & include
+    // Define, include and preprocessor directives
     defIncFormat.setForeground(QColor(255, 128, 255));
 
     rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)\\.include(?!\\S)"));
@@ -165,6 +33,9 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter
     rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)\\.define(?!\\S)"));
     highlightingRules.append(rule);
 
+    rule.pattern = QRegularExpression(QStringLiteral("(?<=\\s|^)\\.(macro|endm|if|ifdef|ifndef|else|endif)(?!\\S)"));
+    highlightingRules.append(rule);
+
 
     // Data
     dataFormat.setForeground(QColor(255, 128, 118));
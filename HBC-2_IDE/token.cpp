@@ -1,5 +1,8 @@
 #include "token.h"
 
+#include <charconv>
+#include "keywords.h"
+
 using namespace Token;
 
 // === TokenItem CLASS ===
@@ -51,6 +54,11 @@ Cpu::InstructionOpcode TokenItem::getInstructionOpcode()
     return m_instructionOpcode;
 }
 
+Token::Directive TokenItem::getDirective()
+{
+    return m_directive;
+}
+
 Cpu::Register TokenItem::getRegister()
 {
     return m_reg;
@@ -86,11 +94,35 @@ std::string TokenItem::getStr()
     return m_str;
 }
 
+std::string TokenItem::getSourceStr()
+{
+    if (m_type == Token::TokenType::STRING)
+        return "\"" + m_str + "\"";
+
+    return m_str;
+}
+
 Token::ErrorType TokenItem::getErr()
 {
     return m_err;
 }
 
+void TokenItem::setOrigin(unsigned int columnNb, unsigned int length)
+{
+    m_originColumnNb = columnNb;
+    m_originLength = length;
+}
+
+unsigned int TokenItem::getOriginColumnNb()
+{
+    return m_originColumnNb;
+}
+
+unsigned int TokenItem::getOriginLength()
+{
+    return m_originLength;
+}
+
 std::string TokenItem::print()
 {
     switch (m_type)
@@ -131,6 +163,12 @@ std::string TokenItem::print()
         case Token::TokenType::STRING:
             return "String \"" + m_str + "\"";
 
+        case Token::TokenType::DIRECTIVE:
+            return "Directive " + m_str;
+
+        case Token::TokenType::EXPRESSION:
+            return "Constant expression " + m_str;
+
         case Token::TokenType::INVALID:
             return "Invalid TokenItem";
 
@@ -141,51 +179,71 @@ std::string TokenItem::print()
 
 void TokenItem::determineType()
 {
-    size_t colonPos = m_str.find(':');
-
     if (m_str.empty())
+    {
         m_type = Token::TokenType::INVALID;
-    else
+        return;
+    }
+
+    Token::Keywords::Keyword keyword = Token::Keywords::find(m_str);
+
+    switch (keyword.type)
     {
-        if (m_str == ".define")
+        case Token::Keywords::KeywordType::DEFINE:
             m_type = Token::TokenType::DEFINE;
-        else if (m_str == ".include")
+            return;
+
+        case Token::Keywords::KeywordType::INCLUDE:
             m_type = Token::TokenType::INCLUDE;
-        else if (m_str == ".data")
+            return;
+
+        case Token::Keywords::KeywordType::DATA:
             m_type = Token::TokenType::DATA;
-        else if (colonPos != std::string::npos)
-        {
-            if (m_str.find(':', colonPos + 1) == std::string::npos)
-            {
-                m_type = Token::TokenType::LABEL;
-                m_labelName = m_str.substr(1);
-            }
-            else
-            {
-                m_type = Token::TokenType::INVALID;
-                m_err = Token::ErrorType::INVAL_LABEL;
-                return;
-            }
-        }
-        else if (identifyInstruction())
+            return;
+
+        case Token::Keywords::KeywordType::DIRECTIVE:
+            m_directive = (Token::Directive)keyword.id;
+            m_type = Token::TokenType::DIRECTIVE;
+            return;
+
+        case Token::Keywords::KeywordType::INSTRUCTION:
+            m_instructionOpcode = (Cpu::InstructionOpcode)keyword.id;
             m_type = Token::TokenType::INSTR;
-        else
-            analyseArgument();
+            return;
+
+        case Token::Keywords::KeywordType::REGISTER:
+            m_reg = (Cpu::Register)keyword.id;
+            m_type = Token::TokenType::REG;
+            return;
+
+        default:
+            break;
     }
-}
 
-bool TokenItem::identifyInstruction()
-{
-    for (unsigned int i(0); i < Cpu::INSTRUCTIONS_NB; i++)
+    // Computed by the preprocessor, the tokenizer keeps the parentheses and what is inside as one token
+    if (m_str.size() >= 2 && m_str[0] == '(' && m_str[m_str.size() - 1] == ')')
+    {
+        m_type = Token::TokenType::EXPRESSION;
+        return;
+    }
+
+    size_t colonPos = m_str.find(':');
+
+    if (colonPos != std::string::npos)
     {
-        if (m_str == Cpu::instrStrArr[i])
+        if (m_str.find(':', colonPos + 1) == std::string::npos)
+        {
+            m_type = Token::TokenType::LABEL;
+            m_labelName = m_str.substr(1);
+        }
+        else
         {
-            m_instructionOpcode = ( Cpu::InstructionOpcode)i;
-            return true;
+            m_type = Token::TokenType::INVALID;
+            m_err = Token::ErrorType::INVAL_LABEL;
         }
     }
-
-    return false;
+    else
+        analyseArgument();
 }
 
 void TokenItem::analyseArgument()
@@ -210,26 +268,16 @@ void TokenItem::analyseArgument()
         }
     }
 
-    if (is_validToken(m_str))
-    {
-        if (is_register(m_str)) // REG
-        {
-            for (unsigned int i(0); i < Cpu::REGISTERS_NB; i++)
-            {
-                if (m_str == Cpu::regStrArr[i])
-                {
-                    m_reg = (Cpu::Register)i;
-                    m_type = Token::TokenType::REG;
-                    return;
-                }
-            }
-        }
+    std::string_view str(m_str);
 
-        if (is_digits(m_str)) // DECVAL
+    // REG are classified by determineType()
+    if (is_validToken(str))
+    {
+        if (is_digits(str)) // DECVAL
         {
-            int value = std::stoi(m_str, nullptr, 10);
+            unsigned int value(0);
 
-            if (value < 256)
+            if (parseNumber(str, 10, value) && value < 256)
             {
                 m_value = value;
                 m_type = Token::TokenType::DECVAL;
@@ -275,7 +323,7 @@ void TokenItem::analyseArgument()
         {
             if (m_str[0] == '$')
             {
-                if (!is_address(m_str.substr(1)))
+                if (!is_address(str.substr(1)))
                 {
                     m_type = Token::TokenType::INVALID;
                     m_err = Token::ErrorType::INVAL_ADDR;
@@ -286,13 +334,13 @@ void TokenItem::analyseArgument()
 
         if (m_str.size() > 2)
         {
-            if (m_str.substr(0, 2) == "0x") // HEXVAL
+            if (str.substr(0, 2) == "0x") // HEXVAL
             {
-                if (is_hexDigits(m_str.substr(2)))
+                if (is_hexDigits(str.substr(2)))
                 {
-                    int value = std::stoi(m_str.substr(2), nullptr, 16);
+                    unsigned int value(0);
 
-                    if (value < 256)
+                    if (parseNumber(str.substr(2), 16, value) && value < 256)
                     {
                         m_value = value;
                         m_type = Token::TokenType::HEXVAL;
@@ -315,18 +363,19 @@ void TokenItem::analyseArgument()
 
         if (m_str.size() > 3)
         {
-            if (m_str.substr(0, 3) == "$0x")
+            if (str.substr(0, 3) == "$0x")
             {
-                if (is_hexDigits(m_str.substr(3)))
+                if (is_hexDigits(str.substr(3)))
                 {
-                    int value = std::stoi(m_str.substr(3), nullptr, 16);
+                    unsigned int value(0);
+                    bool parsed(parseNumber(str.substr(3), 16, value));
 
-                    if (value < 65536)
+                    if (parsed && value < 65536)
                     {
                         m_address = value;
                         m_type = Token::TokenType::ADDRESS;
                     }
-                    else if (value < 1048576)
+                    else if (parsed && value < 1048576)
                     {
                         m_address = value;
                         m_type = Token::TokenType::EEPROM_ADDRESS;
@@ -357,31 +406,14 @@ void TokenItem::analyseArgument()
                     {
                         if (m_str.size() == 4)
                         {
-                            int msReg(-1); // Most significant byte represented by register
-                            int lsReg(-1); // Least [...]
-
-                            for (unsigned int i(0); i < Cpu::REGISTERS_NB; i++)
-                            {
-                                if (m_str[1] == Cpu::regStrArr[i][0])
-                                {
-                                    msReg = i;
-                                    break;
-                                }
-                            }
+                            // Most and least significant bytes represented by registers
+                            Token::Keywords::Keyword msReg = Token::Keywords::find(str.substr(1, 1));
+                            Token::Keywords::Keyword lsReg = Token::Keywords::find(str.substr(2, 1));
 
-                            for (unsigned int i(0); i < Cpu::REGISTERS_NB; i++)
+                            if (msReg.type == Token::Keywords::KeywordType::REGISTER && lsReg.type == Token::Keywords::KeywordType::REGISTER)
                             {
-                                if (m_str[2] == Cpu::regStrArr[i][0])
-                                {
-                                    lsReg = i;
-                                    break;
-                                }
-                            }
-
-                            if (msReg != -1 && lsReg != -1)
-                            {
-                                m_concatReg.msReg = (Cpu::Register)msReg;
-                                m_concatReg.lsReg = (Cpu::Register)lsReg;
+                                m_concatReg.msReg = (Cpu::Register)msReg.id;
+                                m_concatReg.lsReg = (Cpu::Register)lsReg.id;
                                 m_type = Token::TokenType::CONCATREG;
                             }
                             else
@@ -420,12 +452,12 @@ void TokenItem::analyseArgument()
         {
             if (m_str.size() > 4)
             {
-                if (m_str.substr(m_str.size() - 4) == ".msb")
+                if (str.substr(str.size() - 4) == ".msb")
                 {
                     m_type = Token::TokenType::ADDR_MSB;
                     m_labelName = m_str.substr(0, m_str.size() - 4);
                 }
-                else if (m_str.substr(m_str.size() - 4) == ".lsb")
+                else if (str.substr(str.size() - 4) == ".lsb")
                 {
                     m_type = Token::TokenType::ADDR_LSB;
                     m_labelName = m_str.substr(0, m_str.size() - 4);
@@ -448,17 +480,17 @@ void TokenItem::analyseArgument()
     }
 }
 
-bool TokenItem::is_digits(const std::string& str)
+bool TokenItem::is_digits(std::string_view str)
 {
-    return str.find_first_not_of("0123456789") == std::string::npos;
+    return str.find_first_not_of("0123456789") == std::string_view::npos;
 }
 
-bool TokenItem::is_hexDigits(const std::string& str)
+bool TokenItem::is_hexDigits(std::string_view str)
 {
-    return str.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+    return str.find_first_not_of("0123456789abcdefABCDEF") == std::string_view::npos;
 }
 
-bool TokenItem::is_address(const std::string& str)
+bool TokenItem::is_address(std::string_view str)
 {
     if (str.size() < 3)
         return false;
@@ -466,17 +498,19 @@ bool TokenItem::is_address(const std::string& str)
     if (str.substr(0, 2) != "0x")
         return false;
 
-    return str.substr(2).find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+    return is_hexDigits(str.substr(2));
 }
 
-bool TokenItem::is_register(const std::string& str)
+bool TokenItem::is_validToken(std::string_view str)
 {
-    return str.find_first_not_of("abcdijxy") == std::string::npos;
+    return str.find_first_of("?,;:/!§*µù%^¨¤£&é~\"#'{(-|è`\\ç)=+}") == std::string_view::npos;
 }
 
-bool TokenItem::is_validToken(const std::string& str)
+bool TokenItem::parseNumber(std::string_view str, int base, unsigned int& value)
 {
-    return str.find_first_of("?,;:/!§*µù%^¨¤£&é~\"#'{(-|è`\\ç)=+}") == std::string::npos;
+    std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value, base);
+
+    return result.ec == std::errc() && result.ptr == str.data() + str.size();
 }
 
 
@@ -492,7 +526,7 @@ bool TokenLine::checkValidity(bool targetEeprom)
     // "define" and "include" macros are not checked because they are checked previously in assembler
 
     unsigned int argsNb = (unsigned int)m_tokens.size() - 1;
-    Token::TokenType arg1 = Token::TokenType::INVALID, arg2 = Token::TokenType::INVALID;
+    Token::TokenType arg2 = Token::TokenType::INVALID;
 
     if (m_tokens.empty())
     {
@@ -501,1063 +535,199 @@ bool TokenLine::checkValidity(bool targetEeprom)
     else if (m_tokens[0].getType() == Token::TokenType::INSTR)
     {
         m_instr.m_opcode = m_tokens[0].getInstructionOpcode();
+        m_instr.m_addrMode = Cpu::AddressingMode::NONE;
 
-        if (argsNb >= 1)
-        {
-            arg1 = m_tokens[1].getType();
+        const Cpu::Formats::OpcodeFormats &formats = Cpu::Formats::OPCODE_FORMATS[(int)m_instr.m_opcode];
+        int formatIndex(-1);
 
-            if (argsNb >= 2)
-                arg2 = m_tokens[2].getType();
+        if (argsNb != Cpu::Formats::getOperandsNb(m_instr.m_opcode))
+        {
+            m_err = Token::ErrorType::INSTR_ARG_NB;
         }
-
-        switch (m_instr.m_opcode)
+        else if ((formatIndex = findFormat(formats, false)) != -1)
         {
-        case  Cpu::InstructionOpcode::NOP:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+            m_instr.m_addrMode = Cpu::Formats::FORMATS[formatIndex].addrMode;
+        }
+        else if (findFormat(formats, true) != -1) // Valid with a RAM address
+        {
+            m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
+        }
+        else
+        {
+            m_err = Token::ErrorType::INSTR_ARG_INVAL;
+        }
+    }
+    else if (m_tokens[0].getType() == Token::TokenType::DATA)
+    {
+        // [VAR] [HEX | DEC]+
+        // [VAR] [STRING]
+        // [VAR] [ADDR | EEPROM_ADDR] [HEX | DEC]+
+        // [VAR] [ADDR | EEPROM_ADDR] [STRING]
 
-        case  Cpu::InstructionOpcode::ADC:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
+        if (argsNb < 2)
+        {
+            m_err = Token::ErrorType::DATA_ARG_NB;
+        }
+        else if (m_tokens[1].getType() != Token::TokenType::VAR)
+        {
+            m_err = Token::ErrorType::DATA_VAR_MISS;
+        }
+        else if (argsNb == 2) // [VAR] [STRING | HEX | DEC]
+        {
+            if (m_tokens[2].getType() != Token::TokenType::DECVAL && m_tokens[2].getType() != Token::TokenType::HEXVAL && arg2 != Token::TokenType::ADDR_MSB && arg2 != Token::TokenType::ADDR_LSB
+             && m_tokens[2].getType() != Token::TokenType::STRING)
             {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
+                m_err = Token::ErrorType::DATA_INVAL;
             }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
+            else if (m_tokens[2].getType() == Token::TokenType::STRING)
             {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
+                m_dataType = Token::DataType::STRING_UNDEFINED;
             }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
+            else
             {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
+                m_dataType = Token::DataType::SINGLE_VALUE_UNDEFINED;
             }
-            else
+        }
+        else
+        {
+            if (argsNb == 3)
             {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
+                if (m_tokens[2].getType() == Token::TokenType::ADDRESS || (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && targetEeprom))
                 {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
+                    if (m_tokens[3].getType() == Token::TokenType::STRING) // [VAR] [ADDR | EEPROM_ADDR] [STRING]
+                    {
+                        m_dataType = Token::DataType::STRING_DEFINED;
+                    }
+                    else if (m_tokens[3].getType() == Token::TokenType::DECVAL || m_tokens[3].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB) // [VAR] [ADDR | EEPROM_ADDR] [DEC | HEX]
+                    {
+                        m_dataType = Token::DataType::SINGLE_VALUE_DEFINED;
+                    }
+                    else
+                    {
+                        m_err = Token::ErrorType::DATA_INVAL;
+                    }
                 }
-                else
+                else if ((m_tokens[2].getType() == Token::TokenType::DECVAL || m_tokens[2].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
+                      && (m_tokens[3].getType() == Token::TokenType::DECVAL || m_tokens[3].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB))
                 {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
+                    m_dataType = Token::DataType::MULTIPLE_VALUES_UNDEFINED;
                 }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::ADD:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
+                else if (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && !targetEeprom)
                 {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
+                    m_err = Token::ErrorType::INVAL_EEPROM_ADDR_TOO_HIGH;
                 }
                 else
                 {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
+                    m_err = Token::ErrorType::DATA_INVAL;
                 }
             }
-            break;
-
-        case  Cpu::InstructionOpcode::AND:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
             else
             {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
+                if (m_tokens[2].getType() == Token::TokenType::ADDRESS || (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && targetEeprom)) // [VAR] [ADDR | EEPROM_ADDR] [DEC | HEX]+
                 {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
+                    for (unsigned int i(3); i < m_tokens.size(); i++)
+                    {
+                        if (m_tokens[i].getType() != Token::TokenType::DECVAL && m_tokens[i].getType() != Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
+                        {
+                            m_err = Token::ErrorType::DATA_INVAL;
+                        }
+                    }
+
+                    m_dataType = Token::DataType::MULTIPLE_VALUES_DEFINED;
                 }
-                else
+                else // [VAR] [DEC | HEX]+
                 {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
+                    for (unsigned int i(2); i < m_tokens.size(); i++)
+                    {
+                        if (m_tokens[i].getType() != Token::TokenType::DECVAL && m_tokens[i].getType() != Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
+                        {
+                            m_err = Token::ErrorType::DATA_INVAL;
+                        }
+                    }
 
-        case  Cpu::InstructionOpcode::CAL:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
+                    m_dataType = Token::DataType::MULTIPLE_VALUES_UNDEFINED;
+                }
             }
-            else if (arg1 == Token::TokenType::CONCATREG)
+        }
+    }
+    else if (m_tokens[0].getType() == Token::TokenType::LABEL)
+    {
+        if (argsNb > 2)
+        {
+            m_err = Token::ErrorType::LABEL_ARG_NB;
+        }
+        else if (argsNb == 1) // [ADDR | EEPROM_ADDR]
+        {
+            if (m_tokens[1].getType() == Token::TokenType::EEPROM_ADDRESS && !targetEeprom)
             {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
+                m_err = Token::ErrorType::INVAL_EEPROM_ADDR_TOO_HIGH;
             }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
+            else if (m_tokens[1].getType() != Token::TokenType::ADDRESS)
             {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
+                m_err = Token::ErrorType::LABEL_INVAL_ARG;
             }
-            else
+            else if (m_tokens[0].getLabelName() == "_start")
             {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
+                m_err = Token::ErrorType::LABEL_START_REDEFINED;
             }
-            break;
+        }
+    }
+    else
+    {
+        m_err = Token::ErrorType::INVAL_EXPR;
+    }
 
-        case  Cpu::InstructionOpcode::CLC:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+    return m_err == Token::ErrorType::NONE;
+}
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+int TokenLine::findFormat(const Cpu::Formats::OpcodeFormats& formats, bool eepromAddresses)
+{
+    for (unsigned int f(formats.first); f < formats.first + formats.count; f++)
+    {
+        const Cpu::Formats::Format &format = Cpu::Formats::FORMATS[f];
+        bool match(true);
 
-        case  Cpu::InstructionOpcode::CLE:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+        for (unsigned int i(0); i < format.getOperandsNb() && match; i++)
+        {
+            Token::TokenType type = m_tokens[i + 1].getType();
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+            match = isOperandAccepted(format.operands[i].type, type);
 
-        case  Cpu::InstructionOpcode::CLI:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+            if (!match && eepromAddresses && type == Token::TokenType::EEPROM_ADDRESS)
+                match = format.operands[i].type == Cpu::Formats::OperandType::DATA16 || format.operands[i].type == Cpu::Formats::OperandType::CODE16;
+        }
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+        if (match)
+            return f;
+    }
 
-        case  Cpu::InstructionOpcode::CLN:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+    return -1;
+}
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+bool TokenLine::isOperandAccepted(Cpu::Formats::OperandType operandType, Token::TokenType tokenType)
+{
+    switch (operandType)
+    {
+        case Cpu::Formats::OperandType::REG:
+            return tokenType == Token::TokenType::REG;
 
-        case  Cpu::InstructionOpcode::CLS:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+        case Cpu::Formats::OperandType::REG16:
+            return tokenType == Token::TokenType::CONCATREG;
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+        case Cpu::Formats::OperandType::IMM8:
+            return tokenType == Token::TokenType::HEXVAL || tokenType == Token::TokenType::DECVAL
+                || tokenType == Token::TokenType::ADDR_MSB || tokenType == Token::TokenType::ADDR_LSB;
 
-        case  Cpu::InstructionOpcode::CLZ:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
+        case Cpu::Formats::OperandType::PORT8:
+            return tokenType == Token::TokenType::HEXVAL || tokenType == Token::TokenType::DECVAL;
 
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
+        case Cpu::Formats::OperandType::DATA16:
+        case Cpu::Formats::OperandType::CODE16:
+            return tokenType == Token::TokenType::ADDRESS || tokenType == Token::TokenType::VAR;
 
-        case  Cpu::InstructionOpcode::CLF:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::CMP:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::RAMREG_IMMREG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::DEC:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::HLT:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::IN:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG && arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::OUT:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG && arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::INC:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::INT:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::DECVAL || arg1 == Token::TokenType::HEXVAL)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM8;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::IRT:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::JMC:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JME:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JMN:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JMP:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JMS:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JMZ:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::JMF:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG16;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::STR:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg2 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg1 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::RAMREG_IMMREG;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::LOD:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::CONCATREG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::RAMREG_IMMREG;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::MOV:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::NOT:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg1 == Token::TokenType::ADDRESS || arg1 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::IMM16;
-            }
-            else
-            {
-                if (arg1 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::OR:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::POP:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::PSH:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::RET:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::SHL:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::ASR:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::SHR:
-            if (argsNb != 1)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::STC:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STE:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STI:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STN:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STS:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STZ:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::STF:
-            if (argsNb > 0)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-
-            m_instr.m_addrMode = Cpu::AddressingMode::NONE;
-            break;
-
-        case  Cpu::InstructionOpcode::SUB:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::SBB:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-
-        case  Cpu::InstructionOpcode::XOR:
-            if (argsNb != 2)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_NB;
-            }
-            else if (arg1 != Token::TokenType::REG)
-            {
-                m_err = Token::ErrorType::INSTR_ARG_INVAL;
-            }
-            else if (arg2 == Token::TokenType::REG)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG;
-            }
-            else if (arg2 == Token::TokenType::HEXVAL || arg2 == Token::TokenType::DECVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_IMM8;
-            }
-            else if (arg2 == Token::TokenType::ADDRESS || arg2 == Token::TokenType::VAR)
-            {
-                m_instr.m_addrMode = Cpu::AddressingMode::REG_RAM;
-            }
-            else
-            {
-                if (arg2 == Token::TokenType::EEPROM_ADDRESS)
-                {
-                    m_err = Token::ErrorType::INVAL_RAM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::INSTR_ARG_INVAL;
-                }
-            }
-            break;
-        }
-    }
-    else if (m_tokens[0].getType() == Token::TokenType::DATA)
-    {
-        // [VAR] [HEX | DEC]+
-        // [VAR] [STRING]
-        // [VAR] [ADDR | EEPROM_ADDR] [HEX | DEC]+
-        // [VAR] [ADDR | EEPROM_ADDR] [STRING]
-
-        if (argsNb < 2)
-        {
-            m_err = Token::ErrorType::DATA_ARG_NB;
-        }
-        else if (m_tokens[1].getType() != Token::TokenType::VAR)
-        {
-            m_err = Token::ErrorType::DATA_VAR_MISS;
-        }
-        else if (argsNb == 2) // [VAR] [STRING | HEX | DEC]
-        {
-            if (m_tokens[2].getType() != Token::TokenType::DECVAL && m_tokens[2].getType() != Token::TokenType::HEXVAL && arg2 != Token::TokenType::ADDR_MSB && arg2 != Token::TokenType::ADDR_LSB
-             && m_tokens[2].getType() != Token::TokenType::STRING)
-            {
-                m_err = Token::ErrorType::DATA_INVAL;
-            }
-            else if (m_tokens[2].getType() == Token::TokenType::STRING)
-            {
-                m_dataType = Token::DataType::STRING_UNDEFINED;
-            }
-            else
-            {
-                m_dataType = Token::DataType::SINGLE_VALUE_UNDEFINED;
-            }
-        }
-        else
-        {
-            if (argsNb == 3)
-            {
-                if (m_tokens[2].getType() == Token::TokenType::ADDRESS || (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && targetEeprom))
-                {
-                    if (m_tokens[3].getType() == Token::TokenType::STRING) // [VAR] [ADDR | EEPROM_ADDR] [STRING]
-                    {
-                        m_dataType = Token::DataType::STRING_DEFINED;
-                    }
-                    else if (m_tokens[3].getType() == Token::TokenType::DECVAL || m_tokens[3].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB) // [VAR] [ADDR | EEPROM_ADDR] [DEC | HEX]
-                    {
-                        m_dataType = Token::DataType::SINGLE_VALUE_DEFINED;
-                    }
-                    else
-                    {
-                        m_err = Token::ErrorType::DATA_INVAL;
-                    }
-                }
-                else if ((m_tokens[2].getType() == Token::TokenType::DECVAL || m_tokens[2].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-                      && (m_tokens[3].getType() == Token::TokenType::DECVAL || m_tokens[3].getType() == Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB))
-                {
-                    m_dataType = Token::DataType::MULTIPLE_VALUES_UNDEFINED;
-                }
-                else if (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && !targetEeprom)
-                {
-                    m_err = Token::ErrorType::INVAL_EEPROM_ADDR_TOO_HIGH;
-                }
-                else
-                {
-                    m_err = Token::ErrorType::DATA_INVAL;
-                }
-            }
-            else
-            {
-                if (m_tokens[2].getType() == Token::TokenType::ADDRESS || (m_tokens[2].getType() == Token::TokenType::EEPROM_ADDRESS && targetEeprom)) // [VAR] [ADDR | EEPROM_ADDR] [DEC | HEX]+
-                {
-                    for (unsigned int i(3); i < m_tokens.size(); i++)
-                    {
-                        if (m_tokens[i].getType() != Token::TokenType::DECVAL && m_tokens[i].getType() != Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-                        {
-                            m_err = Token::ErrorType::DATA_INVAL;
-                        }
-                    }
-
-                    m_dataType = Token::DataType::MULTIPLE_VALUES_DEFINED;
-                }
-                else // [VAR] [DEC | HEX]+
-                {
-                    for (unsigned int i(2); i < m_tokens.size(); i++)
-                    {
-                        if (m_tokens[i].getType() != Token::TokenType::DECVAL && m_tokens[i].getType() != Token::TokenType::HEXVAL || arg2 == Token::TokenType::ADDR_MSB || arg2 == Token::TokenType::ADDR_LSB)
-                        {
-                            m_err = Token::ErrorType::DATA_INVAL;
-                        }
-                    }
-
-                    m_dataType = Token::DataType::MULTIPLE_VALUES_UNDEFINED;
-                }
-            }
-        }
-    }
-    else if (m_tokens[0].getType() == Token::TokenType::LABEL)
-    {
-        if (argsNb > 2)
-        {
-            m_err = Token::ErrorType::LABEL_ARG_NB;
-        }
-        else if (argsNb == 1) // [ADDR | EEPROM_ADDR]
-        {
-            if (m_tokens[1].getType() == Token::TokenType::EEPROM_ADDRESS && !targetEeprom)
-            {
-                m_err = Token::ErrorType::INVAL_EEPROM_ADDR_TOO_HIGH;
-            }
-            else if (m_tokens[1].getType() != Token::TokenType::ADDRESS)
-            {
-                m_err = Token::ErrorType::LABEL_INVAL_ARG;
-            }
-            else if (m_tokens[0].getLabelName() == "_start")
-            {
-                m_err = Token::ErrorType::LABEL_START_REDEFINED;
-            }
-        }
-    }
-    else
-    {
-        m_err = Token::ErrorType::INVAL_EXPR;
+        default:
+            return false;
     }
-
-    return m_err == Token::ErrorType::NONE;
 }
 
 Token::Instruction TokenLine::getInstruction()
@@ -8,9 +8,11 @@
  * \version 0.1
  * \date 27/08/2023
  */
+#include <string_view>
 #include <QString>
 #include <QDebug>
 #include "computerDetails.h"
+#include "instructionFormats.h"
 
 /*!
  * \namespace Token
@@ -22,7 +24,14 @@ namespace Token
      * \enum TokenType
      * \brief Lists token types
      */
-    enum class TokenType { INSTR, DEFINE, INCLUDE, DATA, LABEL, VAR, DECVAL, HEXVAL, ADDRESS, ADDR_MSB, ADDR_LSB, EEPROM_ADDRESS, REG, CONCATREG, STRING, INVALID };
+    enum class TokenType { INSTR, DEFINE, INCLUDE, DATA, LABEL, VAR, DECVAL, HEXVAL, ADDRESS, ADDR_MSB, ADDR_LSB, EEPROM_ADDRESS, REG, CONCATREG, STRING,
+                          DIRECTIVE, EXPRESSION, INVALID };
+
+    /*!
+     * \enum Directive
+     * \brief Lists the preprocessor directives, in the order of Token::Keywords::DIRECTIVES
+     */
+    enum class Directive { MACRO, END_MACRO, IF, IFDEF, IFNDEF, ELSE, END_IF, NONE };
 
     /*!
      * \enum DataType
@@ -62,7 +71,10 @@ namespace Token
                            DATA_INVAL, INSTR_ARG_INVAL, INSTR_ARG_NB, MEM_SIZE, MEM_USE, INSTR_ALONE, LABEL_ALREADY_USED,
                            START_ROUTINE_MISSING, LABEL_START_REDEFINED, DATA_OVERWRITES_INSTR, MEM_USE_DEF_ROUTINES,
                            DATA_MEM_USE, SPLIT_MEM, LABEL_MEM_USE, DATA_OVERLAP, ROUTINE_OVERLAP, UNKNOWN_VARIABLE,
-                           BIN_FILE_OPEN, MEM_SIZE_RAM, UNDEFINED_ADDRESS_EEPROM };
+                           BIN_FILE_OPEN, MEM_SIZE_RAM, UNDEFINED_ADDRESS_EEPROM, MACRO_INVAL, MACRO_END_MISSING,
+                           MACRO_NESTED, MACRO_ALREADY_EXIST, MACRO_ARG_NB, MACRO_RECURSION, COND_UNBALANCED, COND_ARG_INVAL,
+                           DEF_IN_BLOCK, CONST_EXPR_INVAL, CONST_EXPR_RANGE, CONST_EXPR_UNKNOWN,
+                           OBJECT_TARGET };
 
     const std::string errStr[] = { "No error", "Circular dependency on file ", "Invalid expression or string",
                                    "Missing '\"' termination character", "Expected expression",
@@ -91,7 +103,17 @@ namespace Token
                                    "Routine exceeds memory size", "Data definition overlaps \"", "Routine overlaps \"",
                                    "Unknown variable or label", "Unable to write the binary file (",
                                    "Program size too large for the RAM, try targeting the EEPROM or unplugging it (",
-                                   "Using variables with undefined addresses is prohibited with EEPROM" }; //!< More info in the assembly language documentation
+                                   "Using variables with undefined addresses is prohibited with EEPROM",
+                                   "Invalid macro definition (.macro name [parameters])", "Missing \".endm\" at the end of the macro",
+                                   "Macros cannot be defined inside a macro or a conditional block",
+                                   "Macro name already used in file ", "Too many or too few arguments for macro ",
+                                   "Too many nested macro expansions, check for a recursive use of macro ",
+                                   "Unbalanced conditional block (.if, .ifdef, .ifndef, .else, .endif)",
+                                   "Invalid argument(s) for that conditional directive",
+                                   "Defines cannot be declared inside a macro or a conditional block",
+                                   "Invalid constant expression", "Constant expression value out of range: ",
+                                   "Unknown define in constant expression: ",
+                                   "Object assembled for the other memory target \"" }; //!< More info in the assembly language documentation
 
     /*!
      * \class TokenItem
@@ -142,6 +164,11 @@ namespace Token
              */
             Cpu::InstructionOpcode getInstructionOpcode();
 
+            /*!
+             * \brief Returns the directive associated with the token <i>(NONE if none)</i>.
+             */
+            Token::Directive getDirective();
+
             /*!
              * \brief Returns the register ID associated with the token <i>(A if none)</i>.
              */
@@ -177,11 +204,34 @@ namespace Token
              */
             std::string getStr();
 
+            /*!
+             * \brief Returns the string as written in the code <i>(quotes of a string included)</i>.
+             */
+            std::string getSourceStr();
+
             /*!
              * \brief Returns the error type stored in the token.
              */
             Token::ErrorType getErr();
 
+            /*!
+             * \brief Sets the characters of the source line the token comes from.
+             *
+             * \param columnNb Column of the first character (starting at 1, a tab counts as 1 character)
+             * \param length Number of characters of the source line, spaces and tabs of a string included
+             */
+            void setOrigin(unsigned int columnNb, unsigned int length);
+
+            /*!
+             * \brief Returns the column of the first character of the token in its source line <i>(0 if unknown)</i>.
+             */
+            unsigned int getOriginColumnNb();
+
+            /*!
+             * \brief Returns the number of characters of the token in its source line.
+             */
+            unsigned int getOriginLength();
+
             /*!
              * \brief Returns a string suited for console output.
              */
@@ -190,19 +240,19 @@ namespace Token
         private:
             // Methods
             void determineType();
-            bool identifyInstruction();
             void analyseArgument();
 
-            bool is_digits(const std::string& str);
-            bool is_hexDigits(const std::string& str);
-            bool is_address(const std::string& str);
-            bool is_register(const std::string& str);
-            bool is_validToken(const std::string& str);
+            bool is_digits(std::string_view str);
+            bool is_hexDigits(std::string_view str);
+            bool is_address(std::string_view str);
+            bool is_validToken(std::string_view str);
+            bool parseNumber(std::string_view str, int base, unsigned int& value); //!< <b>false</b> if not a number or out of range
 
             // Attributes
             Token::TokenType m_type;
 
             Cpu::InstructionOpcode m_instructionOpcode = Cpu::InstructionOpcode::NOP;
+            Token::Directive m_directive = Token::Directive::NONE;
             Cpu::Register m_reg = Cpu::Register::A;
             Token::ConcatReg m_concatReg;
             uint8_t m_value = 0x00;
@@ -211,6 +261,9 @@ namespace Token
 
             std::string m_str;
             Token::ErrorType m_err;
+
+            unsigned int m_originColumnNb = 0;
+            unsigned int m_originLength = 0;
     };
 
     /*!
@@ -229,6 +282,8 @@ namespace Token
 
             /*!
              * \brief Returns true if the line is valid (validity of arguments by keyword).
+             *
+             * The addressing mode of an instruction is the one of its first format matching the arguments (see Cpu::Formats).
              */
             bool checkValidity(bool targetEeprom);
 
@@ -277,6 +332,14 @@ namespace Token
 
             Token::ErrorType m_err;
             std::string m_additionalInfo; //!< Used to display more information after an error in the console output
+
+        private:
+            /*!
+             * \brief Returns the index in Cpu::Formats::FORMATS of the first format accepting the arguments, or -1
+             * \param eepromAddresses Also accepts EEPROM addresses for address operands
+             */
+            int findFormat(const Cpu::Formats::OpcodeFormats& formats, bool eepromAddresses);
+            static bool isOperandAccepted(Cpu::Formats::OperandType operandType, Token::TokenType tokenType);
     };
 
     /*!
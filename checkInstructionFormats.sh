@@ -0,0 +1,110 @@
+#!/bin/bash
+# Compares the instruction validation and encoding of two revisions of the assembler.
+# Every opcode is checked with 0 to 3 arguments taken from a sample of every token type,
+# for both memory targets. The validity, error, addressing mode and binary of each line must match.
+#
+# Usage: ./checkInstructionFormats.sh [legacy revision] [new revision]
+# QT_CFLAGS can be set to the include flags of QtCore (pkg-config Qt6Core by default)
+
+legacyRev=${1:-e0ad2cf^}
+newRev=${2:-e0ad2cf}
+
+qtFlags=${QT_CFLAGS:-$(pkg-config --cflags Qt6Core 2>/dev/null)}
+workDir=$(mktemp -d)
+trap 'rm -rf "$workDir"' EXIT
+
+cat > "$workDir/harness.cpp" << 'EOF'
+#include <cstdio>
+#include <vector>
+#include "token.h"
+
+uint32_t getBinaryFromTokenLine(Token::TokenLine* line);
+
+int main()
+{
+    const std::vector<std::string> samples = { "a", "b", "y", "[ab]", "[xj]", "[a]", "12", "255", "0x3F",
+                                               "$0x1234", "$0x12345", "var", "lbl.msb", "lbl.lsb",
+                                               "\"str\"", ":lbl", "%", "add", ".data" };
+    const size_t samplesNb = samples.size();
+
+    for (const std::string_view &name : Cpu::instrNames)
+    {
+        for (unsigned int argsNb(0); argsNb <= 3; argsNb++)
+        {
+            size_t combinationsNb(1);
+
+            for (unsigned int i(0); i < argsNb; i++)
+                combinationsNb *= samplesNb;
+
+            for (size_t c(0); c < combinationsNb; c++)
+            {
+                for (bool targetEeprom : { false, true })
+                {
+                    Token::TokenLine line;
+                    std::string str(name);
+                    size_t rest(c);
+
+                    line.m_tokens.push_back(Token::TokenItem(std::string(name)));
+
+                    for (unsigned int i(0); i < argsNb; i++)
+                    {
+                        line.m_tokens.push_back(Token::TokenItem(samples[rest % samplesNb]));
+                        str += " " + samples[rest % samplesNb];
+                        rest /= samplesNb;
+                    }
+
+                    bool valid = line.checkValidity(targetEeprom);
+                    uint32_t binary(0);
+
+                    if (valid)
+                    {
+                        for (Token::TokenItem &token : line.m_tokens) // Symbols resolved as the assembler does
+                        {
+                            if (token.getType() == Token::TokenType::VAR)
+                                token.setAsAddress(0xBEEF);
+                            else if (token.getType() == Token::TokenType::ADDR_MSB)
+                                token.setAsValue(0xBE);
+                            else if (token.getType() == Token::TokenType::ADDR_LSB)
+                                token.setAsValue(0xEF);
+                        }
+
+                        binary = getBinaryFromTokenLine(&line);
+                    }
+
+                    std::printf("%s|%d|%d|%d|%d|%08X\n", str.c_str(), targetEeprom, valid, (int)line.m_err,
+                                valid ? (int)line.m_instr.m_addrMode : -1, binary);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+EOF
+
+for rev in "$legacyRev" "$newRev"
+do
+    revDir="$workDir/$(git rev-parse --short "$rev")"
+    mkdir -p "$revDir"
+    git archive "$rev" HBC-2_IDE | tar -x -C "$revDir" || exit 1
+
+    # Assembler::getBinaryFromTokenLine() as a free function, the rest of the assembler needs the GUI
+    awk '/^uint32_t Assembler::getBinaryFromTokenLine/ { found = 1; sub("Assembler::", "") } found { print } found && /^}/ { exit }' \
+        "$revDir/HBC-2_IDE/assembler.cpp" > "$revDir/encoder.cpp"
+    sed -i '1i #include "token.h"' "$revDir/encoder.cpp"
+
+    g++ -std=c++17 -O1 $qtFlags -I"$revDir/HBC-2_IDE" "$workDir/harness.cpp" "$revDir/encoder.cpp" \
+        "$revDir/HBC-2_IDE/token.cpp" -o "$revDir/harness" || exit 1
+
+    "$revDir/harness" > "$revDir/results.txt"
+    echo "$rev: $(wc -l < "$revDir/results.txt") lines, $(grep -c '|1|[0-9]*|[0-9]*|[0-9A-F]*$' "$revDir/results.txt") valid"
+done
+
+if diff "$workDir/$(git rev-parse --short "$legacyRev")/results.txt" "$workDir/$(git rev-parse --short "$newRev")/results.txt" > "$workDir/diff.txt"
+then
+    echo "Identical results"
+else
+    echo "Different results:"
+    head -40 "$workDir/diff.txt"
+    exit 1
+fi